@@ -25,6 +25,7 @@ public class GenericItemization : ModuleRules
 			"StructUtils",
 			"GameplayTags",
             "NetCore",
+            "DeveloperSettings",
         });
 
         PrivateDependencyModuleNames.AddRange(
@@ -34,6 +35,9 @@ public class GenericItemization : ModuleRules
 			"Engine",
 			"Slate",
 			"SlateCore",
+			"AssetRegistry",
 		});
+
+		SetupIrisSupport(Target);
 	}
 }
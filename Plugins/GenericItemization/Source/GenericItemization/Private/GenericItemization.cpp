@@ -1,17 +1,24 @@
 // Copyright Fissure Entertainment, Pty Ltd. All Rights Reserved.
 
 #include "GenericItemization.h"
+#include "GenericItemizationInstanceTypes.h"
+#include "UObject/UObjectGlobals.h"
 
 #define LOCTEXT_NAMESPACE "FGenericItemizationModule"
 
 void FGenericItemizationModule::StartupModule()
 {
-	
+	// Reloaded ItemInstance ScriptStructs may have different properties to the ones we resolved.
+	ReloadCompleteHandle = FCoreUObjectDelegates::ReloadCompleteDelegate.AddLambda([](EReloadCompleteReason)
+	{
+		FFastItemInstance::ResetPropertyCaches();
+	});
 }
 
 void FGenericItemizationModule::ShutdownModule()
 {
-	
+	FCoreUObjectDelegates::ReloadCompleteDelegate.Remove(ReloadCompleteHandle);
+	FFastItemInstance::ResetPropertyCaches();
 }
 
 #undef LOCTEXT_NAMESPACE
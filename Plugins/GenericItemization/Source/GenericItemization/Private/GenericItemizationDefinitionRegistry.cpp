@@ -0,0 +1,435 @@
+// Copyright Fissure Entertainment, Pty Ltd. All Rights Reserved.
+
+#include "GenericItemizationDefinitionRegistry.h"
+#include "GenericItemizationSettings.h"
+#include "GenericItemizationTableTypes.h"
+#include "ItemManagement/ItemSocketSettings.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "Engine/Engine.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogGenericItemizationRegistry, Log, All);
+
+UGenericItemizationDefinitionRegistry* UGenericItemizationDefinitionRegistry::Get()
+{
+	return GEngine ? GEngine->GetEngineSubsystem<UGenericItemizationDefinitionRegistry>() : nullptr;
+}
+
+void UGenericItemizationDefinitionRegistry::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	const UGenericItemizationSettings* const Settings = GetDefault<UGenericItemizationSettings>();
+	if (!Settings->bUseDefinitionRegistry)
+	{
+		return;
+	}
+
+	// Mismatched Registries are refused during the connection handshake, as the Ids would otherwise decode to the wrong definitions.
+	PreviousNetworkVersionOverride = FNetworkVersion::GetLocalNetworkVersionOverride;
+	FNetworkVersion::GetLocalNetworkVersionOverride.BindUObject(this, &UGenericItemizationDefinitionRegistry::GetLocalNetworkVersion);
+
+	// Auto discovery needs the Asset Registry to have finished its initial scan, which is only still running in the Editor.
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(AssetRegistryConstants::ModuleName).Get();
+	if (Settings->bAutoDiscoverDefinitionTables && AssetRegistry.IsLoadingAssets())
+	{
+		AssetRegistry.OnFilesLoaded().AddUObject(this, &UGenericItemizationDefinitionRegistry::OnAssetRegistryFilesLoaded);
+	}
+	else
+	{
+		Rebuild();
+	}
+}
+
+void UGenericItemizationDefinitionRegistry::OnAssetRegistryFilesLoaded()
+{
+	if (FAssetRegistryModule* AssetRegistryModule = FModuleManager::GetModulePtr<FAssetRegistryModule>(AssetRegistryConstants::ModuleName))
+	{
+		AssetRegistryModule->Get().OnFilesLoaded().RemoveAll(this);
+	}
+
+	Rebuild();
+}
+
+uint32 UGenericItemizationDefinitionRegistry::GetLocalNetworkVersion() const
+{
+	const uint32 NetworkVersion = PreviousNetworkVersionOverride.IsBound() ? PreviousNetworkVersionOverride.Execute() : FNetworkVersion::GetLocalNetworkVersion(false);
+	return HashCombine(NetworkVersion, Checksum);
+}
+
+void UGenericItemizationDefinitionRegistry::Deinitialize()
+{
+	if (FNetworkVersion::GetLocalNetworkVersionOverride.IsBoundToObject(this))
+	{
+		FNetworkVersion::GetLocalNetworkVersionOverride = PreviousNetworkVersionOverride;
+		FNetworkVersion::InvalidateNetworkChecksum();
+	}
+	PreviousNetworkVersionOverride.Unbind();
+
+	if (FAssetRegistryModule* AssetRegistryModule = FModuleManager::GetModulePtr<FAssetRegistryModule>(AssetRegistryConstants::ModuleName))
+	{
+		AssetRegistryModule->Get().OnFilesLoaded().RemoveAll(this);
+	}
+
+#if WITH_EDITOR
+	for (UDataTable* Table : RegisteredTables)
+	{
+		if (Table)
+		{
+			Table->OnDataTableChanged().RemoveAll(this);
+		}
+	}
+#endif
+
+	RegisteredTables.Empty();
+	ItemDefinitions.Empty();
+	AffixDefinitions.Empty();
+	SocketDefinitions.Empty();
+	ItemDefinitionIds.Empty();
+	AffixDefinitionIds.Empty();
+	SocketDefinitionIds.Empty();
+
+	Super::Deinitialize();
+}
+
+void UGenericItemizationDefinitionRegistry::Rebuild()
+{
+#if WITH_EDITOR
+	for (UDataTable* Table : RegisteredTables)
+	{
+		if (Table)
+		{
+			Table->OnDataTableChanged().RemoveAll(this);
+		}
+	}
+#endif
+
+	RegisteredTables.Reset();
+	ItemDefinitions.Reset();
+	AffixDefinitions.Reset();
+	SocketDefinitions.Reset();
+	ItemDefinitionIds.Reset();
+	AffixDefinitionIds.Reset();
+	SocketDefinitionIds.Reset();
+	Checksum = 0;
+
+	const UGenericItemizationSettings* const Settings = GetDefault<UGenericItemizationSettings>();
+
+	TArray<UDataTable*> ItemDefinitionTables;
+	GatherDefinitionTables(Settings->ItemDefinitionTables, FItemDefinitionEntry::StaticStruct(), Settings->bAutoDiscoverDefinitionTables, ItemDefinitionTables);
+
+	TArray<UDataTable*> AffixDefinitionTables;
+	GatherDefinitionTables(Settings->AffixDefinitionTables, FAffixDefinitionEntry::StaticStruct(), Settings->bAutoDiscoverDefinitionTables, AffixDefinitionTables);
+
+	for (UDataTable* Table : ItemDefinitionTables)
+	{
+		RegisteredTables.Add(Table);
+		Checksum = HashCombine(Checksum, GetTypeHash(Table->GetPathName()));
+
+		TArray<FName> RowNames = Table->GetRowNames();
+		RowNames.Sort(FNameLexicalLess());
+		for (const FName& RowName : RowNames)
+		{
+			FItemDefinitionRecord& Record = ItemDefinitions.AddDefaulted_GetRef();
+			Record.Handle.DataTable = Table;
+			Record.Handle.RowName = RowName;
+			Record.Entry = Table->FindRow<FItemDefinitionEntry>(RowName, FString(), false);
+
+			ItemDefinitionIds.Add(FDefinitionKey(Table, RowName), ItemDefinitions.Num());
+			Checksum = HashCombine(Checksum, GetTypeHash(RowName.ToString()));
+		}
+	}
+
+	for (UDataTable* Table : AffixDefinitionTables)
+	{
+		RegisteredTables.Add(Table);
+		Checksum = HashCombine(Checksum, GetTypeHash(Table->GetPathName()));
+
+		TArray<FName> RowNames = Table->GetRowNames();
+		RowNames.Sort(FNameLexicalLess());
+		for (const FName& RowName : RowNames)
+		{
+			FAffixDefinitionRecord& Record = AffixDefinitions.AddDefaulted_GetRef();
+			Record.Handle.DataTable = Table;
+			Record.Handle.RowName = RowName;
+			Record.Entry = Table->FindRow<FAffixDefinitionEntry>(RowName, FString(), false);
+
+			AffixDefinitionIds.Add(FDefinitionKey(Table, RowName), AffixDefinitions.Num());
+			Checksum = HashCombine(Checksum, GetTypeHash(RowName.ToString()));
+		}
+	}
+
+	RegisterSocketDefinitions();
+
+#if WITH_EDITOR
+	for (UDataTable* Table : RegisteredTables)
+	{
+		Table->OnDataTableChanged().AddUObject(this, &UGenericItemizationDefinitionRegistry::OnRegisteredTableChanged);
+	}
+#endif
+
+	// The network version is cached, and now needs to include our new Checksum.
+	FNetworkVersion::InvalidateNetworkChecksum();
+
+	UE_LOG(LogGenericItemizationRegistry, Log, TEXT("Registered %d ItemDefinitions, %d AffixDefinitions and %d SocketDefinitions from %d DataTables (Checksum: %08x)."),
+		ItemDefinitions.Num(), AffixDefinitions.Num(), SocketDefinitions.Num(), RegisteredTables.Num(), Checksum);
+}
+
+void UGenericItemizationDefinitionRegistry::GatherDefinitionTables(const TArray<TSoftObjectPtr<UDataTable>>& ConfiguredTables, const UScriptStruct* RowStruct, bool bAutoDiscover, TArray<UDataTable*>& OutTables) const
+{
+	for (const TSoftObjectPtr<UDataTable>& ConfiguredTable : ConfiguredTables)
+	{
+		UDataTable* Table = ConfiguredTable.LoadSynchronous();
+		if (Table && Table->GetRowStruct() && Table->GetRowStruct()->IsChildOf(RowStruct))
+		{
+			OutTables.AddUnique(Table);
+		}
+		else if (!ConfiguredTable.IsNull())
+		{
+			UE_LOG(LogGenericItemizationRegistry, Warning, TEXT("%s is not a DataTable of %s and will not be registered."), *ConfiguredTable.ToString(), *RowStruct->GetName());
+		}
+	}
+
+	if (bAutoDiscover)
+	{
+		IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(AssetRegistryConstants::ModuleName).Get();
+
+		TArray<FAssetData> TableAssets;
+		AssetRegistry.GetAssetsByClass(UDataTable::StaticClass()->GetClassPathName(), TableAssets);
+
+		const FString RowStructPath = RowStruct->GetPathName();
+		for (const FAssetData& TableAsset : TableAssets)
+		{
+			if (TableAsset.GetTagValueRef<FString>(TEXT("RowStructure")) == RowStructPath)
+			{
+				if (UDataTable* Table = Cast<UDataTable>(TableAsset.GetAsset()))
+				{
+					OutTables.AddUnique(Table);
+				}
+			}
+		}
+	}
+
+	// The order of the DataTables is what makes the Ids deterministic between processes.
+	OutTables.Sort([](const UDataTable& A, const UDataTable& B)
+	{
+		return A.GetPathName() < B.GetPathName();
+	});
+}
+
+void UGenericItemizationDefinitionRegistry::RegisterSocketDefinitions()
+{
+	TArray<UClass*> SocketSettingsClasses;
+	for (const FItemDefinitionRecord& Record : ItemDefinitions)
+	{
+		if (Record.Entry && Record.Entry->ItemDefinition.IsValid())
+		{
+			const FItemDefinition& ItemDefinition = Record.Entry->ItemDefinition.Get();
+			if (!ItemDefinition.bStacksOverSockets && ItemDefinition.SocketSettings)
+			{
+				SocketSettingsClasses.AddUnique(ItemDefinition.SocketSettings.Get());
+			}
+		}
+	}
+
+	SocketSettingsClasses.Sort([](const UClass& A, const UClass& B)
+	{
+		return A.GetPathName() < B.GetPathName();
+	});
+
+	for (UClass* SocketSettingsClass : SocketSettingsClasses)
+	{
+		const UItemSocketSettings* const SocketSettingsCDO = GetDefault<UItemSocketSettings>(SocketSettingsClass);
+		Checksum = HashCombine(Checksum, GetTypeHash(SocketSettingsClass->GetPathName()));
+
+		for (int32 Index = 0; Index < SocketSettingsCDO->SocketDefinitions.Num(); ++Index)
+		{
+			const TInstancedStruct<FItemSocketDefinition>& SocketDefinition = SocketSettingsCDO->SocketDefinitions[Index];
+			if (!SocketDefinition.IsValid())
+			{
+				continue;
+			}
+
+			FSocketDefinitionRecord& Record = SocketDefinitions.AddDefaulted_GetRef();
+			Record.SocketSettings = SocketSettingsClass;
+			Record.SocketDefinitionIndex = Index;
+
+			SocketDefinitionIds.Add(SocketDefinition.Get().SocketDefinitionHandle, SocketDefinitions.Num());
+			Checksum = HashCombine(Checksum, GetTypeHash(Index));
+		}
+	}
+}
+
+#if WITH_EDITOR
+void UGenericItemizationDefinitionRegistry::OnRegisteredTableChanged()
+{
+	// Rows may have been added, removed or reallocated so none of our cached state can be trusted.
+	Rebuild();
+}
+#endif
+
+uint32 UGenericItemizationDefinitionRegistry::GetItemDefinitionId(const FDataTableRowHandle& Handle)
+{
+	const uint32* Id = ItemDefinitionIds.Find(FDefinitionKey(Handle.DataTable, Handle.RowName));
+	return Id ? *Id : InvalidId;
+}
+
+uint32 UGenericItemizationDefinitionRegistry::GetAffixDefinitionId(const FDataTableRowHandle& Handle)
+{
+	const uint32* Id = AffixDefinitionIds.Find(FDefinitionKey(Handle.DataTable, Handle.RowName));
+	return Id ? *Id : InvalidId;
+}
+
+uint32 UGenericItemizationDefinitionRegistry::GetSocketDefinitionId(const FGuid& SocketDefinitionHandle)
+{
+	const uint32* Id = SocketDefinitionIds.Find(SocketDefinitionHandle);
+	return Id ? *Id : InvalidId;
+}
+
+const FItemDefinitionEntry* UGenericItemizationDefinitionRegistry::FindItemDefinition(uint32 Id, FDataTableRowHandle& OutHandle)
+{
+	const int32 Index = static_cast<int32>(Id) - 1;
+	if (!ItemDefinitions.IsValidIndex(Index))
+	{
+		return nullptr;
+	}
+
+	OutHandle = ItemDefinitions[Index].Handle;
+	return ItemDefinitions[Index].Entry;
+}
+
+const FAffixDefinitionEntry* UGenericItemizationDefinitionRegistry::FindAffixDefinition(uint32 Id, FDataTableRowHandle& OutHandle)
+{
+	const int32 Index = static_cast<int32>(Id) - 1;
+	if (!AffixDefinitions.IsValidIndex(Index))
+	{
+		return nullptr;
+	}
+
+	OutHandle = AffixDefinitions[Index].Handle;
+	return AffixDefinitions[Index].Entry;
+}
+
+const FItemSocketDefinition* UGenericItemizationDefinitionRegistry::FindSocketDefinition(uint32 Id)
+{
+	const int32 Index = static_cast<int32>(Id) - 1;
+	if (!SocketDefinitions.IsValidIndex(Index) || !SocketDefinitions[Index].SocketSettings)
+	{
+		return nullptr;
+	}
+
+	const FSocketDefinitionRecord& Record = SocketDefinitions[Index];
+	const UItemSocketSettings* const SocketSettingsCDO = Record.SocketSettings.GetDefaultObject();
+	if (!SocketSettingsCDO->SocketDefinitions.IsValidIndex(Record.SocketDefinitionIndex))
+	{
+		return nullptr;
+	}
+
+	return SocketSettingsCDO->SocketDefinitions[Record.SocketDefinitionIndex].GetPtr();
+}
+
+void UGenericItemizationDefinitionRegistry::NetSerializeItemDefinitionHandle(FArchive& Ar, FDataTableRowHandle& Handle, const TInstancedStruct<FItemDefinition>*& OutItemDefinition)
+{
+	OutItemDefinition = nullptr;
+
+	UGenericItemizationDefinitionRegistry* Registry = GetDefault<UGenericItemizationSettings>()->bUseDefinitionRegistry ? Get() : nullptr;
+
+	uint32 Id = InvalidId;
+	if (Ar.IsSaving() && Registry)
+	{
+		Id = Registry->GetItemDefinitionId(Handle);
+	}
+
+	uint8 bIsRegistered = Id != InvalidId;
+	Ar.SerializeBits(&bIsRegistered, 1);
+
+	if (bIsRegistered)
+	{
+		Ar.SerializeIntPacked(Id);
+		if (Ar.IsLoading())
+		{
+			const FItemDefinitionEntry* Entry = Registry ? Registry->FindItemDefinition(Id, Handle) : nullptr;
+			if (Entry)
+			{
+				OutItemDefinition = &Entry->ItemDefinition;
+			}
+			else
+			{
+				UE_LOG(LogGenericItemizationRegistry, Warning, TEXT("Received unknown ItemDefinition Id %u, make sure the Server and Client have the same Registry Checksum."), Id);
+				Handle = FDataTableRowHandle();
+			}
+		}
+	}
+	else
+	{
+		Ar << Handle.DataTable;
+		Ar << Handle.RowName;
+	}
+}
+
+void UGenericItemizationDefinitionRegistry::NetSerializeAffixDefinitionHandle(FArchive& Ar, FDataTableRowHandle& Handle, const TInstancedStruct<FAffixDefinition>*& OutAffixDefinition)
+{
+	OutAffixDefinition = nullptr;
+
+	UGenericItemizationDefinitionRegistry* Registry = GetDefault<UGenericItemizationSettings>()->bUseDefinitionRegistry ? Get() : nullptr;
+
+	uint32 Id = InvalidId;
+	if (Ar.IsSaving() && Registry)
+	{
+		Id = Registry->GetAffixDefinitionId(Handle);
+	}
+
+	uint8 bIsRegistered = Id != InvalidId;
+	Ar.SerializeBits(&bIsRegistered, 1);
+
+	if (bIsRegistered)
+	{
+		Ar.SerializeIntPacked(Id);
+		if (Ar.IsLoading())
+		{
+			const FAffixDefinitionEntry* Entry = Registry ? Registry->FindAffixDefinition(Id, Handle) : nullptr;
+			if (Entry)
+			{
+				OutAffixDefinition = &Entry->AffixDefinition;
+			}
+			else
+			{
+				UE_LOG(LogGenericItemizationRegistry, Warning, TEXT("Received unknown AffixDefinition Id %u, make sure the Server and Client have the same Registry Checksum."), Id);
+				Handle = FDataTableRowHandle();
+			}
+		}
+	}
+	else
+	{
+		Ar << Handle.DataTable;
+		Ar << Handle.RowName;
+	}
+}
+
+void UGenericItemizationDefinitionRegistry::NetSerializeSocketDefinitionHandle(FArchive& Ar, FGuid& SocketDefinitionHandle)
+{
+	UGenericItemizationDefinitionRegistry* Registry = GetDefault<UGenericItemizationSettings>()->bUseDefinitionRegistry ? Get() : nullptr;
+
+	uint32 Id = InvalidId;
+	if (Ar.IsSaving() && Registry)
+	{
+		Id = Registry->GetSocketDefinitionId(SocketDefinitionHandle);
+	}
+
+	uint8 bIsRegistered = Id != InvalidId;
+	Ar.SerializeBits(&bIsRegistered, 1);
+
+	if (bIsRegistered)
+	{
+		Ar.SerializeIntPacked(Id);
+		if (Ar.IsLoading())
+		{
+			// SocketDefinitionHandles are generated per process, so we remap to the handle of our local copy of the SocketDefinition.
+			const FItemSocketDefinition* SocketDefinition = Registry ? Registry->FindSocketDefinition(Id) : nullptr;
+			SocketDefinitionHandle = SocketDefinition ? SocketDefinition->SocketDefinitionHandle : FGuid();
+		}
+	}
+	else
+	{
+		Ar << SocketDefinitionHandle;
+	}
+}
@@ -1,5 +1,13 @@
 #include "GenericItemizationInstanceTypes.h"
 #include "ItemManagement/ItemInventoryComponent.h"
+#include "ItemManagement/ItemStackSettings.h"
+#include "GenericItemizationDefinitionRegistry.h"
+#include "Engine/PackageMapClient.h"
+#include "Engine/NetConnection.h"
+
+#if UE_WITH_IRIS
+#include "Iris/IrisConfig.h"
+#endif
 
 /************************************************************************/
 /* Affixes
@@ -8,12 +16,20 @@
 bool FAffixInstance::NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess)
 {
 	Ar << bPredefinedAffix;
-	Ar << AffixDefinitionHandle.DataTable;
-	Ar << AffixDefinitionHandle.RowName;
 
+	// Ar << AffixDefinitionHandle;
+	const TInstancedStruct<FAffixDefinition>* RegisteredAffixDefinition = nullptr;
+	UGenericItemizationDefinitionRegistry::NetSerializeAffixDefinitionHandle(Ar, AffixDefinitionHandle, RegisteredAffixDefinition);
 	if (Ar.IsLoading())
 	{
-		SetAffixDefinition(AffixDefinitionHandle);
+		if (RegisteredAffixDefinition)
+		{
+			SetAffixDefinition(AffixDefinitionHandle, *RegisteredAffixDefinition);
+		}
+		else
+		{
+			SetAffixDefinition(AffixDefinitionHandle);
+		}
 	}
 
 	bOutSuccess = true;
@@ -33,6 +49,12 @@ void FAffixInstance::SetAffixDefinition(const FDataTableRowHandle& Handle)
 	}
 }
 
+void FAffixInstance::SetAffixDefinition(const FDataTableRowHandle& Handle, const TInstancedStruct<FAffixDefinition>& InAffixDefinition)
+{
+	AffixDefinitionHandle = Handle;
+	AffixDefinition = InAffixDefinition;
+}
+
 /************************************************************************/
 /* Items
 /************************************************************************/
@@ -43,6 +65,23 @@ FItemSocketInstance::FItemSocketInstance()
 	bIsEmpty = false;
 }
 
+bool FItemSocketInstance::NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess)
+{
+	Ar << SocketId;
+
+	uint8 bEmpty = bIsEmpty;
+	Ar.SerializeBits(&bEmpty, 1);
+	bIsEmpty = !!bEmpty;
+
+	// Ar << SocketDefinitionHandle;
+	// The SocketDefinition itself is resolved when the SocketInstance is added to its owning ItemInstance.
+	UGenericItemizationDefinitionRegistry::NetSerializeSocketDefinitionHandle(Ar, SocketDefinitionHandle);
+
+	SocketedItemInstance.NetSerialize(Ar, Map, bOutSuccess);
+
+	return true;
+}
+
 const FConstStructView FItemSocketInstance::GetSocketedItem() const
 {
 	return FConstStructView(SocketedItemInstance);
@@ -73,6 +112,22 @@ bool FItemInstance::HasAnyAffixOfType(const FGameplayTag& AffixType) const
 	return false;
 }
 
+bool FItemInstance::MatchesTypes(const FGameplayTagContainer& ItemTypes, const FGameplayTagContainer& QualityTypes) const
+{
+	if (!QualityTypes.IsEmpty() && !QualityType.MatchesAny(QualityTypes))
+	{
+		return false;
+	}
+
+	if (!ItemTypes.IsEmpty())
+	{
+		const FItemDefinition* ItemDefinitionPtr = ItemDefinition.GetPtr();
+		return ItemDefinitionPtr && ItemDefinitionPtr->ItemType.MatchesAny(ItemTypes);
+	}
+
+	return true;
+}
+
 bool FItemInstance::IsValid() const
 {
 	return ItemSeed != -1;
@@ -80,33 +135,117 @@ bool FItemInstance::IsValid() const
 
 bool FItemInstance::NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess)
 {
-	Ar << ItemId;
-	Ar << ItemSeed;
-	Ar << ItemLevel;
-	Ar << AffixLevel;
-	Ar << QualityType;
-	Ar << StackCount;
+	return NetSerializeFields(Ar, Map, EItemInstanceFields::All, bOutSuccess);
+}
 
-	// Ar << ItemDefinitionHandle;
-	Ar << ItemDefinitionHandle.DataTable;
-	Ar << ItemDefinitionHandle.RowName;
-	if (Ar.IsLoading())
+bool FItemInstance::NetSerializeFields(FArchive& Ar, class UPackageMap* Map, EItemInstanceFields Fields, bool& bOutSuccess)
+{
+	bOutSuccess = true;
+
+	if (EnumHasAnyFlags(Fields, EItemInstanceFields::ItemId))
 	{
-		SetItemDefinition(ItemDefinitionHandle);
+		Ar << ItemId;
 	}
 
-	//Ar << ItemStream;
-	int32 ItemStreamSeed;
-	if (Ar.IsSaving())
+	if (EnumHasAnyFlags(Fields, EItemInstanceFields::ItemSeed))
 	{
-		ItemStreamSeed = ItemStream.GetCurrentSeed();
+		Ar << ItemSeed;
 	}
-	Ar << ItemStreamSeed;
-	if (Ar.IsLoading())
+
+	if (EnumHasAnyFlags(Fields, EItemInstanceFields::ItemLevel))
+	{
+		Ar << ItemLevel;
+	}
+
+	if (EnumHasAnyFlags(Fields, EItemInstanceFields::AffixLevel))
+	{
+		Ar << AffixLevel;
+	}
+
+	if (EnumHasAnyFlags(Fields, EItemInstanceFields::QualityType))
+	{
+		Ar << QualityType;
+	}
+
+	if (EnumHasAnyFlags(Fields, EItemInstanceFields::StackCount))
+	{
+		Ar << StackCount;
+	}
+
+	if (EnumHasAnyFlags(Fields, EItemInstanceFields::ItemDefinition))
+	{
+		// Ar << ItemDefinitionHandle;
+		const TInstancedStruct<FItemDefinition>* RegisteredItemDefinition = nullptr;
+		UGenericItemizationDefinitionRegistry::NetSerializeItemDefinitionHandle(Ar, ItemDefinitionHandle, RegisteredItemDefinition);
+		if (Ar.IsLoading())
+		{
+			if (RegisteredItemDefinition)
+			{
+				SetItemDefinition(ItemDefinitionHandle, *RegisteredItemDefinition);
+			}
+			else
+			{
+				SetItemDefinition(ItemDefinitionHandle);
+			}
+		}
+	}
+
+	if (EnumHasAnyFlags(Fields, EItemInstanceFields::ItemStream))
+	{
+		//Ar << ItemStream;
+		int32 ItemStreamSeed;
+		if (Ar.IsSaving())
+		{
+			ItemStreamSeed = ItemStream.GetCurrentSeed();
+		}
+		Ar << ItemStreamSeed;
+		if (Ar.IsLoading())
+		{
+			ItemStream.Initialize(ItemStreamSeed);
+		}
+	}
+
+	if (EnumHasAnyFlags(Fields, EItemInstanceFields::Affixes))
+	{
+		NetSerializeAffixes(Ar, Map);
+	}
+
+	if (EnumHasAnyFlags(Fields, EItemInstanceFields::Sockets))
+	{
+		NetSerializeSockets(Ar, Map);
+	}
+
+	return true;
+}
+
+bool FItemInstance::GetFieldsForProperty(const FName& PropertyName, EItemInstanceFields& OutFields)
+{
+	static const TMap<FName, EItemInstanceFields> PropertyFields = {
+		{ GET_MEMBER_NAME_CHECKED(FItemInstance, ItemId), EItemInstanceFields::ItemId },
+		{ GET_MEMBER_NAME_CHECKED(FItemInstance, ItemSeed), EItemInstanceFields::ItemSeed },
+		{ GET_MEMBER_NAME_CHECKED(FItemInstance, ItemStream), EItemInstanceFields::ItemStream },
+		{ GET_MEMBER_NAME_CHECKED(FItemInstance, ItemLevel), EItemInstanceFields::ItemLevel },
+		{ GET_MEMBER_NAME_CHECKED(FItemInstance, AffixLevel), EItemInstanceFields::AffixLevel },
+		{ GET_MEMBER_NAME_CHECKED(FItemInstance, QualityType), EItemInstanceFields::QualityType },
+		{ GET_MEMBER_NAME_CHECKED(FItemInstance, Affixes), EItemInstanceFields::Affixes },
+		{ GET_MEMBER_NAME_CHECKED(FItemInstance, StackCount), EItemInstanceFields::StackCount },
+		{ GET_MEMBER_NAME_CHECKED(FItemInstance, Sockets), EItemInstanceFields::Sockets },
+		{ GET_MEMBER_NAME_CHECKED(FItemInstance, ItemDefinition), EItemInstanceFields::ItemDefinition },
+		{ GET_MEMBER_NAME_CHECKED(FItemInstance, ItemDefinitionHandle), EItemInstanceFields::ItemDefinition },
+	};
+
+	if (const EItemInstanceFields* Fields = PropertyFields.Find(PropertyName))
 	{
-		ItemStream.Initialize(ItemStreamSeed);
+		OutFields = *Fields;
+		return true;
 	}
 
+	OutFields = EItemInstanceFields::None;
+	return false;
+}
+
+void FItemInstance::NetSerializeAffixes(FArchive& Ar, class UPackageMap* Map)
+{
 	// Ar << Affixes;
 	TArray<FInstancedStruct> ReplicatedAffixes;
 	if (Ar.IsSaving())
@@ -130,7 +269,10 @@ bool FItemInstance::NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOu
 			Affixes.Add(Affix);
 		}
 	}
+}
 
+void FItemInstance::NetSerializeSockets(FArchive& Ar, class UPackageMap* Map)
+{
 	// Ar << Sockets;
 	TArray<FInstancedStruct> ReplicatedSockets;
 	if (Ar.IsSaving())
@@ -147,6 +289,7 @@ bool FItemInstance::NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOu
 	{
 		// We need to empty the actual array as we are effectively rebuilding it.
 		Sockets.Empty(ReplicatedSockets.Num());
+		SocketIdToIndex.Reset();
 		for (const FInstancedStruct& ReplicatedSocket : ReplicatedSockets)
 		{
 			TInstancedStruct<FItemSocketInstance> Socket;
@@ -155,9 +298,6 @@ bool FItemInstance::NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOu
 			AddSocket(Socket);
 		}
 	}
-
-	bOutSuccess = true;
-	return true;
 }
 
 void FItemInstance::SetItemDefinition(const FDataTableRowHandle& Handle)
@@ -173,22 +313,33 @@ void FItemInstance::SetItemDefinition(const FDataTableRowHandle& Handle)
 	}
 }
 
+void FItemInstance::SetItemDefinition(const FDataTableRowHandle& Handle, const TInstancedStruct<FItemDefinition>& InItemDefinition)
+{
+	ItemDefinitionHandle = Handle;
+	ItemDefinition = InItemDefinition;
+}
+
 void FItemInstance::AddSocket(TInstancedStruct<FItemSocketInstance>& NewSocket)
 {
 	// Let the Socket know what its definition is.
 	FSetSocketInstanceSocketDefinition(ItemDefinition.GetPtr(), NewSocket.GetMutablePtr());
-	Sockets.Add(NewSocket);
+	const int32 Index = Sockets.Add(NewSocket);
+
+	if (const FItemSocketInstance* SocketInstance = NewSocket.GetPtr())
+	{
+		SocketIdToIndex.Add(SocketInstance->SocketId, Index);
+	}
 }
 
 TOptional<const FConstStructView> FItemInstance::GetSocket(const FGuid SocketId) const
 {
 	TOptional<const FConstStructView> Result;
-	for (const TInstancedStruct<FItemSocketInstance>& Socket : Sockets)
+
+	const int32 Index = FindSocketIndex(SocketId);
+	if (Index != INDEX_NONE)
 	{
-		if (Socket.Get().SocketId == SocketId)
-		{
-			Result.Emplace(FConstStructView(Socket.GetScriptStruct(), Socket.GetMemory()));
-		}
+		const TInstancedStruct<FItemSocketInstance>& Socket = Sockets[Index];
+		Result.Emplace(FConstStructView(Socket.GetScriptStruct(), Socket.GetMemory()));
 	}
 
 	return Result;
@@ -196,196 +347,1064 @@ TOptional<const FConstStructView> FItemInstance::GetSocket(const FGuid SocketId)
 
 bool FItemInstance::HasSocket(const FGuid SocketId) const
 {
-	for (const TInstancedStruct<FItemSocketInstance>& Socket : Sockets)
+	return FindSocketIndex(SocketId) != INDEX_NONE;
+}
+
+int32 FItemInstance::FindSocketIndex(const FGuid& SocketId) const
+{
+	auto IsSocketAt = [this, &SocketId](int32 Index)
 	{
-		if (Socket.Get().SocketId == SocketId)
-		{
-			return true;
-		}
+		const FItemSocketInstance* SocketInstance = Sockets.IsValidIndex(Index) ? Sockets[Index].GetPtr() : nullptr;
+		return SocketInstance && SocketInstance->SocketId == SocketId;
+	};
+
+	const int32* Index = SocketIdToIndex.Find(SocketId);
+	if (Index && IsSocketAt(*Index))
+	{
+		return *Index;
 	}
 
-	return false;
+	// A missing Socket only needs the index rebuilt if Sockets were added or removed without going through AddSocket, or the index was copied.
+	if (Index || SocketIdToIndex.Num() != Sockets.Num())
+	{
+		RebuildSocketIndex();
+		Index = SocketIdToIndex.Find(SocketId);
+	}
+
+	return Index ? *Index : INDEX_NONE;
 }
 
-void FFastItemInstance::Initialize(const FInstancedStruct& InItemInstance, const FInstancedStruct& InUserContextData)
+const FItemSocketInstance* FItemInstance::FindSocket(const FGuid& SocketId) const
 {
-	ItemInstance = InItemInstance;
-	UserContextData = InUserContextData;
-
-	// Make a copy of the ItemInstance for change comparison.
-	PreReplicatedChangeItemInstance.InitializeAs(ItemInstance.GetScriptStruct(), ItemInstance.GetMemory());
+	const int32 Index = FindSocketIndex(SocketId);
+	return Index != INDEX_NONE ? Sockets[Index].GetPtr() : nullptr;
 }
 
-void FFastItemInstance::PostReplicatedAdd(const struct FFastItemInstancesContainer& InArray)
+FItemSocketInstance* FItemInstance::FindMutableSocket(const FGuid& SocketId)
 {
-	// Update our cached state.
-	PreReplicatedChangeItemInstance.InitializeAs(ItemInstance.GetScriptStruct(), ItemInstance.GetMemory());
-	PreviousChangesId = RecentChangesId;
+	const int32 Index = FindSocketIndex(SocketId);
+	return Index != INDEX_NONE ? Sockets[Index].GetMutablePtr() : nullptr;
 }
 
-void FFastItemInstance::PostReplicatedChange(const struct FFastItemInstancesContainer& InArray)
+void FItemInstance::RebuildSocketIndex() const
 {
+	SocketIdToIndex.Reset();
+	SocketIdToIndex.Reserve(Sockets.Num());
 
+	for (int32 Index = 0; Index < Sockets.Num(); Index++)
+	{
+		if (const FItemSocketInstance* SocketInstance = Sockets[Index].GetPtr())
+		{
+			SocketIdToIndex.Add(SocketInstance->SocketId, Index);
+		}
+	}
 }
 
-void FFastItemInstance::PreReplicatedRemove(const struct FFastItemInstancesContainer& InArray)
+void FFastItemInstance::Initialize(const FInstancedStruct& InItemInstance, const FInstancedStruct& InUserContextData)
 {
+	ItemInstance = InItemInstance;
+	UserContextData = InUserContextData;
+}
 
+void FFastItemInstance::Initialize(FInstancedStruct&& InItemInstance, FInstancedStruct&& InUserContextData)
+{
+	ItemInstance = MoveTemp(InItemInstance);
+	UserContextData = MoveTemp(InUserContextData);
 }
 
-void FFastItemInstancesContainer::PostReplicatedAdd(const TArrayView<int32>& AddedIndices, int32 FinalSize)
+bool FFastItemInstance::NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess)
 {
-	for (const int32& Index : AddedIndices)
+	bOutSuccess = true;
+
+	EFastItemInstanceFields Fields = EFastItemInstanceFields::All;
+	EItemInstanceFields ItemFields = EItemInstanceFields::All;
+	if (Ar.IsSaving())
 	{
-		const FFastItemInstance& FastItemInstance = ItemInstances[Index];
-		const FInstancedStruct& PostAddItemInstance = FastItemInstance.ItemInstance;
-		if (Owner)
+		// Connections that already have this ItemInstance only need the fields that changed since they were last sent it.
+		const FNetFastArrayBaseState* BaseState = FFastItemInstancesContainer::GetActiveWriteBaseState();
+		const int32* BaseReplicationKey = BaseState ? BaseState->IDToCLMap.Find(ReplicationID) : nullptr;
+		if (!BaseReplicationKey || !GetDirtyFieldsSince(*BaseReplicationKey, Fields, ItemFields))
 		{
-			Owner->OnAddedItemInstance(FastItemInstance);
+			Fields = EFastItemInstanceFields::All;
+			ItemFields = EItemInstanceFields::All;
+		}
+
+		// Anything other than a FItemInstance can only be sent in its entirety.
+		if (ItemInstance.GetScriptStruct() != FItemInstance::StaticStruct())
+		{
+			EnumAddFlags(Fields, EFastItemInstanceFields::ItemInstance);
 		}
 	}
-}
 
-void FFastItemInstancesContainer::PostReplicatedChange(const TArrayView<int32>& ChangedIndices, int32 FinalSize)
-{
-	for (const int32& Index : ChangedIndices)
+	// A Connection that doesn't have this ItemInstance yet will receive it as a new ItemInstance, which never needs any Changes.
+	// If we no longer know which Changes the Connection has, it is treated as having none of them.
+	int32 ConnectionChangesId = 0;
+	const FNetFastArrayBaseState* WriteBaseState = Ar.IsSaving() ? FFastItemInstancesContainer::GetActiveWriteBaseState() : nullptr;
+	if (WriteBaseState)
 	{
-		FFastItemInstance& FastItemInstance = ItemInstances[Index];
-		OnItemInstanceChanged(FastItemInstance);
+		const int32* BaseReplicationKey = WriteBaseState->IDToCLMap.Find(ReplicationID);
+		ConnectionChangesId = RecentChangesId;
+		if (BaseReplicationKey && !GetRecentChangesIdAt(*BaseReplicationKey, ConnectionChangesId))
+		{
+			ConnectionChangesId = 0;
+		}
+
+		RecordConnectionChangesId(ConnectionChangesId);
 	}
-}
 
-void FFastItemInstancesContainer::PreReplicatedRemove(const TArrayView<int32>& RemovedIndices, int32 FinalSize)
-{
-	for (const int32& Index : RemovedIndices)
+	uint32 SerializedFields = static_cast<uint32>(Fields);
+	Ar.SerializeBits(&SerializedFields, 3);
+	Fields = static_cast<EFastItemInstanceFields>(SerializedFields);
+
+	if (EnumHasAnyFlags(Fields, EFastItemInstanceFields::RecentChanges))
 	{
-		const FFastItemInstance& FastItemInstance = ItemInstances[Index];
-		const FInstancedStruct& PreRemoveItemInstance = FastItemInstance.ItemInstance;
-		if (Owner)
+		Ar << RecentChangesId;
+
+		// Ar << RecentChangesBuffer;
+		// Only the Changes the Connection doesn't have yet are written. If we no longer know which those are, everything we have is written
+		// and the Client will notice the gap and resynchronize itself.
+		int32 FirstChangeIndex = 0;
+		if (WriteBaseState)
 		{
-			Owner->OnRemovedItemInstance(FastItemInstance);
+			while (FirstChangeIndex < GetNumRecentChanges() && GetRecentChange(FirstChangeIndex).ChangeId <= ConnectionChangesId)
+			{
+				FirstChangeIndex++;
+			}
+		}
+
+		int32 NumChanges = GetNumRecentChanges() - FirstChangeIndex;
+		Ar << NumChanges;
+		if (Ar.IsLoading())
+		{
+			if (NumChanges < 0 || NumChanges > MaxRecentChanges)
+			{
+				Ar.SetError();
+				bOutSuccess = false;
+				return false;
+			}
+
+			RecentChangesBuffer.SetNum(NumChanges);
+			RecentChangesHead = 0;
+			NumRecentChanges = NumChanges;
+		}
+
+		for (int32 i = FirstChangeIndex; i < GetNumRecentChanges(); ++i)
+		{
+			FItemInstanceChange& Change = RecentChangesBuffer[GetRecentChangeBufferIndex(i)];
+			Change.ChangeDescriptor.NetSerialize(Ar, Map, bOutSuccess);
+			Ar << Change.ChangeId;
+			Ar << Change.ChangedProperties;
+		}
+	}
+
+	// Changes are read before the ItemInstance so that we can snapshot the properties they name before they are overwritten.
+	if (Ar.IsLoading() && ItemInstance.IsValid())
+	{
+		if (HasMissedRecentChanges())
+		{
+			CaptureAllPropertySnapshots();
+		}
+		else
+		{
+			for (int32 i = 0; i < GetNumRecentChanges(); ++i)
+			{
+				const FItemInstanceChange& Change = GetRecentChange(i);
+				if (Change.ChangeId > PreviousChangesId)
+				{
+					for (const FName& PropertyName : Change.ChangedProperties)
+					{
+						CapturePropertySnapshot(PropertyName);
+					}
+				}
+			}
+		}
+	}
+
+	if (EnumHasAnyFlags(Fields, EFastItemInstanceFields::ItemInstance))
+	{
+		ItemInstance.NetSerialize(Ar, Map, bOutSuccess);
+	}
+	else
+	{
+		uint32 SerializedItemFields = static_cast<uint32>(ItemFields);
+		Ar.SerializeBits(&SerializedItemFields, ItemInstanceFieldsNumBits);
+		ItemFields = static_cast<EItemInstanceFields>(SerializedItemFields);
+
+		if (Ar.IsLoading() && !ItemInstance.GetPtr<FItemInstance>())
+		{
+			ItemInstance.InitializeAs<FItemInstance>();
 		}
+
+		ItemInstance.GetMutable<FItemInstance>().NetSerializeFields(Ar, Map, ItemFields, bOutSuccess);
+	}
+
+	if (EnumHasAnyFlags(Fields, EFastItemInstanceFields::UserContextData))
+	{
+		UserContextData.NetSerialize(Ar, Map, bOutSuccess);
 	}
+
+	return true;
 }
 
-void FFastItemInstancesContainer::Register(UItemInventoryComponent* InOwner)
+void FFastItemInstance::RecordDirtyFields(EFastItemInstanceFields Fields, EItemInstanceFields ItemFields)
 {
-	if (Owner != InOwner && InOwner != nullptr)
+	if (DirtyFieldsHistory.Num() >= MaxDirtyFieldsHistory)
 	{
-		Owner = InOwner;
-		bOwnerIsNetAuthority = Owner->HasAuthority();
+		DirtyFieldsHistoryFloor = DirtyFieldsHistory[0].ReplicationKey;
+		DirtyFieldsHistoryFloorChangesId = DirtyFieldsHistory[0].RecentChangesId;
+		DirtyFieldsHistory.RemoveAt(0, 1, EAllowShrinking::No);
 	}
+
+	FDirtyFields& DirtyFields = DirtyFieldsHistory.AddDefaulted_GetRef();
+	DirtyFields.ReplicationKey = ReplicationKey;
+	DirtyFields.RecentChangesId = RecentChangesId;
+	DirtyFields.Fields = Fields;
+	DirtyFields.ItemFields = ItemFields;
 }
 
-void FFastItemInstancesContainer::AddItemInstance(FInstancedStruct& ItemInstance, FInstancedStruct& UserContextData)
+bool FFastItemInstance::GetDirtyFieldsSince(int32 BaseReplicationKey, EFastItemInstanceFields& OutFields, EItemInstanceFields& OutItemFields) const
 {
-	if (!Owner)
+	// If we were marked dirty without recording what changed, or the Connection is further behind than we remember, we can't know what it's missing.
+	if (DirtyFieldsHistory.IsEmpty() || DirtyFieldsHistory.Last().ReplicationKey != ReplicationKey || BaseReplicationKey < DirtyFieldsHistoryFloor)
 	{
-		return;
+		return false;
 	}
 
-	FFastItemInstance FastItemInstance;
-	FastItemInstance.Initialize(ItemInstance, UserContextData);
-	ItemInstances.Add(FastItemInstance);
-
-	if (HasAuthority())
+	OutFields = EFastItemInstanceFields::None;
+	OutItemFields = EItemInstanceFields::None;
+	for (const FDirtyFields& DirtyFields : DirtyFieldsHistory)
 	{
-		Owner->OnAddedItemInstance(FastItemInstance);
-		MarkItemDirty(FastItemInstance);
+		if (DirtyFields.ReplicationKey > BaseReplicationKey)
+		{
+			OutFields |= DirtyFields.Fields;
+			OutItemFields |= DirtyFields.ItemFields;
+		}
 	}
+
+	return true;
 }
 
-void FFastItemInstancesContainer::OnItemInstanceChanged(FFastItemInstance& ChangedItemInstance) const
+void FFastItemInstance::AddRecentChange(FItemInstanceChange&& Change)
 {
-	DiffItemInstanceChanges(ChangedItemInstance);
+	TrimAcknowledgedRecentChanges();
 
-	if (Owner)
+	const int32 NumChanges = GetNumRecentChanges();
+	if (NumChanges < RecentChangesBuffer.Num())
 	{
-		Owner->OnChangedItemInstance(ChangedItemInstance);
+		RecentChangesBuffer[GetRecentChangeBufferIndex(NumChanges)] = MoveTemp(Change);
+		NumRecentChanges = NumChanges + 1;
+	}
+	else if (RecentChangesBuffer.Num() < MaxRecentChanges)
+	{
+		// Grow the ring by inserting the new Change just before the oldest one, which keeps every other Change in order.
+		const int32 OldestIndex = NumChanges > 0 ? GetRecentChangeBufferIndex(0) : 0;
+		RecentChangesBuffer.Insert(MoveTemp(Change), OldestIndex);
+		RecentChangesHead = (OldestIndex + 1) % RecentChangesBuffer.Num();
+		NumRecentChanges = NumChanges + 1;
+	}
+	else
+	{
+		// Out of room, so the oldest Change is overwritten. Any Client that hadn't received it yet will resynchronize with a full diff instead.
+		const int32 OldestIndex = GetRecentChangeBufferIndex(0);
+		RecentChangesBuffer[OldestIndex] = MoveTemp(Change);
+		RecentChangesHead = (OldestIndex + 1) % RecentChangesBuffer.Num();
 	}
+}
 
-	// Update our cached state.
-	ChangedItemInstance.PreReplicatedChangeItemInstance.InitializeAs(ChangedItemInstance.ItemInstance.GetScriptStruct(), ChangedItemInstance.ItemInstance.GetMemory());
-	ChangedItemInstance.PreviousChangesId = ChangedItemInstance.RecentChangesId;
+int32 FFastItemInstance::GetNumRecentChanges() const
+{
+	return FMath::Clamp(NumRecentChanges, 0, RecentChangesBuffer.Num());
 }
 
-bool FFastItemInstancesContainer::RemoveItemInstance(const FGuid& Item)
+int32 FFastItemInstance::GetRecentChangeBufferIndex(int32 Index) const
 {
-	for (int32 i = ItemInstances.Num() - 1; i >= 0; --i)
-	{
-		const FItemInstance* ItemInstancePtr = ItemInstances[i].ItemInstance.GetPtr<FItemInstance>();
-		if (ItemInstancePtr && ItemInstancePtr->IsValid() && ItemInstancePtr->ItemId == Item)
-		{
-			FFastItemInstance OldItemInstance = ItemInstances[i];
-			ItemInstances.RemoveAt(i);
+	check(Index >= 0 && Index < GetNumRecentChanges());
+	const int32 Head = FMath::Clamp(RecentChangesHead, 0, RecentChangesBuffer.Num() - 1);
+	return (Head + Index) % RecentChangesBuffer.Num();
+}
 
-			if(HasAuthority())
-			{
-				Owner->OnRemovedItemInstance(OldItemInstance);
-				MarkArrayDirty();
-			}
+void FFastItemInstance::RecordConnectionChangesId(int32 ConnectionChangesId)
+{
+	const TObjectKey<UNetConnection> Connection(FFastItemInstancesContainer::GetActiveWriteConnection());
+	if (Connection == TObjectKey<UNetConnection>())
+	{
+		return;
+	}
 
-			return true;
-		}
+	FConnectionChangesId* Entry = ConnectionChangesIds.FindByPredicate([&Connection](const FConnectionChangesId& Other) { return Other.Connection == Connection; });
+	if (!Entry)
+	{
+		Entry = &ConnectionChangesIds.AddDefaulted_GetRef();
+		Entry->Connection = Connection;
 	}
 
-	return false;
+	Entry->RecentChangesId = ConnectionChangesId;
 }
 
-TArray<FInstancedStruct> FFastItemInstancesContainer::GetItemInstances() const
+void FFastItemInstance::TrimAcknowledgedRecentChanges()
 {
-	TArray<FInstancedStruct> Result;
-	Result.Reserve(ItemInstances.Num());
+	// Connections that have since closed no longer hold back the trim.
+	ConnectionChangesIds.RemoveAllSwap([](const FConnectionChangesId& Entry) { return Entry.Connection.ResolveObjectPtr() == nullptr; });
+	if (ConnectionChangesIds.IsEmpty())
+	{
+		// Without knowing what anyone has, only MaxRecentChanges limits the RecentChangesBuffer.
+		return;
+	}
 
-	for (const FFastItemInstance& ItemInstance : ItemInstances)
+	int32 AcknowledgedChangesId = MAX_int32;
+	for (const FConnectionChangesId& Entry : ConnectionChangesIds)
 	{
-		Result.Add(ItemInstance.ItemInstance);
+		AcknowledgedChangesId = FMath::Min(AcknowledgedChangesId, Entry.RecentChangesId);
 	}
 
-	return Result;
+	while (GetNumRecentChanges() > 0 && GetRecentChange(0).ChangeId <= AcknowledgedChangesId)
+	{
+		const int32 OldestIndex = GetRecentChangeBufferIndex(0);
+		RecentChangesBuffer[OldestIndex] = FItemInstanceChange();
+		RecentChangesHead = (OldestIndex + 1) % RecentChangesBuffer.Num();
+		NumRecentChanges--;
+	}
 }
 
-const FFastItemInstance* FFastItemInstancesContainer::GetItemInstance(const FGuid& Item) const
+bool FFastItemInstance::GetRecentChangesIdAt(int32 InReplicationKey, int32& OutRecentChangesId) const
 {
-	for (const FFastItemInstance& FastItemInstance : ItemInstances)
+	if (InReplicationKey >= ReplicationKey)
 	{
-		const FItemInstance* ItemInstancePtr = FastItemInstance.ItemInstance.GetPtr<FItemInstance>();
-		if (ItemInstancePtr && ItemInstancePtr->ItemId == Item)
+		OutRecentChangesId = RecentChangesId;
+		return true;
+	}
+
+	if (InReplicationKey < DirtyFieldsHistoryFloor)
+	{
+		return false;
+	}
+
+	OutRecentChangesId = DirtyFieldsHistoryFloorChangesId;
+	for (const FDirtyFields& DirtyFields : DirtyFieldsHistory)
+	{
+		if (DirtyFields.ReplicationKey > InReplicationKey)
 		{
-			return &FastItemInstance;
+			break;
 		}
+
+		OutRecentChangesId = DirtyFields.RecentChangesId;
 	}
 
-	return nullptr;
+	return true;
 }
 
-int32 FFastItemInstancesContainer::GetNum() const
+namespace GenericItemizationPrivate
 {
-	return ItemInstances.Num();
-}
 
-void FFastItemInstancesContainer::DiffItemInstanceChanges(const FFastItemInstance& ChangedItemInstance) const
+/**
+ * The resolved properties of an ItemInstance ScriptStruct, keyed by their name.
+ * Changes identify the properties they modify by name, this saves walking the ScriptStruct for every one of them.
+ * Properties of nested structs are resolved the same way FInstancedStruct::FindInnerPropertyInstance does, the first match in field order wins.
+ */
+struct FItemInstancePropertyCache
 {
-	if(IsValid(Owner))
+	struct FResolvedProperty
 	{
-		for (const FItemInstanceChange& RecentChange : ChangedItemInstance.RecentChangesBuffer)
-		{
-			if (RecentChange.ChangeId > ChangedItemInstance.PreviousChangesId)
-			{
-				for (const FName& PropertyName : RecentChange.ChangedProperties)
-				{
-					const FProperty* OldProperty = nullptr;
-					const void* OldPropertyData = nullptr;
-					const bool bFoundOldProperty = ChangedItemInstance.PreReplicatedChangeItemInstance.FindInnerPropertyInstance(PropertyName, OldProperty, OldPropertyData);
+		const FProperty* Property = nullptr;
+
+		/* Offset of the struct that contains the Property from the start of the ItemInstance. */
+		int32 ContainerOffset = 0;
+	};
+
+	TMap<FName, FResolvedProperty> Properties;
+
+	const FResolvedProperty* FindProperty(const FName& PropertyName) const
+	{
+		return Properties.Find(PropertyName);
+	}
+
+	/* Returns the cache for the ScriptStruct, building it the first time it is asked for. */
+	static const FItemInstancePropertyCache& Get(const UScriptStruct* ScriptStruct)
+	{
+		const TObjectKey<UScriptStruct> ScriptStructKey(ScriptStruct);
+		{
+			FReadScopeLock ReadLock(CachesLock);
+			if (const TUniquePtr<FItemInstancePropertyCache>* Cache = Caches.Find(ScriptStructKey))
+			{
+				return **Cache;
+			}
+		}
+
+		FWriteScopeLock WriteLock(CachesLock);
+
+		// ScriptStructs that have since been destroyed will never be asked for again.
+		for (auto It = Caches.CreateIterator(); It; ++It)
+		{
+			if (!It.Key().ResolveObjectPtr())
+			{
+				It.RemoveCurrent();
+			}
+		}
+
+		TUniquePtr<FItemInstancePropertyCache>& Cache = Caches.FindOrAdd(ScriptStructKey);
+		if (!Cache.IsValid())
+		{
+			Cache = MakeUnique<FItemInstancePropertyCache>();
+			if (ScriptStruct)
+			{
+				Cache->AddProperties(ScriptStruct, 0);
+			}
+		}
+
+		return *Cache;
+	}
+
+	static void Reset()
+	{
+		FWriteScopeLock WriteLock(CachesLock);
+		Caches.Empty();
+	}
+
+private:
+
+	static FRWLock CachesLock;
+	static TMap<TObjectKey<UScriptStruct>, TUniquePtr<FItemInstancePropertyCache>> Caches;
+
+	void AddProperties(const UStruct* Struct, int32 ContainerOffset)
+	{
+		for (TFieldIterator<FProperty> It(Struct); It; ++It)
+		{
+			if (!Properties.Contains(It->GetFName()))
+			{
+				Properties.Add(It->GetFName(), { *It, ContainerOffset });
+			}
+
+			if (const FStructProperty* StructProperty = CastField<FStructProperty>(*It))
+			{
+				AddProperties(StructProperty->Struct, ContainerOffset + StructProperty->GetOffset_ForInternal());
+			}
+		}
+	}
+};
+
+FRWLock FItemInstancePropertyCache::CachesLock;
+TMap<TObjectKey<UScriptStruct>, TUniquePtr<FItemInstancePropertyCache>> FItemInstancePropertyCache::Caches;
+
+}
+
+void FFastItemInstance::ResetPropertyCaches()
+{
+	GenericItemizationPrivate::FItemInstancePropertyCache::Reset();
+}
+
+FFastItemInstance::FPropertySnapshot::FPropertySnapshot(const FProperty* InProperty, int32 InContainerOffset, const void* InValue) :
+	Property(InProperty),
+	ContainerOffset(InContainerOffset)
+{
+	Value = FMemory::Malloc(Property->GetSize(), Property->GetMinAlignment());
+	Property->InitializeValue(Value);
+	Property->CopyCompleteValue(Value, InValue);
+}
+
+FFastItemInstance::FPropertySnapshot::~FPropertySnapshot()
+{
+	Property->DestroyValue(Value);
+	FMemory::Free(Value);
+}
+
+void FFastItemInstance::CapturePropertySnapshot(const FName& PropertyName)
+{
+	const UScriptStruct* ItemInstanceStruct = ItemInstance.GetScriptStruct();
+	if (!ItemInstanceStruct)
+	{
+		return;
+	}
+
+	if (PropertySnapshotsStruct != ItemInstanceStruct)
+	{
+		PropertySnapshots.Reset();
+		PropertySnapshotsStruct = ItemInstanceStruct;
+	}
+
+	const GenericItemizationPrivate::FItemInstancePropertyCache::FResolvedProperty* ResolvedProperty = GenericItemizationPrivate::FItemInstancePropertyCache::Get(ItemInstanceStruct).FindProperty(PropertyName);
+	if (ResolvedProperty && !FindPropertySnapshot(ResolvedProperty->Property))
+	{
+		const void* PropertyValue = ResolvedProperty->Property->ContainerPtrToValuePtr<void>(ItemInstance.GetMemory() + ResolvedProperty->ContainerOffset);
+		PropertySnapshots.Add(MakeShared<FPropertySnapshot>(ResolvedProperty->Property, ResolvedProperty->ContainerOffset, PropertyValue));
+	}
+}
+
+void FFastItemInstance::CaptureAllPropertySnapshots()
+{
+	const UScriptStruct* ItemInstanceStruct = ItemInstance.GetScriptStruct();
+	if (!ItemInstanceStruct)
+	{
+		return;
+	}
+
+	for (TFieldIterator<FProperty> It(ItemInstanceStruct); It; ++It)
+	{
+		CapturePropertySnapshot(It->GetFName());
+	}
+}
+
+const FFastItemInstance::FPropertySnapshot* FFastItemInstance::FindPropertySnapshot(const FProperty* Property) const
+{
+	for (const TSharedRef<const FPropertySnapshot>& PropertySnapshot : PropertySnapshots)
+	{
+		if (PropertySnapshot->Property == Property)
+		{
+			return &PropertySnapshot.Get();
+		}
+	}
+
+	return nullptr;
+}
+
+void FFastItemInstance::ResetPropertySnapshots()
+{
+	PropertySnapshots.Reset();
+	PropertySnapshotsStruct = nullptr;
+}
+
+bool FFastItemInstance::HasMissedRecentChanges() const
+{
+	return RecentChangesId > PreviousChangesId && (GetNumRecentChanges() == 0 || GetRecentChange(0).ChangeId > PreviousChangesId + 1);
+}
+
+void FFastItemInstance::PostReplicatedAdd(const struct FFastItemInstancesContainer& InArray)
+{
+	// Update our cached state.
+	PreviousChangesId = RecentChangesId;
+
+#if UE_WITH_IRIS
+	// Iris applies incoming members directly, without giving us a chance to snapshot the ones that are about to change.
+	if (UE::Net::ShouldUseIrisReplication())
+	{
+		CaptureAllPropertySnapshots();
+	}
+#endif
+}
+
+void FFastItemInstance::PostReplicatedChange(const struct FFastItemInstancesContainer& InArray)
+{
+
+}
+
+void FFastItemInstance::PreReplicatedRemove(const struct FFastItemInstancesContainer& InArray)
+{
+
+}
+
+void FFastItemInstancesContainer::PostReplicatedAdd(const TArrayView<int32>& AddedIndices, int32 FinalSize)
+{
+	FItemInventoryTransaction Transaction(Owner);
+	for (const int32& Index : AddedIndices)
+	{
+		const FFastItemInstance& FastItemInstance = ItemInstances[Index];
+
+		// Once anything was removed the indices are only final after this update, PostReplicatedReceive then rebuilds them all.
+		const FItemInstance* ItemInstancePtr = FastItemInstance.ItemInstance.GetPtr<FItemInstance>();
+		if (!bItemIdToIndexDirty && ItemInstancePtr)
+		{
+			ItemIdToIndex.Add(ItemInstancePtr->ItemId, Index);
+		}
+
+		IndexItemInstance(FastItemInstance);
+
+		const FInstancedStruct& PostAddItemInstance = FastItemInstance.ItemInstance;
+		if (Owner && !IsTab())
+		{
+			Owner->OnAddedItemInstance(FastItemInstance);
+		}
+	}
+}
+
+void FFastItemInstancesContainer::PostReplicatedChange(const TArrayView<int32>& ChangedIndices, int32 FinalSize)
+{
+	FItemInventoryTransaction Transaction(Owner);
+	for (const int32& Index : ChangedIndices)
+	{
+		FFastItemInstance& FastItemInstance = ItemInstances[Index];
+		OnItemInstanceChanged(FastItemInstance);
+	}
+}
+
+void FFastItemInstancesContainer::PreReplicatedRemove(const TArrayView<int32>& RemovedIndices, int32 FinalSize)
+{
+	// The removed ItemInstances are only taken out of the array after this, moving the ones after them.
+	bItemIdToIndexDirty = true;
 
-					const FProperty* NewProperty = nullptr;
-					const void* NewPropertyData = nullptr;
-					const bool bFoundNewProperty = ChangedItemInstance.ItemInstance.FindInnerPropertyInstance(PropertyName, NewProperty, NewPropertyData);
+	FItemInventoryTransaction Transaction(Owner);
+	for (const int32& Index : RemovedIndices)
+	{
+		const FFastItemInstance& FastItemInstance = ItemInstances[Index];
+		const FInstancedStruct& PreRemoveItemInstance = FastItemInstance.ItemInstance;
+		if (Owner && !IsTab())
+		{
+			Owner->OnRemovedItemInstance(FastItemInstance);
+		}
 
-					if (bFoundOldProperty && bFoundNewProperty)
+		if (const FItemInstance* ItemInstancePtr = FastItemInstance.ItemInstance.GetPtr<FItemInstance>())
+		{
+			UnindexItemInstance(ItemInstancePtr->ItemId);
+		}
+	}
+}
+
+void FFastItemInstancesContainer::PostReplicatedReceive(const FFastArraySerializer::FPostReplicatedReceiveParameters& Parameters)
+{
+	if (bItemIdToIndexDirty)
+	{
+		RebuildItemIdToIndex();
+	}
+
+	if (Owner && IsTab())
+	{
+		Owner->OnTabItemInstancesReceived(Tab);
+	}
+}
+
+/* The base state of the Connection currently being written to, so that each FFastItemInstance can work out which of its fields that Connection is missing. */
+static thread_local const FNetFastArrayBaseState* GActiveItemInstancesWriteBaseState = nullptr;
+
+const FNetFastArrayBaseState* FFastItemInstancesContainer::GetActiveWriteBaseState()
+{
+	return GActiveItemInstancesWriteBaseState;
+}
+
+/* The Connection currently being written to, so that each FFastItemInstance can record which of its Changes that Connection has. */
+static thread_local const UNetConnection* GActiveItemInstancesWriteConnection = nullptr;
+
+const UNetConnection* FFastItemInstancesContainer::GetActiveWriteConnection()
+{
+	return GActiveItemInstancesWriteConnection;
+}
+
+bool FFastItemInstancesContainer::NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParams)
+{
+	const UPackageMapClient* const PackageMapClient = Cast<UPackageMapClient>(DeltaParams.Map);
+	const UNetConnection* const Connection = PackageMapClient ? PackageMapClient->GetConnection() : nullptr;
+
+	// Connections that are not allowed to see the contents of the Inventory are never written to, so they never receive any ItemInstances.
+	if (DeltaParams.Writer && Owner)
+	{
+		// Tabs are only written to the owning Connection while it is subscribed to them, until then they are left dormant.
+		if (IsTab() ? !Owner->ShouldReplicateTabTo(Tab, Connection) : !Owner->ShouldReplicateItemInstancesTo(Connection))
+		{
+			return false;
+		}
+	}
+
+	TGuardValue<const FNetFastArrayBaseState*> ActiveWriteBaseStateGuard(GActiveItemInstancesWriteBaseState, DeltaParams.Writer ? static_cast<const FNetFastArrayBaseState*>(DeltaParams.OldState) : nullptr);
+	TGuardValue<const UNetConnection*> ActiveWriteConnectionGuard(GActiveItemInstancesWriteConnection, DeltaParams.Writer ? Connection : nullptr);
+	return FFastArraySerializer::FastArrayDeltaSerialize<FFastItemInstance, FFastItemInstancesContainer>(ItemInstances, DeltaParams, *this);
+}
+
+void FFastItemInstancesContainer::Register(UItemInventoryComponent* InOwner, int32 InTab /*= INDEX_NONE*/)
+{
+	if (Owner != InOwner && InOwner != nullptr)
+	{
+		Owner = InOwner;
+		bOwnerIsNetAuthority = Owner->HasAuthority();
+	}
+
+	Tab = InTab;
+}
+
+void FFastItemInstancesContainer::AddItemInstance(FInstancedStruct& ItemInstance, FInstancedStruct& UserContextData)
+{
+	AddItemInstance(FInstancedStruct(ItemInstance), FInstancedStruct(UserContextData));
+}
+
+void FFastItemInstancesContainer::AddItemInstance(FInstancedStruct&& ItemInstance, FInstancedStruct&& UserContextData)
+{
+	if (!Owner)
+	{
+		return;
+	}
+
+	FItemInventoryTransaction Transaction(Owner);
+
+	const int32 Index = ItemInstances.AddDefaulted();
+	FFastItemInstance& FastItemInstance = ItemInstances[Index];
+	FastItemInstance.Initialize(MoveTemp(ItemInstance), MoveTemp(UserContextData));
+
+	if (const FItemInstance* ItemInstancePtr = FastItemInstance.ItemInstance.GetPtr<FItemInstance>())
+	{
+		ItemIdToIndex.Add(ItemInstancePtr->ItemId, Index);
+	}
+
+	IndexItemInstance(FastItemInstance);
+
+	if (HasAuthority())
+	{
+		if (!IsTab())
+		{
+			Owner->OnAddedItemInstance(FastItemInstance);
+		}
+
+		MarkItemFieldsDirty(FastItemInstance, EFastItemInstanceFields::All, EItemInstanceFields::All);
+	}
+}
+
+void FFastItemInstancesContainer::AddItemInstance(TInstancedStruct<FItemInstance>&& ItemInstance, FInstancedStruct&& UserContextData)
+{
+	AddItemInstance(MoveToInstancedStruct(MoveTemp(ItemInstance)), MoveTemp(UserContextData));
+}
+
+FInstancedStruct FFastItemInstancesContainer::MoveToInstancedStruct(TInstancedStruct<FItemInstance>&& ItemInstance)
+{
+	FInstancedStruct Result;
+	if (ItemInstance.GetScriptStruct() == FItemInstance::StaticStruct())
+	{
+		Result.InitializeAs<FItemInstance>(MoveTemp(ItemInstance.GetMutable()));
+	}
+	else if (ItemInstance.IsValid())
+	{
+		Result.InitializeAs(ItemInstance.GetScriptStruct(), ItemInstance.GetMemory());
+	}
+
+	ItemInstance.Reset();
+	return Result;
+}
+
+void FFastItemInstancesContainer::MarkItemFieldsDirty(FFastItemInstance& ItemInstance, EFastItemInstanceFields Fields, EItemInstanceFields ItemFields)
+{
+	const FItemInstance* ItemInstancePtr = ItemInstance.ItemInstance.GetPtr<FItemInstance>();
+	if (bDeferMarkDirty && ItemInstancePtr)
+	{
+		TPair<EFastItemInstanceFields, EItemInstanceFields>& PendingFields = PendingDirtyItems.FindOrAdd(ItemInstancePtr->ItemId, { EFastItemInstanceFields::None, EItemInstanceFields::None });
+		PendingFields.Key |= Fields;
+		PendingFields.Value |= ItemFields;
+		return;
+	}
+
+	MarkItemDirty(ItemInstance);
+	ItemInstance.RecordDirtyFields(Fields, ItemFields);
+}
+
+void FFastItemInstancesContainer::MarkItemInstancesArrayDirty()
+{
+	if (bDeferMarkDirty)
+	{
+		bPendingMarkArrayDirty = true;
+		return;
+	}
+
+	MarkArrayDirty();
+}
+
+void FFastItemInstancesContainer::FlushPendingDirty()
+{
+	bDeferMarkDirty = false;
+
+	if (!PendingDirtyItems.IsEmpty())
+	{
+		for (const TPair<FGuid, TPair<EFastItemInstanceFields, EItemInstanceFields>>& PendingItem : PendingDirtyItems)
+		{
+			if (FFastItemInstance* FastItemInstance = FindItemInstance(PendingItem.Key))
+			{
+				MarkItemDirty(*FastItemInstance);
+				FastItemInstance->RecordDirtyFields(PendingItem.Value.Key, PendingItem.Value.Value);
+			}
+		}
+
+		// ItemInstances that were removed before the flush are simply no longer found.
+		PendingDirtyItems.Reset();
+	}
+
+	if (bPendingMarkArrayDirty)
+	{
+		bPendingMarkArrayDirty = false;
+		MarkArrayDirty();
+	}
+}
+
+void FFastItemInstancesContainer::OnItemInstanceChanged(FFastItemInstance& ChangedItemInstance)
+{
+	FItemInventoryTransaction Transaction(Owner);
+	if (!IsTab())
+	{
+		DiffItemInstanceChanges(ChangedItemInstance);
+	}
+
+	// The change might have moved the ItemInstance to a different QualityType or even ItemDefinition.
+	IndexItemInstance(ChangedItemInstance);
+
+	if (Owner && !IsTab())
+	{
+		Owner->OnChangedItemInstance(ChangedItemInstance);
+	}
+
+	// Update our cached state.
+	ChangedItemInstance.ResetPropertySnapshots();
+	ChangedItemInstance.PreviousChangesId = ChangedItemInstance.RecentChangesId;
+
+#if UE_WITH_IRIS
+	if (!HasAuthority() && UE::Net::ShouldUseIrisReplication())
+	{
+		ChangedItemInstance.CaptureAllPropertySnapshots();
+	}
+#endif
+}
+
+bool FFastItemInstancesContainer::RemoveItemInstance(const FGuid& Item)
+{
+	FInstancedStruct RemovedItemInstance;
+	return RemoveItemInstance(Item, RemovedItemInstance);
+}
+
+bool FFastItemInstancesContainer::RemoveItemInstance(const FGuid& Item, FInstancedStruct& OutItemInstance)
+{
+	// Copied as Item may refer to the ItemId within the ItemInstance that is about to be moved out.
+	const FGuid ItemId = Item;
+	const int32 Index = FindItemInstanceIndex(ItemId);
+	if (Index == INDEX_NONE)
+	{
+		return false;
+	}
+
+	const FItemInstance* ItemInstancePtr = ItemInstances[Index].ItemInstance.GetPtr<FItemInstance>();
+	if (!ItemInstancePtr || !ItemInstancePtr->IsValid())
+	{
+		return false;
+	}
+
+	FItemInventoryTransaction Transaction(Owner);
+
+	// The ItemInstance is moved out rather than copied, and the last ItemInstance is swapped into its place instead of shifting every one after it.
+	// Clients match ItemInstances by their ReplicationID rather than their index, so the order of the array does not need to be kept.
+	FFastItemInstance OldItemInstance = MoveTemp(ItemInstances[Index]);
+	ItemInstances.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+
+	ItemIdToIndex.Remove(ItemId);
+	UnindexItemInstance(ItemId);
+	if (ItemInstances.IsValidIndex(Index))
+	{
+		if (const FItemInstance* MovedItemInstancePtr = ItemInstances[Index].ItemInstance.GetPtr<FItemInstance>())
+		{
+			ItemIdToIndex.Add(MovedItemInstancePtr->ItemId, Index);
+		}
+	}
+
+	if(HasAuthority())
+	{
+		if (!IsTab())
+		{
+			Owner->OnRemovedItemInstance(OldItemInstance);
+		}
+
+		MarkItemInstancesArrayDirty();
+	}
+
+	OutItemInstance = MoveTemp(OldItemInstance.ItemInstance);
+	return true;
+}
+
+TArray<FInstancedStruct> FFastItemInstancesContainer::GetItemInstances() const
+{
+	TArray<FInstancedStruct> Result;
+	Result.Reserve(ItemInstances.Num());
+
+	for (const FFastItemInstance& ItemInstance : ItemInstances)
+	{
+		Result.Add(ItemInstance.ItemInstance);
+	}
+
+	return Result;
+}
+
+const FFastItemInstance* FFastItemInstancesContainer::GetItemInstance(const FGuid& Item) const
+{
+	const int32 Index = FindItemInstanceIndex(Item);
+	return Index != INDEX_NONE ? &ItemInstances[Index] : nullptr;
+}
+
+FFastItemInstance* FFastItemInstancesContainer::FindItemInstance(const FGuid& Item)
+{
+	const int32 Index = FindItemInstanceIndex(Item);
+	return Index != INDEX_NONE ? &ItemInstances[Index] : nullptr;
+}
+
+int32 FFastItemInstancesContainer::FindItemInstanceIndex(const FGuid& Item) const
+{
+	if (bItemIdToIndexDirty)
+	{
+		RebuildItemIdToIndex();
+	}
+
+	const int32* Index = ItemIdToIndex.Find(Item);
+	return Index ? *Index : INDEX_NONE;
+}
+
+const TSet<FGuid>* FFastItemInstancesContainer::FindItemInstancesWithDefinition(const FDataTableRowHandle& ItemDefinition) const
+{
+	return ItemsByDefinition.Find(FItemDefinitionKey(ItemDefinition.DataTable.Get(), ItemDefinition.RowName));
+}
+
+const TSet<FGuid>* FFastItemInstancesContainer::FindItemInstancesOfType(const FGameplayTag& ItemType) const
+{
+	return ItemsByItemType.Find(ItemType);
+}
+
+const TSet<FGuid>* FFastItemInstancesContainer::FindItemInstancesOfQuality(const FGameplayTag& QualityType) const
+{
+	return ItemsByQualityType.Find(QualityType);
+}
+
+const TSet<FGuid>* FFastItemInstancesContainer::FindOpenStacksWithStackKey(uint32 StackKey) const
+{
+	return OpenStacksByStackKey.Find(StackKey);
+}
+
+void FFastItemInstancesContainer::IndexItemInstance(const FFastItemInstance& FastItemInstance)
+{
+	const FItemInstance* ItemInstancePtr = FastItemInstance.ItemInstance.GetPtr<FItemInstance>();
+	if (!ItemInstancePtr)
+	{
+		return;
+	}
+
+	FItemInstanceIndexKeys Keys;
+	const FDataTableRowHandle& ItemDefinitionHandle = ItemInstancePtr->GetItemDefinitionHandle();
+	Keys.ItemDefinition = FItemDefinitionKey(ItemDefinitionHandle.DataTable.Get(), ItemDefinitionHandle.RowName);
+	Keys.QualityType = ItemInstancePtr->QualityType;
+	if (const FItemDefinition* ItemDefinitionPtr = ItemInstancePtr->GetItemDefinition().GetPtr())
+	{
+		Keys.ItemType = ItemDefinitionPtr->ItemType;
+
+		// Full stacks are left out, so that every ItemInstance found by its stack key can actually be stacked onto.
+		const UItemStackSettings* StackSettingsCDO = ItemDefinitionPtr->StackSettings.GetDefaultObject();
+		uint32 StackKey = 0;
+		if (StackSettingsCDO
+			&& (StackSettingsCDO->HasUnlimitedStacks() || ItemInstancePtr->StackCount < StackSettingsCDO->GetStackLimit())
+			&& StackSettingsCDO->SupportsStackKeys()
+			&& StackSettingsCDO->ComputeStackKey(*ItemInstancePtr, StackKey))
+		{
+			Keys.OpenStackKey = StackKey;
+		}
+	}
+
+	const FGuid& ItemId = ItemInstancePtr->ItemId;
+	if (const FItemInstanceIndexKeys* IndexedKeys = IndexedItemKeys.Find(ItemId))
+	{
+		if (*IndexedKeys == Keys)
+		{
+			return;
+		}
+
+		UnindexItemInstance(ItemId);
+	}
+
+	// The parents are walked one at a time rather than gathered with GetGameplayTagParents, which would allocate a container for every change.
+	ItemsByDefinition.FindOrAdd(Keys.ItemDefinition).Add(ItemId);
+	for (FGameplayTag ItemType = Keys.ItemType; ItemType.IsValid(); ItemType = ItemType.RequestDirectParent())
+	{
+		ItemsByItemType.FindOrAdd(ItemType).Add(ItemId);
+	}
+	for (FGameplayTag QualityType = Keys.QualityType; QualityType.IsValid(); QualityType = QualityType.RequestDirectParent())
+	{
+		ItemsByQualityType.FindOrAdd(QualityType).Add(ItemId);
+	}
+	if (Keys.OpenStackKey.IsSet())
+	{
+		OpenStacksByStackKey.FindOrAdd(Keys.OpenStackKey.GetValue()).Add(ItemId);
+	}
+
+	IndexedItemKeys.Add(ItemId, MoveTemp(Keys));
+}
+
+void FFastItemInstancesContainer::UnindexItemInstance(const FGuid& ItemId)
+{
+	FItemInstanceIndexKeys Keys;
+	if (!IndexedItemKeys.RemoveAndCopyValue(ItemId, Keys))
+	{
+		return;
+	}
+
+	auto RemoveFromIndex = [&ItemId](auto& Index, const auto& Key)
+	{
+		if (TSet<FGuid>* ItemIds = Index.Find(Key))
+		{
+			ItemIds->Remove(ItemId);
+			if (ItemIds->IsEmpty())
+			{
+				Index.Remove(Key);
+			}
+		}
+	};
+
+	RemoveFromIndex(ItemsByDefinition, Keys.ItemDefinition);
+	for (FGameplayTag ItemType = Keys.ItemType; ItemType.IsValid(); ItemType = ItemType.RequestDirectParent())
+	{
+		RemoveFromIndex(ItemsByItemType, ItemType);
+	}
+	for (FGameplayTag QualityType = Keys.QualityType; QualityType.IsValid(); QualityType = QualityType.RequestDirectParent())
+	{
+		RemoveFromIndex(ItemsByQualityType, QualityType);
+	}
+	if (Keys.OpenStackKey.IsSet())
+	{
+		RemoveFromIndex(OpenStacksByStackKey, Keys.OpenStackKey.GetValue());
+	}
+}
+
+void FFastItemInstancesContainer::RebuildItemIdToIndex() const
+{
+	ItemIdToIndex.Reset();
+	ItemIdToIndex.Reserve(ItemInstances.Num());
+
+	for (int32 Index = 0; Index < ItemInstances.Num(); Index++)
+	{
+		if (const FItemInstance* ItemInstancePtr = ItemInstances[Index].ItemInstance.GetPtr<FItemInstance>())
+		{
+			ItemIdToIndex.Add(ItemInstancePtr->ItemId, Index);
+		}
+	}
+
+	bItemIdToIndexDirty = false;
+}
+
+int32 FFastItemInstancesContainer::GetNum() const
+{
+	return ItemInstances.Num();
+}
+
+void FFastItemInstancesContainer::Reserve(int32 Number)
+{
+	ItemInstances.Reserve(Number);
+	ItemIdToIndex.Reserve(Number);
+	IndexedItemKeys.Reserve(Number);
+}
+
+void FFastItemInstancesContainer::DiffItemInstanceChanges(const FFastItemInstance& ChangedItemInstance) const
+{
+	if(IsValid(Owner))
+	{
+		// If the oldest Change we have is not the next one we were expecting, then we have missed some and can only work out what changed by comparing everything.
+		if (ChangedItemInstance.HasMissedRecentChanges())
+		{
+			DiffAllItemInstanceProperties(ChangedItemInstance);
+			return;
+		}
+
+		const UScriptStruct* ItemInstanceStruct = ChangedItemInstance.ItemInstance.GetScriptStruct();
+		if (!ItemInstanceStruct || ChangedItemInstance.PropertySnapshotsStruct != ItemInstanceStruct)
+		{
+			return;
+		}
+
+		const GenericItemizationPrivate::FItemInstancePropertyCache& PropertyCache = GenericItemizationPrivate::FItemInstancePropertyCache::Get(ItemInstanceStruct);
+		const uint8* NewItemInstanceData = ChangedItemInstance.ItemInstance.GetMemory();
+		for (int32 i = 0; i < ChangedItemInstance.GetNumRecentChanges(); ++i)
+		{
+			const FItemInstanceChange& RecentChange = ChangedItemInstance.GetRecentChange(i);
+			if (RecentChange.ChangeId > ChangedItemInstance.PreviousChangesId)
+			{
+				for (const FName& PropertyName : RecentChange.ChangedProperties)
+				{
+					const GenericItemizationPrivate::FItemInstancePropertyCache::FResolvedProperty* ResolvedProperty = PropertyCache.FindProperty(PropertyName);
+					const FFastItemInstance::FPropertySnapshot* OldPropertySnapshot = ResolvedProperty ? ChangedItemInstance.FindPropertySnapshot(ResolvedProperty->Property) : nullptr;
+					if (OldPropertySnapshot)
 					{
-						const void* OldPropertyValue = OldProperty->ContainerPtrToValuePtr<const void>(OldPropertyData);
-						const void* NewPropertyValue = NewProperty->ContainerPtrToValuePtr<const void>(NewPropertyData);
+						const void* OldPropertyValue = OldPropertySnapshot->Value;
+						const void* NewPropertyValue = ResolvedProperty->Property->ContainerPtrToValuePtr<const void>(NewItemInstanceData + ResolvedProperty->ContainerOffset);
 						Owner->OnItemInstancePropertyValueChanged_Internal(ChangedItemInstance, RecentChange.ChangeDescriptor, RecentChange.ChangeId, PropertyName, OldPropertyValue, NewPropertyValue);
 					}
 				}
@@ -393,3 +1412,39 @@ void FFastItemInstancesContainer::DiffItemInstanceChanges(const FFastItemInstanc
 		}
 	}
 }
+
+void FFastItemInstancesContainer::DiffAllItemInstanceProperties(const FFastItemInstance& ChangedItemInstance) const
+{
+	const UScriptStruct* ItemInstanceStruct = ChangedItemInstance.ItemInstance.GetScriptStruct();
+	if (!IsValid(Owner) || !ItemInstanceStruct || ChangedItemInstance.PropertySnapshotsStruct != ItemInstanceStruct)
+	{
+		return;
+	}
+
+	const uint8* NewItemInstanceData = ChangedItemInstance.ItemInstance.GetMemory();
+	for (const TSharedRef<const FFastItemInstance::FPropertySnapshot>& PropertySnapshot : ChangedItemInstance.PropertySnapshots)
+	{
+		const FProperty* Property = PropertySnapshot->Property;
+		const void* OldPropertyValue = PropertySnapshot->Value;
+		const void* NewPropertyValue = Property->ContainerPtrToValuePtr<const void>(NewItemInstanceData + PropertySnapshot->ContainerOffset);
+		if (!Property->Identical(OldPropertyValue, NewPropertyValue))
+		{
+			Owner->OnItemInstancePropertyValueChanged_Internal(ChangedItemInstance, FGameplayTag(), ChangedItemInstance.RecentChangesId, Property->GetFName(), OldPropertyValue, NewPropertyValue);
+		}
+	}
+}
+
+bool FItemInventorySummaryEntry::NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess)
+{
+	Ar << ItemId;
+	Ar << QualityType;
+	uint32 PackedStackCount = FMath::Max(StackCount, 0);
+	Ar.SerializeIntPacked(PackedStackCount);
+	StackCount = PackedStackCount;
+
+	const TInstancedStruct<FItemDefinition>* RegisteredItemDefinition = nullptr;
+	UGenericItemizationDefinitionRegistry::NetSerializeItemDefinitionHandle(Ar, ItemDefinitionHandle, RegisteredItemDefinition);
+
+	bOutSuccess = true;
+	return true;
+}
@@ -0,0 +1,9 @@
+// Copyright Fissure Entertainment, Pty Ltd. All Rights Reserved.
+
+#include "GenericItemizationSettings.h"
+
+UGenericItemizationSettings::UGenericItemizationSettings()
+{
+	CategoryName = TEXT("Plugins");
+	SectionName = TEXT("Generic Itemization");
+}
@@ -493,3 +493,61 @@ bool UGenericItemizationStatics::GetItemAffixes(const TInstancedStruct<FItemInst
 
 	return OutAffixes.Num() > 0;
 }
+
+bool UGenericItemizationStatics::GetItemModifierAggregates(const TInstancedStruct<FItemInstance>& Item, TMap<FGameplayTag, FAffixModifierAggregate>& OutAggregates, bool bIncludeSocketedItems /*= true*/)
+{
+	OutAggregates.Reset();
+
+	const FItemInstance* ItemInstance = Item.GetPtr();
+	if (!ItemInstance)
+	{
+		return false;
+	}
+
+	AccumulateItemModifiers(*ItemInstance, OutAggregates, bIncludeSocketedItems);
+	return OutAggregates.Num() > 0;
+}
+
+void UGenericItemizationStatics::AccumulateItemModifiers(const FItemInstance& ItemInstance, TMap<FGameplayTag, FAffixModifierAggregate>& OutAggregates, bool bIncludeSocketedItems /*= true*/)
+{
+	auto AccumulateAffixes = [&OutAggregates](const TArray<TInstancedStruct<FAffixInstance>>& Affixes, bool bSocketed)
+	{
+		for (const TInstancedStruct<FAffixInstance>& Affix : Affixes)
+		{
+			const FAffixInstance* AffixInstance = Affix.GetPtr();
+			const FAffixDefinition* AffixDefinition = AffixInstance ? AffixInstance->GetAffixDefinition().GetPtr() : nullptr;
+			if (!AffixDefinition || (bSocketed && !AffixDefinition->bShouldAggregateInSockets))
+			{
+				continue;
+			}
+
+			for (const TInstancedStruct<FAffixModifier>& Modifier : AffixDefinition->Modifiers)
+			{
+				if (const FAffixModifier* AffixModifier = Modifier.GetPtr())
+				{
+					FAffixModifierAggregate& Aggregate = OutAggregates.FindOrAdd(AffixModifier->ModType);
+					Aggregate.ModMinimum += AffixModifier->ModMinimum;
+					Aggregate.ModMaximum += AffixModifier->ModMaximum;
+					Aggregate.NumModifiers++;
+				}
+			}
+		}
+	};
+
+	AccumulateAffixes(ItemInstance.Affixes, false);
+
+	if (bIncludeSocketedItems)
+	{
+		for (const TInstancedStruct<FItemSocketInstance>& Socket : ItemInstance.Sockets)
+		{
+			const FItemSocketInstance* SocketInstance = Socket.GetPtr();
+			if (SocketInstance && !SocketInstance->bIsEmpty)
+			{
+				if (const FItemInstance* SocketedItemInstance = SocketInstance->GetSocketedItem().GetPtr<const FItemInstance>())
+				{
+					AccumulateAffixes(SocketedItemInstance->Affixes, true);
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,1630 @@
+// Copyright Fissure Entertainment, Pty Ltd. All Rights Reserved.
+
+#include "Iris/ItemInstanceNetSerializer.h"
+
+#if UE_WITH_IRIS
+
+#include "Iris/Serialization/NetSerializerDelegates.h"
+#include "Iris/Serialization/NetSerializerArrayStorage.h"
+#include "Iris/Serialization/NetSerializers.h"
+#include "Iris/Serialization/ObjectNetSerializer.h"
+#include "Iris/Serialization/NetBitStreamReader.h"
+#include "Iris/Serialization/NetBitStreamWriter.h"
+#include "Iris/Serialization/NetBitStreamUtil.h"
+#include "Iris/Serialization/NetErrors.h"
+#include "Iris/ReplicationState/ReplicationStateDescriptor.h"
+#include "Iris/ReplicationState/ReplicationStateDescriptorBuilder.h"
+#include "Iris/ReplicationSystem/NetObjectReference.h"
+#include "Engine/DataTable.h"
+#include "GameplayTagsManager.h"
+#include "GenericItemizationInstanceTypes.h"
+#include "GenericItemizationDefinitionRegistry.h"
+#include "GenericItemizationSettings.h"
+
+namespace UE::Net::GenericItemizationPrivate
+{
+
+/* Upper bounds used to reject malformed data, these comfortably exceed what the legacy NetSerialize allows. */
+static constexpr uint32 MaxItems = 64;
+static constexpr uint32 MaxAffixes = 32 * MaxItems;
+static constexpr uint32 MaxSockets = 32 * MaxItems;
+static constexpr uint32 MaxStringBytes = 16 * 1024;
+static constexpr uint32 MaxReferences = MaxItems + MaxAffixes;
+static constexpr uint32 MaxDerivedElements = MaxAffixes + MaxSockets;
+
+/* Socket depth is always 1, anything deeper than this is considered malformed. */
+static constexpr int32 MaxSocketDepth = 4;
+
+/**
+ * A reference to a definition. Registered definitions only need their Id, any others store the index of their DataTable in the
+ * object references and their RowName in the string table.
+ * All of the quantized types are made of 32 bit members so that they have no padding and can be compared with a memcmp.
+ */
+struct FQuantizedDefinitionReference
+{
+	uint32 Id;
+	int32 TableIndex;
+	uint32 RowNameOffset;
+	uint32 RowNameLength;
+};
+
+struct FQuantizedItemHeader
+{
+	uint32 ItemId[4];
+	int32 ItemSeed;
+	int32 ItemStreamSeed;
+	int32 ItemLevel;
+	int32 AffixLevel;
+	int32 StackCount;
+	uint32 QualityTypeNetIndex;
+	FQuantizedDefinitionReference ItemDefinition;
+	uint32 FirstAffix;
+	uint32 NumAffixes;
+	uint32 FirstSocket;
+	uint32 NumSockets;
+};
+
+struct FQuantizedAffix
+{
+	FQuantizedDefinitionReference AffixDefinition;
+	uint32 bPredefinedAffix;
+
+	/* Index of the derived element that carries this whole AffixInstance when its type derives from FAffixInstance, otherwise INDEX_NONE. */
+	int32 DerivedElement;
+};
+
+struct FQuantizedSocket
+{
+	uint32 SocketId[4];
+	uint32 SocketDefinitionHandle[4];
+	uint32 SocketDefinitionId;
+	int32 SocketedItemIndex;
+	uint32 bIsEmpty;
+
+	/* Index of the derived element that carries this whole SocketInstance when its type derives from FItemSocketInstance, otherwise INDEX_NONE. */
+	int32 DerivedElement;
+
+	/* Index of the derived element that carries the socketed ItemInstance when its type derives from FItemInstance, otherwise INDEX_NONE. */
+	int32 SocketedItemDerivedElement;
+};
+
+/* The quantized state of a derived element is stored in blocks, so that it keeps the alignment its descriptor requires. */
+struct alignas(16) FQuantizedStateBlock
+{
+	uint8 Bytes[16];
+};
+
+/* Flattened representation of an ItemInstance and every ItemInstance socketed into it. The root ItemInstance is always the first Item. */
+struct FQuantizeScratch
+{
+	TArray<FQuantizedItemHeader, TInlineAllocator<4>> Items;
+	TArray<FQuantizedAffix, TInlineAllocator<16>> Affixes;
+	TArray<FQuantizedSocket, TInlineAllocator<8>> Sockets;
+	TArray<uint8> Strings;
+	TArray<const UObject*, TInlineAllocator<4>> Tables;
+	TArray<FItemInstanceNetSerializerDerivedElement> DerivedElements;
+	UGenericItemizationDefinitionRegistry* Registry = nullptr;
+
+	FQuantizeScratch()
+	{
+		Registry = GetDefault<UGenericItemizationSettings>()->bUseDefinitionRegistry ? UGenericItemizationDefinitionRegistry::Get() : nullptr;
+	}
+};
+
+/* Everything resolved from the quantized state that each ItemInstance needs when it is dequantized. */
+struct FDequantizeScratch
+{
+	TArray<const UDataTable*, TInlineAllocator<4>> Tables;
+	const uint8* Strings = nullptr;
+	UGenericItemizationDefinitionRegistry* Registry = nullptr;
+};
+
+template<typename ElementType>
+using TQuantizedArrayStorage = FNetSerializerArrayStorage<ElementType, AllocationPolicies::FElementAllocationPolicy>;
+
+/**
+ * Replicates derived elements through the descriptor of FItemInstanceNetSerializerDerivedElement, which Iris builds from its FInstancedStruct.
+ * The descriptor is only built the first time an element of a derived type is replicated.
+ */
+struct FDerivedElementSerializer
+{
+	FStructNetSerializerConfig Config;
+	uint32 BlocksPerElement = 0;
+	bool bHasDynamicState = false;
+	bool bHasObjectReference = false;
+
+	FDerivedElementSerializer()
+	{
+		Config.StateDescriptor = FReplicationStateDescriptorBuilder::CreateDescriptorForStruct(FItemInstanceNetSerializerDerivedElement::StaticStruct());
+
+		const FReplicationStateDescriptor* Descriptor = Config.StateDescriptor.GetReference();
+		check(Descriptor && Descriptor->InternalAlignment <= alignof(FQuantizedStateBlock));
+
+		BlocksPerElement = FMath::DivideAndRoundUp<uint32>(FMath::Max<uint32>(Descriptor->InternalSize, 1U), sizeof(FQuantizedStateBlock));
+		bHasDynamicState = EnumHasAnyFlags(Descriptor->Traits, EReplicationStateTraits::HasDynamicState);
+		bHasObjectReference = EnumHasAnyFlags(Descriptor->Traits, EReplicationStateTraits::HasObjectReference);
+	}
+
+	static const FDerivedElementSerializer& Get()
+	{
+		static const FDerivedElementSerializer DerivedElementSerializer;
+		return DerivedElementSerializer;
+	}
+
+	static const FNetSerializer& GetSerializer()
+	{
+		return UE_NET_GET_SERIALIZER(FStructNetSerializer);
+	}
+};
+
+static void QuantizeGuid(const FGuid& Guid, uint32 (&OutGuid)[4])
+{
+	OutGuid[0] = Guid.A;
+	OutGuid[1] = Guid.B;
+	OutGuid[2] = Guid.C;
+	OutGuid[3] = Guid.D;
+}
+
+static FGuid DequantizeGuid(const uint32 (&Guid)[4])
+{
+	return FGuid(Guid[0], Guid[1], Guid[2], Guid[3]);
+}
+
+static uint32 QuantizeGameplayTag(const FGameplayTag& Tag)
+{
+	return Tag.IsValid() ? UGameplayTagsManager::Get().GetNetIndexFromTag(Tag) : INVALID_TAGNETINDEX;
+}
+
+static FGameplayTag DequantizeGameplayTag(uint32 NetIndex)
+{
+	if (NetIndex == INVALID_TAGNETINDEX)
+	{
+		return FGameplayTag();
+	}
+
+	const UGameplayTagsManager& TagsManager = UGameplayTagsManager::Get();
+	return TagsManager.RequestGameplayTag(TagsManager.GetTagNameFromNetIndex(static_cast<FGameplayTagNetIndex>(NetIndex)), false);
+}
+
+static void QuantizeDefinitionReference(FQuantizeScratch& Scratch, uint32 Id, const FDataTableRowHandle& Handle, FQuantizedDefinitionReference& OutReference)
+{
+	OutReference.Id = Id;
+	OutReference.TableIndex = INDEX_NONE;
+	OutReference.RowNameOffset = 0;
+	OutReference.RowNameLength = 0;
+
+	if (Id == UGenericItemizationDefinitionRegistry::InvalidId && !Handle.IsNull())
+	{
+		const UObject* DataTable = Handle.DataTable;
+		OutReference.TableIndex = Scratch.Tables.AddUnique(DataTable);
+
+		const FTCHARToUTF8 RowNameUTF8(*Handle.RowName.ToString());
+		OutReference.RowNameOffset = Scratch.Strings.Num();
+		OutReference.RowNameLength = RowNameUTF8.Length();
+		Scratch.Strings.Append(reinterpret_cast<const uint8*>(RowNameUTF8.Get()), RowNameUTF8.Length());
+	}
+}
+
+static FDataTableRowHandle DequantizeDefinitionReference(const FQuantizedDefinitionReference& Reference, const FDequantizeScratch& Scratch)
+{
+	FDataTableRowHandle Handle;
+	if (Reference.TableIndex != INDEX_NONE)
+	{
+		Handle.DataTable = Scratch.Tables[Reference.TableIndex];
+		if (Handle.DataTable && Reference.RowNameLength > 0)
+		{
+			const FUTF8ToTCHAR RowName(reinterpret_cast<const ANSICHAR*>(Scratch.Strings + Reference.RowNameOffset), Reference.RowNameLength);
+			Handle.RowName = FName(RowName.Length(), RowName.Get());
+		}
+	}
+
+	return Handle;
+}
+
+/* Copies an element whose type derives from its base type into the Scratch, returns the index of the derived element. */
+static int32 AddDerivedElement(FQuantizeScratch& Scratch, const UScriptStruct* ScriptStruct, const uint8* Memory)
+{
+	FItemInstanceNetSerializerDerivedElement& DerivedElement = Scratch.DerivedElements.AddDefaulted_GetRef();
+	DerivedElement.Element.InitializeAs(ScriptStruct, Memory);
+	return Scratch.DerivedElements.Num() - 1;
+}
+
+/* Quantizes the members of an AffixInstance, these are left empty when a derived element carries the AffixInstance instead. */
+static void QuantizeAffix(FQuantizeScratch& Scratch, const FAffixInstance& Affix, int32 DerivedElement, FQuantizedAffix& OutAffix)
+{
+	FMemory::Memzero(OutAffix);
+	OutAffix.DerivedElement = DerivedElement;
+
+	if (DerivedElement != INDEX_NONE)
+	{
+		QuantizeDefinitionReference(Scratch, UGenericItemizationDefinitionRegistry::InvalidId, FDataTableRowHandle(), OutAffix.AffixDefinition);
+		return;
+	}
+
+	OutAffix.bPredefinedAffix = Affix.bPredefinedAffix ? 1U : 0U;
+
+	const FDataTableRowHandle& AffixDefinitionHandle = Affix.GetAffixDefinitionHandle();
+	const uint32 AffixDefinitionId = Scratch.Registry ? Scratch.Registry->GetAffixDefinitionId(AffixDefinitionHandle) : UGenericItemizationDefinitionRegistry::InvalidId;
+	QuantizeDefinitionReference(Scratch, AffixDefinitionId, AffixDefinitionHandle, OutAffix.AffixDefinition);
+}
+
+static void DequantizeAffix(const FQuantizedAffix& QuantizedAffix, const FDequantizeScratch& Scratch, FAffixInstance& OutAffix)
+{
+	OutAffix.bPredefinedAffix = QuantizedAffix.bPredefinedAffix != 0;
+
+	FDataTableRowHandle AffixDefinitionHandle;
+	const FAffixDefinitionEntry* AffixDefinitionEntry = QuantizedAffix.AffixDefinition.Id != UGenericItemizationDefinitionRegistry::InvalidId && Scratch.Registry ? Scratch.Registry->FindAffixDefinition(QuantizedAffix.AffixDefinition.Id, AffixDefinitionHandle) : nullptr;
+	if (AffixDefinitionEntry)
+	{
+		OutAffix.SetAffixDefinition(AffixDefinitionHandle, AffixDefinitionEntry->AffixDefinition);
+	}
+	else
+	{
+		OutAffix.SetAffixDefinition(DequantizeDefinitionReference(QuantizedAffix.AffixDefinition, Scratch));
+	}
+}
+
+/* Appends the ItemInstance and anything socketed into it to the Scratch, returns the index of the ItemInstance. */
+static int32 QuantizeItem(FQuantizeScratch& Scratch, const FItemInstance& Item, int32 Depth)
+{
+	const int32 ItemIndex = Scratch.Items.AddZeroed();
+
+	FQuantizedItemHeader Header;
+	FMemory::Memzero(Header);
+
+	QuantizeGuid(Item.ItemId, Header.ItemId);
+	Header.ItemSeed = Item.ItemSeed;
+	Header.ItemStreamSeed = Item.ItemStream.GetCurrentSeed();
+	Header.ItemLevel = Item.ItemLevel;
+	Header.AffixLevel = Item.AffixLevel;
+	Header.StackCount = Item.StackCount;
+	Header.QualityTypeNetIndex = QuantizeGameplayTag(Item.QualityType);
+
+	const FDataTableRowHandle& ItemDefinitionHandle = Item.GetItemDefinitionHandle();
+	const uint32 ItemDefinitionId = Scratch.Registry ? Scratch.Registry->GetItemDefinitionId(ItemDefinitionHandle) : UGenericItemizationDefinitionRegistry::InvalidId;
+	QuantizeDefinitionReference(Scratch, ItemDefinitionId, ItemDefinitionHandle, Header.ItemDefinition);
+
+	Header.FirstAffix = Scratch.Affixes.Num();
+	for (const TInstancedStruct<FAffixInstance>& Affix : Item.Affixes)
+	{
+		if (!Affix.IsValid())
+		{
+			continue;
+		}
+
+		const int32 DerivedElement = Affix.GetScriptStruct() != FAffixInstance::StaticStruct() ? AddDerivedElement(Scratch, Affix.GetScriptStruct(), Affix.GetMemory()) : INDEX_NONE;
+		QuantizeAffix(Scratch, Affix.Get(), DerivedElement, Scratch.Affixes.AddDefaulted_GetRef());
+
+		++Header.NumAffixes;
+	}
+
+	// Reserve a contiguous range for our Sockets before any socketed ItemInstances append their own.
+	Header.FirstSocket = Scratch.Sockets.Num();
+	for (const TInstancedStruct<FItemSocketInstance>& Socket : Item.Sockets)
+	{
+		Header.NumSockets += Socket.IsValid() ? 1 : 0;
+	}
+	Scratch.Sockets.AddZeroed(Header.NumSockets);
+
+	int32 SocketIndex = Header.FirstSocket;
+	for (const TInstancedStruct<FItemSocketInstance>& Socket : Item.Sockets)
+	{
+		if (!Socket.IsValid())
+		{
+			continue;
+		}
+
+		FQuantizedSocket QuantizedSocket;
+		FMemory::Memzero(QuantizedSocket);
+		QuantizedSocket.SocketedItemIndex = INDEX_NONE;
+		QuantizedSocket.SocketedItemDerivedElement = INDEX_NONE;
+		QuantizedSocket.DerivedElement = Socket.GetScriptStruct() != FItemSocketInstance::StaticStruct() ? AddDerivedElement(Scratch, Socket.GetScriptStruct(), Socket.GetMemory()) : INDEX_NONE;
+
+		if (QuantizedSocket.DerivedElement == INDEX_NONE)
+		{
+			const FItemSocketInstance& SocketInstance = Socket.Get();
+
+			QuantizeGuid(SocketInstance.SocketId, QuantizedSocket.SocketId);
+			QuantizedSocket.bIsEmpty = SocketInstance.bIsEmpty ? 1U : 0U;
+			QuantizedSocket.SocketDefinitionId = Scratch.Registry ? Scratch.Registry->GetSocketDefinitionId(SocketInstance.SocketDefinitionHandle) : UGenericItemizationDefinitionRegistry::InvalidId;
+			if (QuantizedSocket.SocketDefinitionId == UGenericItemizationDefinitionRegistry::InvalidId)
+			{
+				QuantizeGuid(SocketInstance.SocketDefinitionHandle, QuantizedSocket.SocketDefinitionHandle);
+			}
+
+			const FConstStructView SocketedItem = SocketInstance.GetSocketedItem();
+			if (SocketedItem.GetScriptStruct() == FItemInstance::StaticStruct())
+			{
+				if (Depth < MaxSocketDepth)
+				{
+					QuantizedSocket.SocketedItemIndex = QuantizeItem(Scratch, SocketedItem.Get<FItemInstance>(), Depth + 1);
+				}
+			}
+			else if (SocketedItem.IsValid())
+			{
+				QuantizedSocket.SocketedItemDerivedElement = AddDerivedElement(Scratch, SocketedItem.GetScriptStruct(), SocketedItem.GetMemory());
+			}
+		}
+
+		Scratch.Sockets[SocketIndex++] = QuantizedSocket;
+	}
+
+	Scratch.Items[ItemIndex] = Header;
+	return ItemIndex;
+}
+
+template<typename ElementType, typename SourceType>
+static void CopyToStorage(FNetSerializationContext& Context, TQuantizedArrayStorage<ElementType>& Storage, const SourceType& Source)
+{
+	Storage.AdjustSize(Context, Source.Num());
+	if (Source.Num() > 0)
+	{
+		FMemory::Memcpy(Storage.GetData(), Source.GetData(), Source.Num() * sizeof(ElementType));
+	}
+}
+
+template<typename ElementType>
+static bool IsStorageEqual(const TQuantizedArrayStorage<ElementType>& A, const TQuantizedArrayStorage<ElementType>& B)
+{
+	return A.Num() == B.Num() && (A.Num() == 0 || FMemory::Memcmp(A.GetData(), B.GetData(), A.Num() * sizeof(ElementType)) == 0);
+}
+
+template<typename ArrayType>
+static bool IsArrayEqual(const ArrayType& A, const ArrayType& B)
+{
+	using ElementType = typename ArrayType::ElementType;
+	return A.Num() == B.Num() && (A.Num() == 0 || FMemory::Memcmp(A.GetData(), B.GetData(), A.Num() * sizeof(ElementType)) == 0);
+}
+
+static bool AreDerivedElementsEqual(const TArray<FItemInstanceNetSerializerDerivedElement>& A, const TArray<FItemInstanceNetSerializerDerivedElement>& B)
+{
+	if (A.Num() != B.Num())
+	{
+		return false;
+	}
+
+	for (int32 ElementIndex = 0; ElementIndex < A.Num(); ++ElementIndex)
+	{
+		if (!(A[ElementIndex].Element == B[ElementIndex].Element))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/************************************************************************/
+/* Object References
+/************************************************************************/
+
+static void QuantizeReferences(FNetSerializationContext& Context, TQuantizedArrayStorage<FNetObjectReference>& Storage, TConstArrayView<const UObject*> Objects)
+{
+	Storage.AdjustSize(Context, Objects.Num());
+
+	const FNetSerializer& ObjectSerializer = UE_NET_GET_SERIALIZER(FObjectNetSerializer);
+	FNetQuantizeArgs QuantizeArgs = {};
+	QuantizeArgs.NetSerializerConfig = UE_NET_GET_SERIALIZER_DEFAULT_CONFIG(FObjectNetSerializer);
+
+	for (int32 ReferenceIndex = 0; ReferenceIndex < Objects.Num(); ++ReferenceIndex)
+	{
+		UObject* Object = const_cast<UObject*>(Objects[ReferenceIndex]);
+		QuantizeArgs.Source = NetSerializerValuePointer(&Object);
+		QuantizeArgs.Target = NetSerializerValuePointer(Storage.GetData() + ReferenceIndex);
+		ObjectSerializer.Quantize(Context, QuantizeArgs);
+	}
+}
+
+/* Resolves the DataTables of the references, any that cannot be resolved or are not a DataTable are left null. */
+static void DequantizeTables(FNetSerializationContext& Context, const TQuantizedArrayStorage<FNetObjectReference>& Storage, FDequantizeScratch& Scratch)
+{
+	const FNetSerializer& ObjectSerializer = UE_NET_GET_SERIALIZER(FObjectNetSerializer);
+	FNetDequantizeArgs DequantizeArgs = {};
+	DequantizeArgs.NetSerializerConfig = UE_NET_GET_SERIALIZER_DEFAULT_CONFIG(FObjectNetSerializer);
+
+	Scratch.Tables.Reset(Storage.Num());
+	for (const FNetObjectReference& Reference : MakeArrayView(Storage.GetData(), Storage.Num()))
+	{
+		UObject* Object = nullptr;
+		DequantizeArgs.Source = NetSerializerValuePointer(&Reference);
+		DequantizeArgs.Target = NetSerializerValuePointer(&Object);
+		ObjectSerializer.Dequantize(Context, DequantizeArgs);
+
+		Scratch.Tables.Add(Cast<UDataTable>(Object));
+	}
+}
+
+static void WriteReferences(FNetSerializationContext& Context, const TQuantizedArrayStorage<FNetObjectReference>& Storage)
+{
+	WritePackedUint32(Context.GetBitStreamWriter(), Storage.Num());
+
+	const FNetSerializer& ObjectSerializer = UE_NET_GET_SERIALIZER(FObjectNetSerializer);
+	FNetSerializeArgs SerializeArgs = {};
+	SerializeArgs.NetSerializerConfig = UE_NET_GET_SERIALIZER_DEFAULT_CONFIG(FObjectNetSerializer);
+
+	for (const FNetObjectReference& Reference : MakeArrayView(Storage.GetData(), Storage.Num()))
+	{
+		SerializeArgs.Source = NetSerializerValuePointer(&Reference);
+		ObjectSerializer.Serialize(Context, SerializeArgs);
+	}
+}
+
+static void ReadReferences(FNetSerializationContext& Context, TQuantizedArrayStorage<FNetObjectReference>& Storage)
+{
+	const uint32 Num = ReadPackedUint32(Context.GetBitStreamReader());
+	if (Num > MaxReferences)
+	{
+		Context.SetError(GNetError_ArraySizeTooLarge);
+		return;
+	}
+
+	Storage.AdjustSize(Context, Num);
+
+	const FNetSerializer& ObjectSerializer = UE_NET_GET_SERIALIZER(FObjectNetSerializer);
+	FNetDeserializeArgs DeserializeArgs = {};
+	DeserializeArgs.NetSerializerConfig = UE_NET_GET_SERIALIZER_DEFAULT_CONFIG(FObjectNetSerializer);
+
+	for (FNetObjectReference& Reference : MakeArrayView(Storage.GetData(), Storage.Num()))
+	{
+		DeserializeArgs.Target = NetSerializerValuePointer(&Reference);
+		ObjectSerializer.Deserialize(Context, DeserializeArgs);
+	}
+}
+
+static bool AreReferencesEqual(const TQuantizedArrayStorage<FNetObjectReference>& A, const TQuantizedArrayStorage<FNetObjectReference>& B)
+{
+	if (A.Num() != B.Num())
+	{
+		return false;
+	}
+
+	for (uint32 ReferenceIndex = 0; ReferenceIndex < static_cast<uint32>(A.Num()); ++ReferenceIndex)
+	{
+		if (!(A.GetData()[ReferenceIndex] == B.GetData()[ReferenceIndex]))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static void CollectReferences(FNetSerializationContext& Context, const FNetCollectReferencesArgs& Args, const TQuantizedArrayStorage<FNetObjectReference>& Storage)
+{
+	const FNetSerializer& ObjectSerializer = UE_NET_GET_SERIALIZER(FObjectNetSerializer);
+	FNetCollectReferencesArgs CollectArgs = Args;
+	CollectArgs.NetSerializerConfig = UE_NET_GET_SERIALIZER_DEFAULT_CONFIG(FObjectNetSerializer);
+
+	for (const FNetObjectReference& Reference : MakeArrayView(Storage.GetData(), Storage.Num()))
+	{
+		CollectArgs.Source = NetSerializerValuePointer(&Reference);
+		ObjectSerializer.CollectNetReferences(Context, CollectArgs);
+	}
+}
+
+/************************************************************************/
+/* Derived Elements
+/************************************************************************/
+
+static uint32 GetNumDerivedElements(const TQuantizedArrayStorage<FQuantizedStateBlock>& Storage)
+{
+	return Storage.Num() > 0 ? Storage.Num() / FDerivedElementSerializer::Get().BlocksPerElement : 0;
+}
+
+static NetSerializerValuePointer GetDerivedElement(const TQuantizedArrayStorage<FQuantizedStateBlock>& Storage, uint32 ElementIndex)
+{
+	return NetSerializerValuePointer(Storage.GetData() + ElementIndex * FDerivedElementSerializer::Get().BlocksPerElement);
+}
+
+/* Frees the dynamic state held by each derived element, as well as the Storage itself. */
+static void FreeDerivedElements(FNetSerializationContext& Context, TQuantizedArrayStorage<FQuantizedStateBlock>& Storage)
+{
+	const uint32 NumElements = GetNumDerivedElements(Storage);
+	if (NumElements > 0 && FDerivedElementSerializer::Get().bHasDynamicState)
+	{
+		const FDerivedElementSerializer& DerivedElementSerializer = FDerivedElementSerializer::Get();
+		FNetFreeDynamicStateArgs FreeArgs = {};
+		FreeArgs.NetSerializerConfig = NetSerializerConfigParam(&DerivedElementSerializer.Config);
+
+		for (uint32 ElementIndex = 0; ElementIndex < NumElements; ++ElementIndex)
+		{
+			FreeArgs.Source = GetDerivedElement(Storage, ElementIndex);
+			FDerivedElementSerializer::GetSerializer().FreeDynamicState(Context, FreeArgs);
+		}
+	}
+
+	Storage.Free(Context);
+}
+
+/* Replaces the derived elements with NumElements zeroed ones, ready to be quantized or deserialized into. */
+static void ResetDerivedElements(FNetSerializationContext& Context, TQuantizedArrayStorage<FQuantizedStateBlock>& Storage, uint32 NumElements)
+{
+	FreeDerivedElements(Context, Storage);
+	if (NumElements > 0)
+	{
+		Storage.AdjustSize(Context, NumElements * FDerivedElementSerializer::Get().BlocksPerElement);
+		FMemory::Memzero(Storage.GetData(), Storage.Num() * sizeof(FQuantizedStateBlock));
+	}
+}
+
+/* Clones Source into a Target that holds no dynamic state of its own, such as one that is a bitwise copy of Source. */
+static void CloneDerivedElements(FNetSerializationContext& Context, TQuantizedArrayStorage<FQuantizedStateBlock>& Target, const TQuantizedArrayStorage<FQuantizedStateBlock>& Source)
+{
+	Target.Clone(Context, Source);
+
+	const uint32 NumElements = GetNumDerivedElements(Source);
+	if (NumElements > 0 && FDerivedElementSerializer::Get().bHasDynamicState)
+	{
+		const FDerivedElementSerializer& DerivedElementSerializer = FDerivedElementSerializer::Get();
+		FNetCloneDynamicStateArgs CloneArgs = {};
+		CloneArgs.NetSerializerConfig = NetSerializerConfigParam(&DerivedElementSerializer.Config);
+
+		for (uint32 ElementIndex = 0; ElementIndex < NumElements; ++ElementIndex)
+		{
+			CloneArgs.Source = GetDerivedElement(Source, ElementIndex);
+			CloneArgs.Target = GetDerivedElement(Target, ElementIndex);
+			FDerivedElementSerializer::GetSerializer().CloneDynamicState(Context, CloneArgs);
+		}
+	}
+}
+
+static void QuantizeDerivedElements(FNetSerializationContext& Context, TQuantizedArrayStorage<FQuantizedStateBlock>& Storage, const TArray<FItemInstanceNetSerializerDerivedElement>& DerivedElements)
+{
+	ResetDerivedElements(Context, Storage, DerivedElements.Num());
+	if (DerivedElements.Num() == 0)
+	{
+		return;
+	}
+
+	const FDerivedElementSerializer& DerivedElementSerializer = FDerivedElementSerializer::Get();
+	FNetQuantizeArgs QuantizeArgs = {};
+	QuantizeArgs.NetSerializerConfig = NetSerializerConfigParam(&DerivedElementSerializer.Config);
+
+	for (int32 ElementIndex = 0; ElementIndex < DerivedElements.Num(); ++ElementIndex)
+	{
+		QuantizeArgs.Source = NetSerializerValuePointer(&DerivedElements[ElementIndex]);
+		QuantizeArgs.Target = GetDerivedElement(Storage, ElementIndex);
+		FDerivedElementSerializer::GetSerializer().Quantize(Context, QuantizeArgs);
+	}
+}
+
+/* Dequantizes a derived element, returns an empty struct if it is not of a type derived from BaseStruct. */
+static FInstancedStruct DequantizeDerivedElement(FNetSerializationContext& Context, const TQuantizedArrayStorage<FQuantizedStateBlock>& Storage, int32 ElementIndex, const UScriptStruct* BaseStruct)
+{
+	FItemInstanceNetSerializerDerivedElement DerivedElement;
+
+	const FDerivedElementSerializer& DerivedElementSerializer = FDerivedElementSerializer::Get();
+	FNetDequantizeArgs DequantizeArgs = {};
+	DequantizeArgs.NetSerializerConfig = NetSerializerConfigParam(&DerivedElementSerializer.Config);
+	DequantizeArgs.Source = GetDerivedElement(Storage, ElementIndex);
+	DequantizeArgs.Target = NetSerializerValuePointer(&DerivedElement);
+	FDerivedElementSerializer::GetSerializer().Dequantize(Context, DequantizeArgs);
+
+	const UScriptStruct* ScriptStruct = DerivedElement.Element.GetScriptStruct();
+	return ScriptStruct && ScriptStruct->IsChildOf(BaseStruct) ? MoveTemp(DerivedElement.Element) : FInstancedStruct();
+}
+
+static void WriteDerivedElements(FNetSerializationContext& Context, const TQuantizedArrayStorage<FQuantizedStateBlock>& Storage)
+{
+	const uint32 NumElements = GetNumDerivedElements(Storage);
+	WritePackedUint32(Context.GetBitStreamWriter(), NumElements);
+	if (NumElements == 0)
+	{
+		return;
+	}
+
+	const FDerivedElementSerializer& DerivedElementSerializer = FDerivedElementSerializer::Get();
+	FNetSerializeArgs SerializeArgs = {};
+	SerializeArgs.NetSerializerConfig = NetSerializerConfigParam(&DerivedElementSerializer.Config);
+
+	for (uint32 ElementIndex = 0; ElementIndex < NumElements; ++ElementIndex)
+	{
+		SerializeArgs.Source = GetDerivedElement(Storage, ElementIndex);
+		FDerivedElementSerializer::GetSerializer().Serialize(Context, SerializeArgs);
+	}
+}
+
+static void ReadDerivedElements(FNetSerializationContext& Context, TQuantizedArrayStorage<FQuantizedStateBlock>& Storage)
+{
+	const uint32 NumElements = ReadPackedUint32(Context.GetBitStreamReader());
+	if (NumElements > MaxDerivedElements)
+	{
+		Context.SetError(GNetError_ArraySizeTooLarge);
+		return;
+	}
+
+	ResetDerivedElements(Context, Storage, NumElements);
+	if (NumElements == 0)
+	{
+		return;
+	}
+
+	const FDerivedElementSerializer& DerivedElementSerializer = FDerivedElementSerializer::Get();
+	FNetDeserializeArgs DeserializeArgs = {};
+	DeserializeArgs.NetSerializerConfig = NetSerializerConfigParam(&DerivedElementSerializer.Config);
+
+	for (uint32 ElementIndex = 0; ElementIndex < NumElements && !Context.HasErrorOrOverflow(); ++ElementIndex)
+	{
+		DeserializeArgs.Target = GetDerivedElement(Storage, ElementIndex);
+		FDerivedElementSerializer::GetSerializer().Deserialize(Context, DeserializeArgs);
+	}
+}
+
+static bool AreDerivedElementsEqual(FNetSerializationContext& Context, const TQuantizedArrayStorage<FQuantizedStateBlock>& A, const TQuantizedArrayStorage<FQuantizedStateBlock>& B)
+{
+	if (A.Num() != B.Num())
+	{
+		return false;
+	}
+
+	const uint32 NumElements = GetNumDerivedElements(A);
+	if (NumElements == 0)
+	{
+		return true;
+	}
+
+	const FDerivedElementSerializer& DerivedElementSerializer = FDerivedElementSerializer::Get();
+	FNetIsEqualArgs IsEqualArgs = {};
+	IsEqualArgs.NetSerializerConfig = NetSerializerConfigParam(&DerivedElementSerializer.Config);
+	IsEqualArgs.bStateIsQuantized = true;
+
+	for (uint32 ElementIndex = 0; ElementIndex < NumElements; ++ElementIndex)
+	{
+		IsEqualArgs.Source0 = GetDerivedElement(A, ElementIndex);
+		IsEqualArgs.Source1 = GetDerivedElement(B, ElementIndex);
+		if (!FDerivedElementSerializer::GetSerializer().IsEqual(Context, IsEqualArgs))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static void CollectDerivedElementReferences(FNetSerializationContext& Context, const FNetCollectReferencesArgs& Args, const TQuantizedArrayStorage<FQuantizedStateBlock>& Storage)
+{
+	const uint32 NumElements = GetNumDerivedElements(Storage);
+	if (NumElements == 0 || !FDerivedElementSerializer::Get().bHasObjectReference)
+	{
+		return;
+	}
+
+	const FDerivedElementSerializer& DerivedElementSerializer = FDerivedElementSerializer::Get();
+	FNetCollectReferencesArgs CollectArgs = Args;
+	CollectArgs.NetSerializerConfig = NetSerializerConfigParam(&DerivedElementSerializer.Config);
+
+	for (uint32 ElementIndex = 0; ElementIndex < NumElements; ++ElementIndex)
+	{
+		CollectArgs.Source = GetDerivedElement(Storage, ElementIndex);
+		FDerivedElementSerializer::GetSerializer().CollectNetReferences(Context, CollectArgs);
+	}
+}
+
+/************************************************************************/
+/* Bitstream
+/************************************************************************/
+
+static void WriteGuid(FNetBitStreamWriter* Writer, const uint32 (&Guid)[4])
+{
+	for (const uint32 Part : Guid)
+	{
+		Writer->WriteBits(Part, 32U);
+	}
+}
+
+static void ReadGuid(FNetBitStreamReader* Reader, uint32 (&OutGuid)[4])
+{
+	for (uint32& Part : OutGuid)
+	{
+		Part = Reader->ReadBits(32U);
+	}
+}
+
+static void WriteDefinitionReference(FNetBitStreamWriter* Writer, const FQuantizedDefinitionReference& Reference)
+{
+	if (Writer->WriteBool(Reference.Id != UGenericItemizationDefinitionRegistry::InvalidId))
+	{
+		WritePackedUint32(Writer, Reference.Id);
+	}
+	else if (Writer->WriteBool(Reference.TableIndex != INDEX_NONE))
+	{
+		WritePackedUint32(Writer, static_cast<uint32>(Reference.TableIndex));
+		WritePackedUint32(Writer, Reference.RowNameOffset);
+		WritePackedUint32(Writer, Reference.RowNameLength);
+	}
+}
+
+static void ReadDefinitionReference(FNetBitStreamReader* Reader, FQuantizedDefinitionReference& OutReference)
+{
+	FMemory::Memzero(OutReference);
+	OutReference.TableIndex = INDEX_NONE;
+
+	if (Reader->ReadBool())
+	{
+		OutReference.Id = ReadPackedUint32(Reader);
+	}
+	else if (Reader->ReadBool())
+	{
+		OutReference.TableIndex = static_cast<int32>(ReadPackedUint32(Reader));
+		OutReference.RowNameOffset = ReadPackedUint32(Reader);
+		OutReference.RowNameLength = ReadPackedUint32(Reader);
+	}
+}
+
+static void WriteItemHeader(FNetBitStreamWriter* Writer, const FQuantizedItemHeader& Header)
+{
+	WriteGuid(Writer, Header.ItemId);
+	Writer->WriteBits(static_cast<uint32>(Header.ItemSeed), 32U);
+	Writer->WriteBits(static_cast<uint32>(Header.ItemStreamSeed), 32U);
+	WritePackedInt32(Writer, Header.ItemLevel);
+	WritePackedInt32(Writer, Header.AffixLevel);
+	WritePackedInt32(Writer, Header.StackCount);
+	WritePackedUint32(Writer, Header.QualityTypeNetIndex);
+	WriteDefinitionReference(Writer, Header.ItemDefinition);
+	WritePackedUint32(Writer, Header.FirstAffix);
+	WritePackedUint32(Writer, Header.NumAffixes);
+	WritePackedUint32(Writer, Header.FirstSocket);
+	WritePackedUint32(Writer, Header.NumSockets);
+}
+
+static void ReadItemHeader(FNetBitStreamReader* Reader, FQuantizedItemHeader& OutHeader)
+{
+	FMemory::Memzero(OutHeader);
+	ReadGuid(Reader, OutHeader.ItemId);
+	OutHeader.ItemSeed = static_cast<int32>(Reader->ReadBits(32U));
+	OutHeader.ItemStreamSeed = static_cast<int32>(Reader->ReadBits(32U));
+	OutHeader.ItemLevel = ReadPackedInt32(Reader);
+	OutHeader.AffixLevel = ReadPackedInt32(Reader);
+	OutHeader.StackCount = ReadPackedInt32(Reader);
+	OutHeader.QualityTypeNetIndex = ReadPackedUint32(Reader);
+	ReadDefinitionReference(Reader, OutHeader.ItemDefinition);
+	OutHeader.FirstAffix = ReadPackedUint32(Reader);
+	OutHeader.NumAffixes = ReadPackedUint32(Reader);
+	OutHeader.FirstSocket = ReadPackedUint32(Reader);
+	OutHeader.NumSockets = ReadPackedUint32(Reader);
+}
+
+static void WriteAffix(FNetBitStreamWriter* Writer, const FQuantizedAffix& Affix)
+{
+	// A derived element carries everything else about the AffixInstance.
+	if (Writer->WriteBool(Affix.DerivedElement != INDEX_NONE))
+	{
+		WritePackedUint32(Writer, static_cast<uint32>(Affix.DerivedElement));
+		return;
+	}
+
+	Writer->WriteBool(Affix.bPredefinedAffix != 0);
+	WriteDefinitionReference(Writer, Affix.AffixDefinition);
+}
+
+static void ReadAffix(FNetBitStreamReader* Reader, FQuantizedAffix& OutAffix)
+{
+	FMemory::Memzero(OutAffix);
+	OutAffix.AffixDefinition.TableIndex = INDEX_NONE;
+	OutAffix.DerivedElement = INDEX_NONE;
+
+	if (Reader->ReadBool())
+	{
+		OutAffix.DerivedElement = static_cast<int32>(ReadPackedUint32(Reader));
+		return;
+	}
+
+	OutAffix.bPredefinedAffix = Reader->ReadBool() ? 1U : 0U;
+	ReadDefinitionReference(Reader, OutAffix.AffixDefinition);
+}
+
+static void WriteSocket(FNetBitStreamWriter* Writer, const FQuantizedSocket& Socket)
+{
+	// A derived element carries everything else about the SocketInstance.
+	if (Writer->WriteBool(Socket.DerivedElement != INDEX_NONE))
+	{
+		WritePackedUint32(Writer, static_cast<uint32>(Socket.DerivedElement));
+		return;
+	}
+
+	WriteGuid(Writer, Socket.SocketId);
+	Writer->WriteBool(Socket.bIsEmpty != 0);
+	if (Writer->WriteBool(Socket.SocketDefinitionId != UGenericItemizationDefinitionRegistry::InvalidId))
+	{
+		WritePackedUint32(Writer, Socket.SocketDefinitionId);
+	}
+	else
+	{
+		WriteGuid(Writer, Socket.SocketDefinitionHandle);
+	}
+	WritePackedInt32(Writer, Socket.SocketedItemIndex);
+	WritePackedInt32(Writer, Socket.SocketedItemDerivedElement);
+}
+
+static void ReadSocket(FNetBitStreamReader* Reader, FQuantizedSocket& OutSocket)
+{
+	FMemory::Memzero(OutSocket);
+	OutSocket.SocketedItemIndex = INDEX_NONE;
+	OutSocket.SocketedItemDerivedElement = INDEX_NONE;
+	OutSocket.DerivedElement = INDEX_NONE;
+
+	if (Reader->ReadBool())
+	{
+		OutSocket.DerivedElement = static_cast<int32>(ReadPackedUint32(Reader));
+		return;
+	}
+
+	ReadGuid(Reader, OutSocket.SocketId);
+	OutSocket.bIsEmpty = Reader->ReadBool() ? 1U : 0U;
+	if (Reader->ReadBool())
+	{
+		OutSocket.SocketDefinitionId = ReadPackedUint32(Reader);
+	}
+	else
+	{
+		ReadGuid(Reader, OutSocket.SocketDefinitionHandle);
+	}
+	OutSocket.SocketedItemIndex = ReadPackedInt32(Reader);
+	OutSocket.SocketedItemDerivedElement = ReadPackedInt32(Reader);
+}
+
+template<typename ElementType, typename WriteFunctionType>
+static void WriteStorage(FNetBitStreamWriter* Writer, const TQuantizedArrayStorage<ElementType>& Storage, WriteFunctionType WriteElement)
+{
+	WritePackedUint32(Writer, Storage.Num());
+	for (const ElementType& Element : MakeArrayView(Storage.GetData(), Storage.Num()))
+	{
+		WriteElement(Writer, Element);
+	}
+}
+
+template<typename ElementType, typename ReadFunctionType>
+static void ReadStorage(FNetSerializationContext& Context, TQuantizedArrayStorage<ElementType>& Storage, uint32 MaxNum, ReadFunctionType ReadElement)
+{
+	FNetBitStreamReader* Reader = Context.GetBitStreamReader();
+
+	const uint32 Num = ReadPackedUint32(Reader);
+	if (Num > MaxNum)
+	{
+		Context.SetError(GNetError_ArraySizeTooLarge);
+		return;
+	}
+
+	Storage.AdjustSize(Context, Num);
+	for (ElementType& Element : MakeArrayView(Storage.GetData(), Storage.Num()))
+	{
+		ReadElement(Reader, Element);
+	}
+}
+
+static void WriteStringByte(FNetBitStreamWriter* Writer, const uint8& Byte)
+{
+	Writer->WriteBits(Byte, 8U);
+}
+
+static void ReadStringByte(FNetBitStreamReader* Reader, uint8& OutByte)
+{
+	OutByte = static_cast<uint8>(Reader->ReadBits(8U));
+}
+
+/* Writes the Storage if it differs from Prev, otherwise only a single bit. */
+template<typename ElementType, typename WriteFunctionType>
+static void WriteStorageDelta(FNetBitStreamWriter* Writer, const TQuantizedArrayStorage<ElementType>& Storage, const TQuantizedArrayStorage<ElementType>& PrevStorage, WriteFunctionType WriteElement)
+{
+	if (Writer->WriteBool(!IsStorageEqual(Storage, PrevStorage)))
+	{
+		WriteStorage(Writer, Storage, WriteElement);
+	}
+}
+
+template<typename ElementType, typename ReadFunctionType>
+static void ReadStorageDelta(FNetSerializationContext& Context, TQuantizedArrayStorage<ElementType>& Storage, const TQuantizedArrayStorage<ElementType>& PrevStorage, uint32 MaxNum, ReadFunctionType ReadElement)
+{
+	if (Context.GetBitStreamReader()->ReadBool())
+	{
+		ReadStorage(Context, Storage, MaxNum, ReadElement);
+	}
+	else
+	{
+		CopyToStorage(Context, Storage, MakeArrayView(PrevStorage.GetData(), PrevStorage.Num()));
+	}
+}
+
+static bool IsDefinitionReferenceValid(const FQuantizedDefinitionReference& Reference, uint32 NumReferences, uint32 NumStrings)
+{
+	if (Reference.TableIndex == INDEX_NONE)
+	{
+		return Reference.RowNameLength == 0;
+	}
+
+	return Reference.TableIndex >= 0 && static_cast<uint32>(Reference.TableIndex) < NumReferences
+		&& Reference.RowNameLength <= NumStrings && Reference.RowNameOffset <= NumStrings - Reference.RowNameLength;
+}
+
+static bool IsDerivedElementIndexValid(int32 ElementIndex, uint32 NumDerivedElements)
+{
+	return ElementIndex == INDEX_NONE || (ElementIndex >= 0 && static_cast<uint32>(ElementIndex) < NumDerivedElements);
+}
+
+}
+
+namespace UE::Net
+{
+
+using namespace GenericItemizationPrivate;
+
+/************************************************************************/
+/* FItemInstanceNetSerializer
+/************************************************************************/
+
+/**
+ * Iris NetSerializer for FItemInstance.
+ *
+ * The ItemInstance and every ItemInstance socketed into it are flattened into arrays of fixed size records, which makes the
+ * quantized state cheap to compare. Definitions are sent as their Definition Registry Ids where possible, any others are sent
+ * as an object reference to their DataTable and their RowName.
+ * AffixInstances, SocketInstances and socketed ItemInstances whose type derives from the base type are replicated whole through
+ * the descriptor of FInstancedStruct instead, so they keep their type and members.
+ */
+struct FItemInstanceNetSerializer
+{
+	static const uint32 Version = 1;
+	static constexpr bool bHasDynamicState = true;
+	static constexpr bool bHasCustomNetReference = true;
+
+	struct FQuantizedType
+	{
+		TQuantizedArrayStorage<FQuantizedItemHeader> Items;
+		TQuantizedArrayStorage<FQuantizedAffix> Affixes;
+		TQuantizedArrayStorage<FQuantizedSocket> Sockets;
+		TQuantizedArrayStorage<uint8> Strings;
+		TQuantizedArrayStorage<FNetObjectReference> References;
+		TQuantizedArrayStorage<FQuantizedStateBlock> DerivedElements;
+	};
+
+	typedef FItemInstance SourceType;
+	typedef FQuantizedType QuantizedType;
+	typedef FItemInstanceNetSerializerConfig ConfigType;
+
+	static const ConfigType DefaultConfig;
+
+	static void Serialize(FNetSerializationContext& Context, const FNetSerializeArgs& Args);
+	static void Deserialize(FNetSerializationContext& Context, const FNetDeserializeArgs& Args);
+
+	static void SerializeDelta(FNetSerializationContext& Context, const FNetSerializeDeltaArgs& Args);
+	static void DeserializeDelta(FNetSerializationContext& Context, const FNetDeserializeDeltaArgs& Args);
+
+	static void Quantize(FNetSerializationContext& Context, const FNetQuantizeArgs& Args);
+	static void Dequantize(FNetSerializationContext& Context, const FNetDequantizeArgs& Args);
+
+	static bool IsEqual(FNetSerializationContext& Context, const FNetIsEqualArgs& Args);
+	static bool Validate(FNetSerializationContext& Context, const FNetValidateArgs& Args);
+
+	static void CloneDynamicState(FNetSerializationContext& Context, const FNetCloneDynamicStateArgs& Args);
+	static void FreeDynamicState(FNetSerializationContext& Context, const FNetFreeDynamicStateArgs& Args);
+
+	static void CollectNetReferences(FNetSerializationContext& Context, const FNetCollectReferencesArgs& Args);
+
+private:
+
+	/* Checks that every index in the quantized state refers to valid data, so Dequantize never has to. */
+	static bool IsQuantizedStateValid(const QuantizedType& Value);
+
+	static void DequantizeItem(FNetSerializationContext& Context, const QuantizedType& Value, const FDequantizeScratch& Scratch, int32 ItemIndex, FItemInstance& OutItem);
+};
+
+UE_NET_IMPLEMENT_SERIALIZER(FItemInstanceNetSerializer);
+
+const FItemInstanceNetSerializer::ConfigType FItemInstanceNetSerializer::DefaultConfig;
+
+void FItemInstanceNetSerializer::Serialize(FNetSerializationContext& Context, const FNetSerializeArgs& Args)
+{
+	const QuantizedType& Value = *reinterpret_cast<const QuantizedType*>(Args.Source);
+	FNetBitStreamWriter* Writer = Context.GetBitStreamWriter();
+
+	WriteStorage(Writer, Value.Items, &WriteItemHeader);
+	WriteStorage(Writer, Value.Affixes, &WriteAffix);
+	WriteStorage(Writer, Value.Sockets, &WriteSocket);
+	WriteStorage(Writer, Value.Strings, &WriteStringByte);
+	WriteReferences(Context, Value.References);
+	WriteDerivedElements(Context, Value.DerivedElements);
+}
+
+void FItemInstanceNetSerializer::Deserialize(FNetSerializationContext& Context, const FNetDeserializeArgs& Args)
+{
+	QuantizedType& Target = *reinterpret_cast<QuantizedType*>(Args.Target);
+
+	ReadStorage(Context, Target.Items, MaxItems, &ReadItemHeader);
+	ReadStorage(Context, Target.Affixes, MaxAffixes, &ReadAffix);
+	ReadStorage(Context, Target.Sockets, MaxSockets, &ReadSocket);
+	ReadStorage(Context, Target.Strings, MaxStringBytes, &ReadStringByte);
+	ReadReferences(Context, Target.References);
+	ReadDerivedElements(Context, Target.DerivedElements);
+
+	if (!Context.HasErrorOrOverflow() && !IsQuantizedStateValid(Target))
+	{
+		Context.SetError(GNetError_InvalidValue);
+	}
+}
+
+void FItemInstanceNetSerializer::SerializeDelta(FNetSerializationContext& Context, const FNetSerializeDeltaArgs& Args)
+{
+	const QuantizedType& Value = *reinterpret_cast<const QuantizedType*>(Args.Source);
+	const QuantizedType& PrevValue = *reinterpret_cast<const QuantizedType*>(Args.Prev);
+	FNetBitStreamWriter* Writer = Context.GetBitStreamWriter();
+
+	// Items are delta'd individually, the common case is a single changed property such as the StackCount.
+	if (!Writer->WriteBool(Value.Items.Num() == PrevValue.Items.Num()))
+	{
+		WritePackedUint32(Writer, Value.Items.Num());
+	}
+
+	for (uint32 ItemIndex = 0; ItemIndex < static_cast<uint32>(Value.Items.Num()); ++ItemIndex)
+	{
+		const FQuantizedItemHeader& Header = Value.Items.GetData()[ItemIndex];
+		if (ItemIndex < static_cast<uint32>(PrevValue.Items.Num()))
+		{
+			const FQuantizedItemHeader& PrevHeader = PrevValue.Items.GetData()[ItemIndex];
+			if (!Writer->WriteBool(FMemory::Memcmp(&Header, &PrevHeader, sizeof(FQuantizedItemHeader)) != 0))
+			{
+				continue;
+			}
+		}
+
+		WriteItemHeader(Writer, Header);
+	}
+
+	WriteStorageDelta(Writer, Value.Affixes, PrevValue.Affixes, &WriteAffix);
+	WriteStorageDelta(Writer, Value.Sockets, PrevValue.Sockets, &WriteSocket);
+	WriteStorageDelta(Writer, Value.Strings, PrevValue.Strings, &WriteStringByte);
+
+	if (Writer->WriteBool(!AreReferencesEqual(Value.References, PrevValue.References)))
+	{
+		WriteReferences(Context, Value.References);
+	}
+
+	if (Writer->WriteBool(!AreDerivedElementsEqual(Context, Value.DerivedElements, PrevValue.DerivedElements)))
+	{
+		WriteDerivedElements(Context, Value.DerivedElements);
+	}
+}
+
+void FItemInstanceNetSerializer::DeserializeDelta(FNetSerializationContext& Context, const FNetDeserializeDeltaArgs& Args)
+{
+	QuantizedType& Target = *reinterpret_cast<QuantizedType*>(Args.Target);
+	const QuantizedType& PrevValue = *reinterpret_cast<const QuantizedType*>(Args.Prev);
+	FNetBitStreamReader* Reader = Context.GetBitStreamReader();
+
+	uint32 NumItems = PrevValue.Items.Num();
+	if (!Reader->ReadBool())
+	{
+		NumItems = ReadPackedUint32(Reader);
+		if (NumItems > MaxItems)
+		{
+			Context.SetError(GNetError_ArraySizeTooLarge);
+			return;
+		}
+	}
+
+	Target.Items.AdjustSize(Context, NumItems);
+	for (uint32 ItemIndex = 0; ItemIndex < NumItems; ++ItemIndex)
+	{
+		FQuantizedItemHeader& Header = Target.Items.GetData()[ItemIndex];
+		if (ItemIndex < static_cast<uint32>(PrevValue.Items.Num()) && !Reader->ReadBool())
+		{
+			Header = PrevValue.Items.GetData()[ItemIndex];
+			continue;
+		}
+
+		ReadItemHeader(Reader, Header);
+	}
+
+	ReadStorageDelta(Context, Target.Affixes, PrevValue.Affixes, MaxAffixes, &ReadAffix);
+	ReadStorageDelta(Context, Target.Sockets, PrevValue.Sockets, MaxSockets, &ReadSocket);
+	ReadStorageDelta(Context, Target.Strings, PrevValue.Strings, MaxStringBytes, &ReadStringByte);
+
+	if (Reader->ReadBool())
+	{
+		ReadReferences(Context, Target.References);
+	}
+	else
+	{
+		CopyToStorage(Context, Target.References, MakeArrayView(PrevValue.References.GetData(), PrevValue.References.Num()));
+	}
+
+	if (Reader->ReadBool())
+	{
+		ReadDerivedElements(Context, Target.DerivedElements);
+	}
+	else
+	{
+		FreeDerivedElements(Context, Target.DerivedElements);
+		CloneDerivedElements(Context, Target.DerivedElements, PrevValue.DerivedElements);
+	}
+
+	if (!Context.HasErrorOrOverflow() && !IsQuantizedStateValid(Target))
+	{
+		Context.SetError(GNetError_InvalidValue);
+	}
+}
+
+void FItemInstanceNetSerializer::Quantize(FNetSerializationContext& Context, const FNetQuantizeArgs& Args)
+{
+	const SourceType& Source = *reinterpret_cast<const SourceType*>(Args.Source);
+	QuantizedType& Target = *reinterpret_cast<QuantizedType*>(Args.Target);
+
+	FQuantizeScratch Scratch;
+	QuantizeItem(Scratch, Source, 0);
+
+	CopyToStorage(Context, Target.Items, Scratch.Items);
+	CopyToStorage(Context, Target.Affixes, Scratch.Affixes);
+	CopyToStorage(Context, Target.Sockets, Scratch.Sockets);
+	CopyToStorage(Context, Target.Strings, Scratch.Strings);
+	QuantizeReferences(Context, Target.References, Scratch.Tables);
+	QuantizeDerivedElements(Context, Target.DerivedElements, Scratch.DerivedElements);
+}
+
+void FItemInstanceNetSerializer::Dequantize(FNetSerializationContext& Context, const FNetDequantizeArgs& Args)
+{
+	const QuantizedType& Source = *reinterpret_cast<const QuantizedType*>(Args.Source);
+	SourceType& Target = *reinterpret_cast<SourceType*>(Args.Target);
+
+	if (Source.Items.Num() == 0)
+	{
+		Target = FItemInstance();
+		return;
+	}
+
+	FDequantizeScratch Scratch;
+	Scratch.Strings = Source.Strings.GetData();
+	Scratch.Registry = UGenericItemizationDefinitionRegistry::Get();
+	DequantizeTables(Context, Source.References, Scratch);
+
+	DequantizeItem(Context, Source, Scratch, 0, Target);
+}
+
+void FItemInstanceNetSerializer::DequantizeItem(FNetSerializationContext& Context, const QuantizedType& Value, const FDequantizeScratch& Scratch, int32 ItemIndex, FItemInstance& OutItem)
+{
+	const FQuantizedItemHeader& Header = Value.Items.GetData()[ItemIndex];
+
+	OutItem.ItemId = DequantizeGuid(Header.ItemId);
+	OutItem.ItemSeed = Header.ItemSeed;
+	OutItem.ItemStream.Initialize(Header.ItemStreamSeed);
+	OutItem.ItemLevel = Header.ItemLevel;
+	OutItem.AffixLevel = Header.AffixLevel;
+	OutItem.StackCount = Header.StackCount;
+	OutItem.QualityType = DequantizeGameplayTag(Header.QualityTypeNetIndex);
+
+	FDataTableRowHandle ItemDefinitionHandle;
+	const FItemDefinitionEntry* ItemDefinitionEntry = Header.ItemDefinition.Id != UGenericItemizationDefinitionRegistry::InvalidId && Scratch.Registry ? Scratch.Registry->FindItemDefinition(Header.ItemDefinition.Id, ItemDefinitionHandle) : nullptr;
+	if (ItemDefinitionEntry)
+	{
+		OutItem.SetItemDefinition(ItemDefinitionHandle, ItemDefinitionEntry->ItemDefinition);
+	}
+	else
+	{
+		OutItem.SetItemDefinition(DequantizeDefinitionReference(Header.ItemDefinition, Scratch));
+	}
+
+	OutItem.Affixes.Empty(Header.NumAffixes);
+	for (const FQuantizedAffix& QuantizedAffix : MakeArrayView(Value.Affixes.GetData() + Header.FirstAffix, Header.NumAffixes))
+	{
+		TInstancedStruct<FAffixInstance> Affix;
+		if (QuantizedAffix.DerivedElement != INDEX_NONE)
+		{
+			const FInstancedStruct DerivedAffix = DequantizeDerivedElement(Context, Value.DerivedElements, QuantizedAffix.DerivedElement, FAffixInstance::StaticStruct());
+			if (!DerivedAffix.IsValid())
+			{
+				continue;
+			}
+
+			// The AffixDefinition is not replicated, so it is resolved from the replicated handle.
+			Affix.InitializeAsScriptStruct(DerivedAffix.GetScriptStruct(), DerivedAffix.GetMemory());
+			FAffixInstance& AffixInstance = Affix.GetMutable();
+			AffixInstance.SetAffixDefinition(AffixInstance.GetAffixDefinitionHandle());
+		}
+		else
+		{
+			Affix = TInstancedStruct<FAffixInstance>::Make();
+			DequantizeAffix(QuantizedAffix, Scratch, Affix.GetMutable());
+		}
+
+		OutItem.Affixes.Add(MoveTemp(Affix));
+	}
+
+	OutItem.Sockets.Empty(Header.NumSockets);
+	for (const FQuantizedSocket& QuantizedSocket : MakeArrayView(Value.Sockets.GetData() + Header.FirstSocket, Header.NumSockets))
+	{
+		TInstancedStruct<FItemSocketInstance> Socket;
+		if (QuantizedSocket.DerivedElement != INDEX_NONE)
+		{
+			const FInstancedStruct DerivedSocket = DequantizeDerivedElement(Context, Value.DerivedElements, QuantizedSocket.DerivedElement, FItemSocketInstance::StaticStruct());
+			if (!DerivedSocket.IsValid())
+			{
+				continue;
+			}
+
+			Socket.InitializeAsScriptStruct(DerivedSocket.GetScriptStruct(), DerivedSocket.GetMemory());
+			OutItem.AddSocket(Socket);
+			continue;
+		}
+
+		Socket = TInstancedStruct<FItemSocketInstance>::Make();
+		FItemSocketInstance& SocketInstance = Socket.GetMutable();
+		SocketInstance.SocketId = DequantizeGuid(QuantizedSocket.SocketId);
+		SocketInstance.bIsEmpty = QuantizedSocket.bIsEmpty != 0;
+
+		if (QuantizedSocket.SocketDefinitionId != UGenericItemizationDefinitionRegistry::InvalidId)
+		{
+			// SocketDefinitionHandles are generated per process, so we remap to the handle of our local copy of the SocketDefinition.
+			const FItemSocketDefinition* SocketDefinition = Scratch.Registry ? Scratch.Registry->FindSocketDefinition(QuantizedSocket.SocketDefinitionId) : nullptr;
+			SocketInstance.SocketDefinitionHandle = SocketDefinition ? SocketDefinition->SocketDefinitionHandle : FGuid();
+		}
+		else
+		{
+			SocketInstance.SocketDefinitionHandle = DequantizeGuid(QuantizedSocket.SocketDefinitionHandle);
+		}
+
+		if (QuantizedSocket.SocketedItemIndex != INDEX_NONE)
+		{
+			FItemInstance SocketedItem;
+			DequantizeItem(Context, Value, Scratch, QuantizedSocket.SocketedItemIndex, SocketedItem);
+			SocketInstance.SocketedItemInstance.InitializeAs<FItemInstance>(MoveTemp(SocketedItem));
+		}
+		else if (QuantizedSocket.SocketedItemDerivedElement != INDEX_NONE)
+		{
+			SocketInstance.SocketedItemInstance = DequantizeDerivedElement(Context, Value.DerivedElements, QuantizedSocket.SocketedItemDerivedElement, FItemInstance::StaticStruct());
+			if (FItemInstance* SocketedItem = SocketInstance.SocketedItemInstance.GetMutablePtr<FItemInstance>())
+			{
+				// The ItemDefinition is not replicated, so it is resolved from the replicated handle.
+				SocketedItem->SetItemDefinition(SocketedItem->GetItemDefinitionHandle());
+			}
+		}
+		else
+		{
+			SocketInstance.SocketedItemInstance.Reset();
+		}
+
+		OutItem.AddSocket(Socket);
+	}
+}
+
+bool FItemInstanceNetSerializer::IsQuantizedStateValid(const QuantizedType& Value)
+{
+	const uint32 NumItems = Value.Items.Num();
+	const uint32 NumAffixes = Value.Affixes.Num();
+	const uint32 NumSockets = Value.Sockets.Num();
+	const uint32 NumStrings = Value.Strings.Num();
+	const uint32 NumReferences = Value.References.Num();
+	const uint32 NumDerivedElements = GetNumDerivedElements(Value.DerivedElements);
+
+	for (uint32 ItemIndex = 0; ItemIndex < NumItems; ++ItemIndex)
+	{
+		const FQuantizedItemHeader& Header = Value.Items.GetData()[ItemIndex];
+		if (Header.NumAffixes > NumAffixes || Header.FirstAffix > NumAffixes - Header.NumAffixes)
+		{
+			return false;
+		}
+
+		if (Header.NumSockets > NumSockets || Header.FirstSocket > NumSockets - Header.NumSockets)
+		{
+			return false;
+		}
+
+		if (!IsDefinitionReferenceValid(Header.ItemDefinition, NumReferences, NumStrings))
+		{
+			return false;
+		}
+
+		for (const FQuantizedSocket& Socket : MakeArrayView(Value.Sockets.GetData() + Header.FirstSocket, Header.NumSockets))
+		{
+			// Socketed ItemInstances are always flattened after their owner, which also rules out any cycles.
+			if (Socket.SocketedItemIndex != INDEX_NONE && (Socket.SocketedItemIndex <= static_cast<int32>(ItemIndex) || Socket.SocketedItemIndex >= static_cast<int32>(NumItems)))
+			{
+				return false;
+			}
+		}
+	}
+
+	for (const FQuantizedAffix& Affix : MakeArrayView(Value.Affixes.GetData(), NumAffixes))
+	{
+		if (!IsDefinitionReferenceValid(Affix.AffixDefinition, NumReferences, NumStrings) || !IsDerivedElementIndexValid(Affix.DerivedElement, NumDerivedElements))
+		{
+			return false;
+		}
+	}
+
+	for (const FQuantizedSocket& Socket : MakeArrayView(Value.Sockets.GetData(), NumSockets))
+	{
+		if (!IsDerivedElementIndexValid(Socket.DerivedElement, NumDerivedElements) || !IsDerivedElementIndexValid(Socket.SocketedItemDerivedElement, NumDerivedElements))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool FItemInstanceNetSerializer::IsEqual(FNetSerializationContext& Context, const FNetIsEqualArgs& Args)
+{
+	if (Args.bStateIsQuantized)
+	{
+		const QuantizedType& Value0 = *reinterpret_cast<const QuantizedType*>(Args.Source0);
+		const QuantizedType& Value1 = *reinterpret_cast<const QuantizedType*>(Args.Source1);
+
+		return IsStorageEqual(Value0.Items, Value1.Items)
+			&& IsStorageEqual(Value0.Affixes, Value1.Affixes)
+			&& IsStorageEqual(Value0.Sockets, Value1.Sockets)
+			&& IsStorageEqual(Value0.Strings, Value1.Strings)
+			&& AreReferencesEqual(Value0.References, Value1.References)
+			&& AreDerivedElementsEqual(Context, Value0.DerivedElements, Value1.DerivedElements);
+	}
+
+	const SourceType& Value0 = *reinterpret_cast<const SourceType*>(Args.Source0);
+	const SourceType& Value1 = *reinterpret_cast<const SourceType*>(Args.Source1);
+
+	FQuantizeScratch Scratch0;
+	QuantizeItem(Scratch0, Value0, 0);
+
+	FQuantizeScratch Scratch1;
+	QuantizeItem(Scratch1, Value1, 0);
+
+	return IsArrayEqual(Scratch0.Items, Scratch1.Items)
+		&& IsArrayEqual(Scratch0.Affixes, Scratch1.Affixes)
+		&& IsArrayEqual(Scratch0.Sockets, Scratch1.Sockets)
+		&& IsArrayEqual(Scratch0.Strings, Scratch1.Strings)
+		&& IsArrayEqual(Scratch0.Tables, Scratch1.Tables)
+		&& AreDerivedElementsEqual(Scratch0.DerivedElements, Scratch1.DerivedElements);
+}
+
+bool FItemInstanceNetSerializer::Validate(FNetSerializationContext& Context, const FNetValidateArgs& Args)
+{
+	const SourceType& Source = *reinterpret_cast<const SourceType*>(Args.Source);
+
+	FQuantizeScratch Scratch;
+	QuantizeItem(Scratch, Source, 0);
+
+	return static_cast<uint32>(Scratch.Items.Num()) <= MaxItems
+		&& static_cast<uint32>(Scratch.Affixes.Num()) <= MaxAffixes
+		&& static_cast<uint32>(Scratch.Sockets.Num()) <= MaxSockets
+		&& static_cast<uint32>(Scratch.Strings.Num()) <= MaxStringBytes
+		&& static_cast<uint32>(Scratch.Tables.Num()) <= MaxReferences
+		&& static_cast<uint32>(Scratch.DerivedElements.Num()) <= MaxDerivedElements;
+}
+
+void FItemInstanceNetSerializer::CloneDynamicState(FNetSerializationContext& Context, const FNetCloneDynamicStateArgs& Args)
+{
+	const QuantizedType& Source = *reinterpret_cast<const QuantizedType*>(Args.Source);
+	QuantizedType& Target = *reinterpret_cast<QuantizedType*>(Args.Target);
+
+	Target.Items.Clone(Context, Source.Items);
+	Target.Affixes.Clone(Context, Source.Affixes);
+	Target.Sockets.Clone(Context, Source.Sockets);
+	Target.Strings.Clone(Context, Source.Strings);
+	Target.References.Clone(Context, Source.References);
+	CloneDerivedElements(Context, Target.DerivedElements, Source.DerivedElements);
+}
+
+void FItemInstanceNetSerializer::FreeDynamicState(FNetSerializationContext& Context, const FNetFreeDynamicStateArgs& Args)
+{
+	QuantizedType& Value = *reinterpret_cast<QuantizedType*>(Args.Source);
+
+	Value.Items.Free(Context);
+	Value.Affixes.Free(Context);
+	Value.Sockets.Free(Context);
+	Value.Strings.Free(Context);
+	Value.References.Free(Context);
+	FreeDerivedElements(Context, Value.DerivedElements);
+}
+
+void FItemInstanceNetSerializer::CollectNetReferences(FNetSerializationContext& Context, const FNetCollectReferencesArgs& Args)
+{
+	const QuantizedType& Value = *reinterpret_cast<const QuantizedType*>(Args.Source);
+
+	CollectReferences(Context, Args, Value.References);
+	CollectDerivedElementReferences(Context, Args, Value.DerivedElements);
+}
+
+/************************************************************************/
+/* FAffixInstanceNetSerializer
+/************************************************************************/
+
+/**
+ * Iris NetSerializer for FAffixInstance. Sends the Definition Registry Id of the AffixDefinition where possible, otherwise an
+ * object reference to its DataTable and its RowName.
+ */
+struct FAffixInstanceNetSerializer
+{
+	static const uint32 Version = 1;
+	static constexpr bool bHasDynamicState = true;
+	static constexpr bool bHasCustomNetReference = true;
+
+	struct FQuantizedType
+	{
+		FQuantizedAffix Affix;
+		TQuantizedArrayStorage<uint8> Strings;
+		TQuantizedArrayStorage<FNetObjectReference> References;
+	};
+
+	typedef FAffixInstance SourceType;
+	typedef FQuantizedType QuantizedType;
+	typedef FAffixInstanceNetSerializerConfig ConfigType;
+
+	static const ConfigType DefaultConfig;
+
+	static void Serialize(FNetSerializationContext& Context, const FNetSerializeArgs& Args);
+	static void Deserialize(FNetSerializationContext& Context, const FNetDeserializeArgs& Args);
+
+	static void SerializeDelta(FNetSerializationContext& Context, const FNetSerializeDeltaArgs& Args);
+	static void DeserializeDelta(FNetSerializationContext& Context, const FNetDeserializeDeltaArgs& Args);
+
+	static void Quantize(FNetSerializationContext& Context, const FNetQuantizeArgs& Args);
+	static void Dequantize(FNetSerializationContext& Context, const FNetDequantizeArgs& Args);
+
+	static bool IsEqual(FNetSerializationContext& Context, const FNetIsEqualArgs& Args);
+	static bool Validate(FNetSerializationContext& Context, const FNetValidateArgs& Args);
+
+	static void CloneDynamicState(FNetSerializationContext& Context, const FNetCloneDynamicStateArgs& Args);
+	static void FreeDynamicState(FNetSerializationContext& Context, const FNetFreeDynamicStateArgs& Args);
+
+	static void CollectNetReferences(FNetSerializationContext& Context, const FNetCollectReferencesArgs& Args);
+};
+
+UE_NET_IMPLEMENT_SERIALIZER(FAffixInstanceNetSerializer);
+
+const FAffixInstanceNetSerializer::ConfigType FAffixInstanceNetSerializer::DefaultConfig;
+
+void FAffixInstanceNetSerializer::Serialize(FNetSerializationContext& Context, const FNetSerializeArgs& Args)
+{
+	const QuantizedType& Value = *reinterpret_cast<const QuantizedType*>(Args.Source);
+	FNetBitStreamWriter* Writer = Context.GetBitStreamWriter();
+
+	WriteAffix(Writer, Value.Affix);
+	WriteStorage(Writer, Value.Strings, &WriteStringByte);
+	WriteReferences(Context, Value.References);
+}
+
+void FAffixInstanceNetSerializer::Deserialize(FNetSerializationContext& Context, const FNetDeserializeArgs& Args)
+{
+	QuantizedType& Target = *reinterpret_cast<QuantizedType*>(Args.Target);
+
+	ReadAffix(Context.GetBitStreamReader(), Target.Affix);
+	ReadStorage(Context, Target.Strings, MaxStringBytes, &ReadStringByte);
+	ReadReferences(Context, Target.References);
+
+	// The root AffixInstance is always of the property's own type, so it never refers to a derived element.
+	if (!Context.HasErrorOrOverflow() && (Target.Affix.DerivedElement != INDEX_NONE || !IsDefinitionReferenceValid(Target.Affix.AffixDefinition, Target.References.Num(), Target.Strings.Num())))
+	{
+		Context.SetError(GNetError_InvalidValue);
+	}
+}
+
+void FAffixInstanceNetSerializer::SerializeDelta(FNetSerializationContext& Context, const FNetSerializeDeltaArgs& Args)
+{
+	const QuantizedType& Value = *reinterpret_cast<const QuantizedType*>(Args.Source);
+	const QuantizedType& PrevValue = *reinterpret_cast<const QuantizedType*>(Args.Prev);
+	FNetBitStreamWriter* Writer = Context.GetBitStreamWriter();
+
+	// AffixInstances rarely change once generated, so an unchanged Affix costs a single bit.
+	const bool bChanged = FMemory::Memcmp(&Value.Affix, &PrevValue.Affix, sizeof(FQuantizedAffix)) != 0 || !IsStorageEqual(Value.Strings, PrevValue.Strings) || !AreReferencesEqual(Value.References, PrevValue.References);
+	if (Writer->WriteBool(bChanged))
+	{
+		Serialize(Context, Args);
+	}
+}
+
+void FAffixInstanceNetSerializer::DeserializeDelta(FNetSerializationContext& Context, const FNetDeserializeDeltaArgs& Args)
+{
+	QuantizedType& Target = *reinterpret_cast<QuantizedType*>(Args.Target);
+	const QuantizedType& PrevValue = *reinterpret_cast<const QuantizedType*>(Args.Prev);
+
+	if (Context.GetBitStreamReader()->ReadBool())
+	{
+		Deserialize(Context, Args);
+	}
+	else
+	{
+		Target.Affix = PrevValue.Affix;
+		CopyToStorage(Context, Target.Strings, MakeArrayView(PrevValue.Strings.GetData(), PrevValue.Strings.Num()));
+		CopyToStorage(Context, Target.References, MakeArrayView(PrevValue.References.GetData(), PrevValue.References.Num()));
+	}
+}
+
+void FAffixInstanceNetSerializer::Quantize(FNetSerializationContext& Context, const FNetQuantizeArgs& Args)
+{
+	const SourceType& Source = *reinterpret_cast<const SourceType*>(Args.Source);
+	QuantizedType& Target = *reinterpret_cast<QuantizedType*>(Args.Target);
+
+	FQuantizeScratch Scratch;
+	QuantizeAffix(Scratch, Source, INDEX_NONE, Target.Affix);
+
+	CopyToStorage(Context, Target.Strings, Scratch.Strings);
+	QuantizeReferences(Context, Target.References, Scratch.Tables);
+}
+
+void FAffixInstanceNetSerializer::Dequantize(FNetSerializationContext& Context, const FNetDequantizeArgs& Args)
+{
+	const QuantizedType& Source = *reinterpret_cast<const QuantizedType*>(Args.Source);
+	SourceType& Target = *reinterpret_cast<SourceType*>(Args.Target);
+
+	FDequantizeScratch Scratch;
+	Scratch.Strings = Source.Strings.GetData();
+	Scratch.Registry = UGenericItemizationDefinitionRegistry::Get();
+	DequantizeTables(Context, Source.References, Scratch);
+
+	DequantizeAffix(Source.Affix, Scratch, Target);
+}
+
+bool FAffixInstanceNetSerializer::IsEqual(FNetSerializationContext& Context, const FNetIsEqualArgs& Args)
+{
+	if (Args.bStateIsQuantized)
+	{
+		const QuantizedType& Value0 = *reinterpret_cast<const QuantizedType*>(Args.Source0);
+		const QuantizedType& Value1 = *reinterpret_cast<const QuantizedType*>(Args.Source1);
+		return FMemory::Memcmp(&Value0.Affix, &Value1.Affix, sizeof(FQuantizedAffix)) == 0 && IsStorageEqual(Value0.Strings, Value1.Strings) && AreReferencesEqual(Value0.References, Value1.References);
+	}
+
+	const SourceType& Value0 = *reinterpret_cast<const SourceType*>(Args.Source0);
+	const SourceType& Value1 = *reinterpret_cast<const SourceType*>(Args.Source1);
+	return Value0.bPredefinedAffix == Value1.bPredefinedAffix && Value0.GetAffixDefinitionHandle() == Value1.GetAffixDefinitionHandle();
+}
+
+bool FAffixInstanceNetSerializer::Validate(FNetSerializationContext& Context, const FNetValidateArgs& Args)
+{
+	return true;
+}
+
+void FAffixInstanceNetSerializer::CloneDynamicState(FNetSerializationContext& Context, const FNetCloneDynamicStateArgs& Args)
+{
+	const QuantizedType& Source = *reinterpret_cast<const QuantizedType*>(Args.Source);
+	QuantizedType& Target = *reinterpret_cast<QuantizedType*>(Args.Target);
+
+	Target.Strings.Clone(Context, Source.Strings);
+	Target.References.Clone(Context, Source.References);
+}
+
+void FAffixInstanceNetSerializer::FreeDynamicState(FNetSerializationContext& Context, const FNetFreeDynamicStateArgs& Args)
+{
+	QuantizedType& Value = *reinterpret_cast<QuantizedType*>(Args.Source);
+
+	Value.Strings.Free(Context);
+	Value.References.Free(Context);
+}
+
+void FAffixInstanceNetSerializer::CollectNetReferences(FNetSerializationContext& Context, const FNetCollectReferencesArgs& Args)
+{
+	const QuantizedType& Value = *reinterpret_cast<const QuantizedType*>(Args.Source);
+
+	CollectReferences(Context, Args, Value.References);
+}
+
+/************************************************************************/
+/* Registration
+/************************************************************************/
+
+static const FName PropertyNetSerializerRegistry_NAME_ItemInstance("ItemInstance");
+UE_NET_IMPLEMENT_NAMED_STRUCT_NETSERIALIZER_INFO(PropertyNetSerializerRegistry_NAME_ItemInstance, FItemInstanceNetSerializer);
+
+static const FName PropertyNetSerializerRegistry_NAME_AffixInstance("AffixInstance");
+UE_NET_IMPLEMENT_NAMED_STRUCT_NETSERIALIZER_INFO(PropertyNetSerializerRegistry_NAME_AffixInstance, FAffixInstanceNetSerializer);
+
+/* Binds our NetSerializers to FItemInstance and FAffixInstance, replacing the legacy NetSerialize bridge. */
+class FGenericItemizationNetSerializerRegistryDelegates final : private FNetSerializerRegistryDelegates
+{
+public:
+
+	virtual ~FGenericItemizationNetSerializerRegistryDelegates()
+	{
+		UE_NET_UNREGISTER_NETSERIALIZER_INFO(PropertyNetSerializerRegistry_NAME_ItemInstance);
+		UE_NET_UNREGISTER_NETSERIALIZER_INFO(PropertyNetSerializerRegistry_NAME_AffixInstance);
+	}
+
+private:
+
+	virtual void OnPreFreezeNetSerializerRegistry() override
+	{
+		UE_NET_REGISTER_NETSERIALIZER_INFO(PropertyNetSerializerRegistry_NAME_ItemInstance);
+		UE_NET_REGISTER_NETSERIALIZER_INFO(PropertyNetSerializerRegistry_NAME_AffixInstance);
+	}
+};
+
+static FGenericItemizationNetSerializerRegistryDelegates GenericItemizationNetSerializerRegistryDelegates;
+
+}
+
+#endif // UE_WITH_IRIS
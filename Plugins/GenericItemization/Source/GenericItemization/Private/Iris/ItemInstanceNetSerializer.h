@@ -0,0 +1,47 @@
+// Copyright Fissure Entertainment, Pty Ltd. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Iris/Serialization/NetSerializer.h"
+#include "InstancedStruct.h"
+#include "ItemInstanceNetSerializer.generated.h"
+
+/**
+ * Config for the Iris NetSerializer of FItemInstance.
+ */
+USTRUCT()
+struct FItemInstanceNetSerializerConfig : public FNetSerializerConfig
+{
+	GENERATED_BODY()
+};
+
+/**
+ * Config for the Iris NetSerializer of FAffixInstance.
+ */
+USTRUCT()
+struct FAffixInstanceNetSerializerConfig : public FNetSerializerConfig
+{
+	GENERATED_BODY()
+};
+
+/**
+ * Carries an AffixInstance, SocketInstance or socketed ItemInstance whose type derives from the base type, so Iris can
+ * replicate it through the replication state descriptor of FInstancedStruct, which keeps its actual type and members.
+ */
+USTRUCT()
+struct FItemInstanceNetSerializerDerivedElement
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FInstancedStruct Element;
+};
+
+namespace UE::Net
+{
+
+UE_NET_DECLARE_SERIALIZER(FItemInstanceNetSerializer, GENERICITEMIZATION_API);
+UE_NET_DECLARE_SERIALIZER(FAffixInstanceNetSerializer, GENERICITEMIZATION_API);
+
+}
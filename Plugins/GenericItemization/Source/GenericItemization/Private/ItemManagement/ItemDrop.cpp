@@ -1,6 +1,8 @@
 // Copyright Fissure Entertainment, Pty Ltd. All Rights Reserved.
 
 #include "ItemManagement/ItemDrop.h"
+#include "ItemManagement/ItemDropPoolSubsystem.h"
+#include "ItemManagement/ItemDropSpatialIndexSubsystem.h"
 #include "Net/UnrealNetwork.h"
 #include "Net/Core/PushModel/PushModel.h"
 
@@ -19,10 +21,39 @@ void AItemDrop::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetim
 	FDoRepLifetimeParams Params;
 	Params.bIsPushBased = true;
 
-	Params.Condition = COND_InitialOnly;
 	DOREPLIFETIME_WITH_PARAMS_FAST(AItemDrop, ItemInstance, Params);
 }
 
+void AItemDrop::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (UItemDropSpatialIndexSubsystem* SpatialIndex = GetWorld()->GetSubsystem<UItemDropSpatialIndexSubsystem>())
+	{
+		SpatialIndex->AddItemDrop(this);
+	}
+
+	if (RootComponent)
+	{
+		RootComponent->TransformUpdated.AddUObject(this, &AItemDrop::OnRootComponentTransformUpdated);
+	}
+}
+
+void AItemDrop::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UItemDropSpatialIndexSubsystem* SpatialIndex = GetWorld()->GetSubsystem<UItemDropSpatialIndexSubsystem>())
+	{
+		SpatialIndex->RemoveItemDrop(this);
+	}
+
+	if (RootComponent)
+	{
+		RootComponent->TransformUpdated.RemoveAll(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
 void AItemDrop::GetItemInstance(TInstancedStruct<FItemInstance>& OutItemInstance) const
 {
 	OutItemInstance = ItemInstance;
@@ -53,3 +84,140 @@ bool AItemDrop::CanTakeItem_Implementation(UItemInventoryComponent* InventoryCom
 {
 	return true;
 }
+
+AItemDropManager* AItemDrop::GetDropManager(FGuid& OutDropId) const
+{
+	OutDropId = DropId;
+	return DropManager.Get();
+}
+
+void AItemDrop::ReleaseToPool()
+{
+	UWorld* World = GetWorld();
+	UItemDropPoolSubsystem* ItemDropPool = World ? World->GetSubsystem<UItemDropPoolSubsystem>() : nullptr;
+	if (ItemDropPool)
+	{
+		ItemDropPool->ReleaseItemDrop(this);
+	}
+	else
+	{
+		Destroy(true);
+	}
+}
+
+void AItemDrop::SetItemInstance(const TInstancedStruct<FItemInstance>& InItemInstance)
+{
+	ItemInstance = InItemInstance;
+
+	MARK_PROPERTY_DIRTY_FROM_NAME(AItemDrop, ItemInstance, this);
+	K2_OnItemInstanceChanged();
+}
+
+void AItemDrop::SetItemInstance(TInstancedStruct<FItemInstance>&& InItemInstance)
+{
+	ItemInstance = MoveTemp(InItemInstance);
+
+	MARK_PROPERTY_DIRTY_FROM_NAME(AItemDrop, ItemInstance, this);
+	K2_OnItemInstanceChanged();
+}
+
+void AItemDrop::SetItemInstance(const FInstancedStruct& InItemInstance)
+{
+	ItemInstance.InitializeAsScriptStruct(InItemInstance.GetScriptStruct(), InItemInstance.GetMemory());
+
+	MARK_PROPERTY_DIRTY_FROM_NAME(AItemDrop, ItemInstance, this);
+	K2_OnItemInstanceChanged();
+}
+
+void AItemDrop::ResetItemInstance()
+{
+	ItemInstance.Reset();
+
+	MARK_PROPERTY_DIRTY_FROM_NAME(AItemDrop, ItemInstance, this);
+	K2_OnItemInstanceChanged();
+}
+
+void AItemDrop::ActivateFromPool(const FTransform& Transform, AActor* NewOwner, bool bReplicated)
+{
+	bIsPooled = false;
+
+	SetOwner(NewOwner);
+	SetActorTransform(Transform, false, nullptr, ETeleportType::ResetPhysics);
+	SetActorHiddenInGame(false);
+	SetActorEnableCollision(true);
+
+	if (bReplicated && GetIsReplicated())
+	{
+		// Clients with a dormant channel to a reused ItemDrop still have it where it was, so from now on its movement is replicated.
+		SetReplicatingMovement(true);
+		SetNetDormancy(DORM_Awake);
+		ForceNetUpdate();
+	}
+	else if (bReplicated)
+	{
+		// Prewarmed ItemDrops only start replicating once they are used, so that Clients are never sent the dormant ones.
+		SetReplicates(true);
+	}
+
+	if (UItemDropSpatialIndexSubsystem* SpatialIndex = GetWorld()->GetSubsystem<UItemDropSpatialIndexSubsystem>())
+	{
+		SpatialIndex->AddItemDrop(this);
+	}
+
+	K2_OnAcquiredFromPool();
+}
+
+void AItemDrop::DeactivateToPool()
+{
+	K2_OnReleasedToPool();
+
+	bIsPooled = true;
+
+	if (UItemDropSpatialIndexSubsystem* SpatialIndex = GetWorld()->GetSubsystem<UItemDropSpatialIndexSubsystem>())
+	{
+		SpatialIndex->RemoveItemDrop(this);
+	}
+
+	ResetItemInstance();
+	DropManager.Reset();
+	DropId.Invalidate();
+
+	SetOwner(nullptr);
+	SetActorHiddenInGame(true);
+	SetActorEnableCollision(false);
+
+	if (GetIsReplicated())
+	{
+		// The reset state is flushed to Clients before the channel goes dormant.
+		ForceNetUpdate();
+		SetNetDormancy(DORM_DormantAll);
+	}
+}
+
+void AItemDrop::OnRep_ItemInstance()
+{
+	K2_OnItemInstanceChanged();
+}
+
+void AItemDrop::OnRootComponentTransformUpdated(USceneComponent* UpdatedComponent, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport)
+{
+	if (UItemDropSpatialIndexSubsystem* SpatialIndex = GetWorld()->GetSubsystem<UItemDropSpatialIndexSubsystem>())
+	{
+		SpatialIndex->UpdateItemDrop(this);
+	}
+}
+
+void AItemDrop::K2_OnItemInstanceChanged_Implementation()
+{
+	// Left empty intentionally to be overridden.
+}
+
+void AItemDrop::K2_OnAcquiredFromPool_Implementation()
+{
+	// Left empty intentionally to be overridden.
+}
+
+void AItemDrop::K2_OnReleasedToPool_Implementation()
+{
+	// Left empty intentionally to be overridden.
+}
@@ -0,0 +1,392 @@
+// Copyright Fissure Entertainment, Pty Ltd. All Rights Reserved.
+
+#include "ItemManagement/ItemDropManager.h"
+#include "ItemManagement/ItemDropManagerSubsystem.h"
+#include "ItemManagement/ItemDrop.h"
+#include "ItemManagement/ItemDropPoolSubsystem.h"
+#include "ItemManagement/ItemDropSpatialIndexSubsystem.h"
+#include "ItemManagement/ItemInventoryComponent.h"
+#include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+#include "GameFramework/Pawn.h"
+#include "Engine/World.h"
+
+namespace ItemDropManagerPrivate
+{
+
+/* Returns the Actor whose location is used for the Inventory when taking drops. Inventories on a Controller or PlayerState use its Pawn. */
+static const AActor* GetInventoryLocationActor(const UItemInventoryComponent* InventoryComponent)
+{
+	const AActor* Owner = InventoryComponent ? InventoryComponent->GetOwner() : nullptr;
+	if (const AController* Controller = Cast<AController>(Owner))
+	{
+		return Controller->GetPawn();
+	}
+
+	if (const APlayerState* PlayerState = Cast<APlayerState>(Owner))
+	{
+		return PlayerState->GetPawn();
+	}
+
+	return Owner;
+}
+
+}
+
+void FItemDropRecordsContainer::PostReplicatedAdd(const TArrayView<int32>& AddedIndices, int32 FinalSize)
+{
+	if (Owner)
+	{
+		for (const int32& Index : AddedIndices)
+		{
+			Owner->OnDropAdded(Records[Index]);
+		}
+	}
+}
+
+void FItemDropRecordsContainer::PostReplicatedChange(const TArrayView<int32>& ChangedIndices, int32 FinalSize)
+{
+	if (Owner)
+	{
+		for (const int32& Index : ChangedIndices)
+		{
+			Owner->OnDropChanged(Records[Index]);
+		}
+	}
+}
+
+void FItemDropRecordsContainer::PreReplicatedRemove(const TArrayView<int32>& RemovedIndices, int32 FinalSize)
+{
+	if (Owner)
+	{
+		for (const int32& Index : RemovedIndices)
+		{
+			Owner->OnDropRemoved(Records[Index]);
+		}
+	}
+}
+
+AItemDropManager::AItemDropManager()
+{
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
+
+	bReplicates = true;
+	bAlwaysRelevant = false;
+	SetReplicatingMovement(false);
+
+	RootComponent = CreateDefaultSubobject<USceneComponent>("Root");
+
+	VisualItemDropClass = AItemDrop::StaticClass();
+	Cell = FIntVector::ZeroValue;
+}
+
+void AItemDropManager::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+
+	DOREPLIFETIME_WITH_PARAMS_FAST(AItemDropManager, Drops, Params);
+
+	Params.Condition = COND_InitialOnly;
+	DOREPLIFETIME_WITH_PARAMS_FAST(AItemDropManager, Cell, Params);
+}
+
+void AItemDropManager::PostInitializeComponents()
+{
+	Super::PostInitializeComponents();
+
+	Drops.Owner = this;
+}
+
+void AItemDropManager::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (UItemDropManagerSubsystem* DropManagerSubsystem = GetWorld()->GetSubsystem<UItemDropManagerSubsystem>())
+	{
+		DropManagerSubsystem->RegisterDropManager(this);
+	}
+
+	// Only worlds with local players have anything to visualize.
+	if (GetNetMode() != NM_DedicatedServer)
+	{
+		SetActorTickInterval(VisualUpdateInterval);
+		SetActorTickEnabled(true);
+	}
+}
+
+void AItemDropManager::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UItemDropManagerSubsystem* DropManagerSubsystem = GetWorld()->GetSubsystem<UItemDropManagerSubsystem>())
+	{
+		DropManagerSubsystem->UnregisterDropManager(this);
+	}
+
+	if (HasAuthority())
+	{
+		if (UItemDropSpatialIndexSubsystem* SpatialIndex = GetWorld()->GetSubsystem<UItemDropSpatialIndexSubsystem>())
+		{
+			for (const FItemDropRecord& Drop : Drops.Records)
+			{
+				SpatialIndex->RemoveItemDropRecord(Drop.DropId);
+			}
+		}
+	}
+
+	TArray<FGuid> VisualizedDropIds;
+	DropVisuals.GetKeys(VisualizedDropIds);
+	for (const FGuid& DropId : VisualizedDropIds)
+	{
+		DestroyDropVisual(DropId);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void AItemDropManager::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	UpdateDropVisuals();
+}
+
+FGuid AItemDropManager::AddDrop(const FInstancedStruct& ItemInstance, FVector Location)
+{
+	if (!HasAuthority())
+	{
+		return FGuid();
+	}
+
+	const FItemInstance* ItemInstancePtr = ItemInstance.GetPtr<FItemInstance>();
+	if (!ItemInstancePtr || !ItemInstancePtr->IsValid())
+	{
+		return FGuid();
+	}
+
+	FItemDropRecord& Drop = Drops.Records.AddDefaulted_GetRef();
+	Drop.DropId = FGuid::NewGuid();
+	Drop.Location = Location;
+	Drop.ItemInstance.InitializeAsScriptStruct(ItemInstance.GetScriptStruct(), ItemInstance.GetMemory());
+	Drops.MarkItemDirty(Drop);
+
+	// A dedicated Server has no ItemDrops visualizing our drops, so it indexes the drops themselves.
+	if (UItemDropSpatialIndexSubsystem* SpatialIndex = GetWorld()->GetSubsystem<UItemDropSpatialIndexSubsystem>())
+	{
+		SpatialIndex->AddItemDropRecord(this, Drop);
+	}
+
+	MARK_PROPERTY_DIRTY_FROM_NAME(AItemDropManager, Drops, this);
+	ForceNetUpdate();
+
+	return Drop.DropId;
+}
+
+bool AItemDropManager::RemoveDrop(FGuid DropId, TInstancedStruct<FItemInstance>& OutItemInstance)
+{
+	if (!HasAuthority())
+	{
+		return false;
+	}
+
+	const int32 DropIndex = Drops.Records.IndexOfByPredicate([&DropId](const FItemDropRecord& Drop)
+	{
+		return Drop.DropId == DropId;
+	});
+
+	if (DropIndex == INDEX_NONE)
+	{
+		return false;
+	}
+
+	// The ItemInstance is moved out rather than copied, as we are making a logical transfer of ownership to the caller.
+	OutItemInstance = MoveTemp(Drops.Records[DropIndex].ItemInstance);
+	DestroyDropVisual(DropId);
+
+	if (UItemDropSpatialIndexSubsystem* SpatialIndex = GetWorld()->GetSubsystem<UItemDropSpatialIndexSubsystem>())
+	{
+		SpatialIndex->RemoveItemDropRecord(DropId);
+	}
+
+	Drops.Records.RemoveAtSwap(DropIndex);
+	Drops.MarkArrayDirty();
+
+	MARK_PROPERTY_DIRTY_FROM_NAME(AItemDropManager, Drops, this);
+	ForceNetUpdate();
+
+	return true;
+}
+
+bool AItemDropManager::SetDropItemInstance(const FGuid& DropId, const TInstancedStruct<FItemInstance>& ItemInstance)
+{
+	if (!HasAuthority())
+	{
+		return false;
+	}
+
+	FItemDropRecord* Drop = Drops.Records.FindByPredicate([&DropId](const FItemDropRecord& Drop)
+	{
+		return Drop.DropId == DropId;
+	});
+
+	if (!Drop)
+	{
+		return false;
+	}
+
+	Drop->ItemInstance = ItemInstance;
+	Drops.MarkItemDirty(*Drop);
+
+	if (TObjectPtr<AItemDrop>* DropVisual = DropVisuals.Find(DropId))
+	{
+		(*DropVisual)->SetItemInstance(ItemInstance);
+	}
+
+	MARK_PROPERTY_DIRTY_FROM_NAME(AItemDropManager, Drops, this);
+	ForceNetUpdate();
+
+	return true;
+}
+
+bool AItemDropManager::GetDrop(FGuid DropId, FItemDropRecord& OutDrop) const
+{
+	if (const FItemDropRecord* Drop = FindDrop(DropId))
+	{
+		OutDrop = *Drop;
+		return true;
+	}
+
+	return false;
+}
+
+const FItemDropRecord* AItemDropManager::FindDrop(const FGuid& DropId) const
+{
+	return Drops.Records.FindByPredicate([&DropId](const FItemDropRecord& Drop)
+	{
+		return Drop.DropId == DropId;
+	});
+}
+
+bool AItemDropManager::CanTakeDrop_Implementation(FGuid DropId, UItemInventoryComponent* InventoryComponent) const
+{
+	const FItemDropRecord* Drop = FindDrop(DropId);
+	if (!Drop)
+	{
+		return false;
+	}
+
+	if (TakeDropRange <= 0.0f)
+	{
+		return true;
+	}
+
+	const AActor* LocationActor = ItemDropManagerPrivate::GetInventoryLocationActor(InventoryComponent);
+	return LocationActor && FVector::DistSquared(LocationActor->GetActorLocation(), Drop->Location) <= FMath::Square(TakeDropRange);
+}
+
+void AItemDropManager::UpdateDropVisuals()
+{
+	if (!IsValid(VisualItemDropClass))
+	{
+		return;
+	}
+
+	TArray<FVector, TInlineAllocator<4>> ViewLocations;
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PlayerController = It->Get();
+		if (PlayerController && PlayerController->IsLocalController())
+		{
+			FVector ViewLocation;
+			FRotator ViewRotation;
+			PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+			ViewLocations.Add(ViewLocation);
+		}
+	}
+
+	const float VisualDistanceSquared = FMath::Square(VisualDistance);
+	TSet<FGuid> VisibleDropIds;
+	for (const FItemDropRecord& Drop : Drops.Records)
+	{
+		const bool bIsVisible = ViewLocations.ContainsByPredicate([&Drop, VisualDistanceSquared](const FVector& ViewLocation)
+		{
+			return FVector::DistSquared(ViewLocation, Drop.Location) <= VisualDistanceSquared;
+		});
+
+		if (bIsVisible)
+		{
+			VisibleDropIds.Add(Drop.DropId);
+			if (!DropVisuals.Contains(Drop.DropId))
+			{
+				SpawnDropVisual(Drop);
+			}
+		}
+	}
+
+	for (auto It = DropVisuals.CreateIterator(); It; ++It)
+	{
+		if (!VisibleDropIds.Contains(It.Key()))
+		{
+			if (IsValid(It.Value()))
+			{
+				It.Value()->ReleaseToPool();
+			}
+
+			It.RemoveCurrent();
+		}
+	}
+}
+
+AItemDrop* AItemDropManager::SpawnDropVisual(const FItemDropRecord& Drop)
+{
+	UItemDropPoolSubsystem* ItemDropPool = GetWorld()->GetSubsystem<UItemDropPoolSubsystem>();
+	if (!Drop.ItemInstance.IsValid() || !ItemDropPool)
+	{
+		return nullptr;
+	}
+
+	// Visuals only exist locally, the drop itself is replicated by us.
+	const FTransform SpawnTransform = FTransform(FRotator::ZeroRotator, Drop.Location);
+	AItemDrop* ItemDrop = ItemDropPool->AcquireItemDrop(VisualItemDropClass, SpawnTransform, this, Drop.ItemInstance, false);
+	if (!ItemDrop)
+	{
+		return nullptr;
+	}
+
+	ItemDrop->DropManager = this;
+	ItemDrop->DropId = Drop.DropId;
+
+	DropVisuals.Add(Drop.DropId, ItemDrop);
+	return ItemDrop;
+}
+
+void AItemDropManager::DestroyDropVisual(const FGuid& DropId)
+{
+	TObjectPtr<AItemDrop> DropVisual;
+	if (DropVisuals.RemoveAndCopyValue(DropId, DropVisual) && IsValid(DropVisual))
+	{
+		DropVisual->ReleaseToPool();
+	}
+}
+
+void AItemDropManager::OnDropAdded(const FItemDropRecord& Drop)
+{
+	// Visuals for new drops are spawned by the next UpdateDropVisuals.
+}
+
+void AItemDropManager::OnDropChanged(const FItemDropRecord& Drop)
+{
+	if (TObjectPtr<AItemDrop>* DropVisual = DropVisuals.Find(Drop.DropId))
+	{
+		(*DropVisual)->SetItemInstance(Drop.ItemInstance);
+	}
+}
+
+void AItemDropManager::OnDropRemoved(const FItemDropRecord& Drop)
+{
+	DestroyDropVisual(Drop.DropId);
+}
@@ -0,0 +1,113 @@
+// Copyright Fissure Entertainment, Pty Ltd. All Rights Reserved.
+
+#include "ItemManagement/ItemDropManagerSubsystem.h"
+#include "ItemManagement/ItemDropManager.h"
+#include "GenericItemizationSettings.h"
+#include "Kismet/GameplayStatics.h"
+#include "Engine/World.h"
+
+bool UItemDropManagerSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+bool UItemDropManagerSubsystem::AreItemDropManagersEnabled()
+{
+	return GetDefault<UGenericItemizationSettings>()->bUseItemDropManagers;
+}
+
+FIntVector UItemDropManagerSubsystem::GetCellForLocation(const FVector& Location)
+{
+	const double CellSize = FMath::Max(GetDefault<UGenericItemizationSettings>()->ItemDropManagerCellSize, 1.0f);
+	return FIntVector(
+		FMath::FloorToInt32(Location.X / CellSize),
+		FMath::FloorToInt32(Location.Y / CellSize),
+		FMath::FloorToInt32(Location.Z / CellSize));
+}
+
+AItemDropManager* UItemDropManagerSubsystem::FindDropManager(const FVector& Location) const
+{
+	const TObjectPtr<AItemDropManager>* DropManager = DropManagers.Find(GetCellForLocation(Location));
+	return DropManager && IsValid(*DropManager) ? DropManager->Get() : nullptr;
+}
+
+AItemDropManager* UItemDropManagerSubsystem::GetOrCreateDropManager(const FVector& Location)
+{
+	UWorld* World = GetWorld();
+	if (!World || World->GetNetMode() == NM_Client)
+	{
+		return nullptr;
+	}
+
+	if (AItemDropManager* DropManager = FindDropManager(Location))
+	{
+		return DropManager;
+	}
+
+	const UGenericItemizationSettings* Settings = GetDefault<UGenericItemizationSettings>();
+	TSubclassOf<AItemDropManager> DropManagerClass = Settings->ItemDropManagerClass.LoadSynchronous();
+	if (!DropManagerClass)
+	{
+		DropManagerClass = AItemDropManager::StaticClass();
+	}
+
+	// ItemDropManagers sit at the center of their cell so that distance based relevancy is measured from there.
+	const FIntVector Cell = GetCellForLocation(Location);
+	const double CellSize = FMath::Max(Settings->ItemDropManagerCellSize, 1.0f);
+	const FVector CellCenter = (FVector(Cell) + FVector(0.5)) * CellSize;
+	const FTransform SpawnTransform = FTransform(FRotator::ZeroRotator, CellCenter);
+
+	AItemDropManager* DropManager = World->SpawnActorDeferred<AItemDropManager>(DropManagerClass, SpawnTransform, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+	if (!DropManager)
+	{
+		return nullptr;
+	}
+
+	DropManager->Cell = Cell;
+	DropManager->SetNetCullDistanceSquared(FMath::Square(Settings->ItemDropManagerNetCullDistance));
+	UGameplayStatics::FinishSpawningActor(DropManager, SpawnTransform);
+
+	// BeginPlay has normally registered it already, but not if the World has not begun play yet.
+	DropManagers.Add(Cell, DropManager);
+	return DropManager;
+}
+
+FGuid UItemDropManagerSubsystem::DropItem(const FInstancedStruct& ItemInstance, FVector Location, AItemDropManager*& OutDropManager)
+{
+	OutDropManager = GetOrCreateDropManager(Location);
+	if (!OutDropManager)
+	{
+		return FGuid();
+	}
+
+	return OutDropManager->AddDrop(ItemInstance, Location);
+}
+
+void UItemDropManagerSubsystem::GetDropManagers(TArray<AItemDropManager*>& OutDropManagers) const
+{
+	OutDropManagers.Reserve(OutDropManagers.Num() + DropManagers.Num());
+	for (const TPair<FIntVector, TObjectPtr<AItemDropManager>>& DropManager : DropManagers)
+	{
+		if (IsValid(DropManager.Value))
+		{
+			OutDropManagers.Add(DropManager.Value);
+		}
+	}
+}
+
+void UItemDropManagerSubsystem::RegisterDropManager(AItemDropManager* DropManager)
+{
+	if (IsValid(DropManager))
+	{
+		DropManagers.Add(DropManager->GetCell(), DropManager);
+	}
+}
+
+void UItemDropManagerSubsystem::UnregisterDropManager(AItemDropManager* DropManager)
+{
+	const TObjectPtr<AItemDropManager>* RegisteredDropManager = DropManager ? DropManagers.Find(DropManager->GetCell()) : nullptr;
+	if (RegisteredDropManager && *RegisteredDropManager == DropManager)
+	{
+		DropManagers.Remove(DropManager->GetCell());
+	}
+}
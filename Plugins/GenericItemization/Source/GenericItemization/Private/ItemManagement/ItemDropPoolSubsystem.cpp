@@ -0,0 +1,162 @@
+// Copyright Fissure Entertainment, Pty Ltd. All Rights Reserved.
+
+#include "ItemManagement/ItemDropPoolSubsystem.h"
+#include "ItemManagement/ItemDrop.h"
+#include "GenericItemizationSettings.h"
+#include "Kismet/GameplayStatics.h"
+#include "Engine/World.h"
+
+void UItemDropPoolSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	if (!IsItemDropPoolingEnabled() || !CanPoolItemDrops(true))
+	{
+		return;
+	}
+
+	for (const TPair<TSoftClassPtr<AItemDrop>, int32>& PrewarmedItemDrops : GetDefault<UGenericItemizationSettings>()->PrewarmedItemDrops)
+	{
+		if (TSubclassOf<AItemDrop> ItemDropClass = PrewarmedItemDrops.Key.LoadSynchronous())
+		{
+			PrewarmItemDrops(ItemDropClass, PrewarmedItemDrops.Value, true);
+		}
+	}
+}
+
+void UItemDropPoolSubsystem::Deinitialize()
+{
+	// The World destroys the ItemDrops themselves.
+	ReplicatedPools.Empty();
+	LocalPools.Empty();
+
+	Super::Deinitialize();
+}
+
+bool UItemDropPoolSubsystem::IsItemDropPoolingEnabled()
+{
+	return GetDefault<UGenericItemizationSettings>()->bPoolItemDrops;
+}
+
+bool UItemDropPoolSubsystem::CanPoolItemDrops(bool bReplicated) const
+{
+	const UWorld* World = GetWorld();
+	return World && (!bReplicated || World->GetNetMode() != NM_Client);
+}
+
+AItemDrop* UItemDropPoolSubsystem::AcquireItemDrop(TSubclassOf<AItemDrop> ItemDropClass, const FTransform& Transform, AActor* Owner, const FInstancedStruct& ItemInstance, bool bReplicated /*= true*/)
+{
+	return AcquireItemDrop(ItemDropClass, Transform, Owner, ItemInstance.GetScriptStruct(), ItemInstance.GetMemory(), bReplicated);
+}
+
+AItemDrop* UItemDropPoolSubsystem::AcquireItemDrop(TSubclassOf<AItemDrop> ItemDropClass, const FTransform& Transform, AActor* Owner, const TInstancedStruct<FItemInstance>& ItemInstance, bool bReplicated /*= true*/)
+{
+	return AcquireItemDrop(ItemDropClass, Transform, Owner, ItemInstance.GetScriptStruct(), ItemInstance.GetMemory(), bReplicated);
+}
+
+AItemDrop* UItemDropPoolSubsystem::AcquireItemDrop(TSubclassOf<AItemDrop> ItemDropClass, const FTransform& Transform, AActor* Owner, const UScriptStruct* ItemInstanceStruct, const uint8* ItemInstanceMemory, bool bReplicated)
+{
+	if (!IsValid(ItemDropClass) || !CanPoolItemDrops(bReplicated))
+	{
+		return nullptr;
+	}
+
+	FItemDropPool* Pool = (bReplicated ? ReplicatedPools : LocalPools).Find(ItemDropClass);
+	while (Pool && !Pool->ItemDrops.IsEmpty())
+	{
+		AItemDrop* ItemDrop = Pool->ItemDrops.Pop(EAllowShrinking::No);
+
+		// ItemDrops can be destroyed by something else while they are in the pool.
+		if (!IsValid(ItemDrop))
+		{
+			continue;
+		}
+
+		ItemDrop->ActivateFromPool(Transform, Owner, bReplicated);
+
+		TInstancedStruct<FItemInstance> NewItemInstance;
+		NewItemInstance.InitializeAsScriptStruct(ItemInstanceStruct, ItemInstanceMemory);
+		ItemDrop->SetItemInstance(MoveTemp(NewItemInstance));
+
+		return ItemDrop;
+	}
+
+	return SpawnItemDrop(ItemDropClass, Transform, Owner, ItemInstanceStruct, ItemInstanceMemory, bReplicated);
+}
+
+AItemDrop* UItemDropPoolSubsystem::SpawnItemDrop(TSubclassOf<AItemDrop> ItemDropClass, const FTransform& Transform, AActor* Owner, const UScriptStruct* ItemInstanceStruct, const uint8* ItemInstanceMemory, bool bReplicated)
+{
+	AItemDrop* ItemDrop = GetWorld()->SpawnActorDeferred<AItemDrop>(ItemDropClass, Transform, Owner, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+	if (!ItemDrop)
+	{
+		return nullptr;
+	}
+
+	if (!bReplicated)
+	{
+		ItemDrop->SetReplicates(false);
+	}
+
+	if (ItemInstanceStruct)
+	{
+		ItemDrop->ItemInstance.InitializeAsScriptStruct(ItemInstanceStruct, ItemInstanceMemory);
+	}
+
+	UGameplayStatics::FinishSpawningActor(ItemDrop, Transform);
+	return ItemDrop;
+}
+
+void UItemDropPoolSubsystem::ReleaseItemDrop(AItemDrop* ItemDrop)
+{
+	if (!IsValid(ItemDrop) || ItemDrop->IsPooled())
+	{
+		return;
+	}
+
+	const bool bReplicated = ItemDrop->GetIsReplicated();
+	if (!CanPoolItemDrops(bReplicated))
+	{
+		return;
+	}
+
+	FItemDropPool& Pool = (bReplicated ? ReplicatedPools : LocalPools).FindOrAdd(ItemDrop->GetClass());
+	if (!IsItemDropPoolingEnabled() || Pool.ItemDrops.Num() >= GetDefault<UGenericItemizationSettings>()->MaxPooledItemDropsPerClass)
+	{
+		ItemDrop->Destroy(true);
+		return;
+	}
+
+	ItemDrop->DeactivateToPool();
+	Pool.ItemDrops.Add(ItemDrop);
+}
+
+void UItemDropPoolSubsystem::PrewarmItemDrops(TSubclassOf<AItemDrop> ItemDropClass, int32 Count, bool bReplicated /*= true*/)
+{
+	if (!IsValid(ItemDropClass) || !IsItemDropPoolingEnabled() || !CanPoolItemDrops(bReplicated))
+	{
+		return;
+	}
+
+	FItemDropPool& Pool = (bReplicated ? ReplicatedPools : LocalPools).FindOrAdd(ItemDropClass);
+	const int32 TargetCount = FMath::Min(Count, GetDefault<UGenericItemizationSettings>()->MaxPooledItemDropsPerClass);
+	Pool.ItemDrops.Reserve(TargetCount);
+
+	while (Pool.ItemDrops.Num() < TargetCount)
+	{
+		// Spawned without replicating, so that Clients are never sent ItemDrops that are only waiting in the pool. See AItemDrop::ActivateFromPool.
+		AItemDrop* ItemDrop = SpawnItemDrop(ItemDropClass, FTransform::Identity, nullptr, nullptr, nullptr, false);
+		if (!ItemDrop)
+		{
+			break;
+		}
+
+		ItemDrop->DeactivateToPool();
+		Pool.ItemDrops.Add(ItemDrop);
+	}
+}
+
+int32 UItemDropPoolSubsystem::GetNumPooledItemDrops(TSubclassOf<AItemDrop> ItemDropClass, bool bReplicated /*= true*/) const
+{
+	const FItemDropPool* Pool = (bReplicated ? ReplicatedPools : LocalPools).Find(ItemDropClass);
+	return Pool ? Pool->ItemDrops.Num() : 0;
+}
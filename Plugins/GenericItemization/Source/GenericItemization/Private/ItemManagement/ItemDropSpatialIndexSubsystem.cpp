@@ -0,0 +1,360 @@
+// Copyright Fissure Entertainment, Pty Ltd. All Rights Reserved.
+
+#include "ItemManagement/ItemDropSpatialIndexSubsystem.h"
+#include "ItemManagement/ItemDrop.h"
+#include "ItemManagement/ItemDropManager.h"
+#include "GenericItemizationSettings.h"
+#include "GenericItemizationInstanceTypes.h"
+
+namespace ItemDropSpatialIndexPrivate
+{
+
+/**
+ * A ring walk usually finds the nearest ItemDrop and stops long before its outermost ring, while visiting the occupied cells always costs
+ * all of them. So the ring walk is only abandoned once its worst case visits this many times more cells than are occupied.
+ */
+static constexpr double RingWalkCostFactor = 8.0;
+
+/* Returns true if the ItemInstance is valid and passes the ItemTypes and QualityTypes of the Filter. */
+static bool MatchesItemInstance(const FItemInstance* ItemInstance, const FItemDropQueryFilter& Filter)
+{
+	return ItemInstance && ItemInstance->IsValid() && ItemInstance->MatchesTypes(Filter.ItemTypes, Filter.QualityTypes);
+}
+
+/* Calls the Visitor for each occupied cell within the box from MinCell to MaxCell. */
+template<typename EntryType>
+static void ForEachCellInBox(const TMap<FIntVector, TArray<EntryType>>& Cells, const FIntVector& MinCell, const FIntVector& MaxCell, TFunctionRef<void(const TArray<EntryType>&)> Visitor)
+{
+	const double NumBoxCells = double(MaxCell.X - MinCell.X + 1) * double(MaxCell.Y - MinCell.Y + 1) * double(MaxCell.Z - MinCell.Z + 1);
+	if (NumBoxCells > Cells.Num())
+	{
+		// The box covers more cells than are occupied, so only visit the occupied ones.
+		for (const TPair<FIntVector, TArray<EntryType>>& Cell : Cells)
+		{
+			if (Cell.Key.X >= MinCell.X && Cell.Key.X <= MaxCell.X
+				&& Cell.Key.Y >= MinCell.Y && Cell.Key.Y <= MaxCell.Y
+				&& Cell.Key.Z >= MinCell.Z && Cell.Key.Z <= MaxCell.Z)
+			{
+				Visitor(Cell.Value);
+			}
+		}
+
+		return;
+	}
+
+	for (int32 X = MinCell.X; X <= MaxCell.X; X++)
+	{
+		for (int32 Y = MinCell.Y; Y <= MaxCell.Y; Y++)
+		{
+			for (int32 Z = MinCell.Z; Z <= MaxCell.Z; Z++)
+			{
+				if (const TArray<EntryType>* CellEntries = Cells.Find(FIntVector(X, Y, Z)))
+				{
+					Visitor(*CellEntries);
+				}
+			}
+		}
+	}
+}
+
+}
+
+bool FItemDropQueryFilter::Matches(const AItemDrop& ItemDrop) const
+{
+	if (!ItemDropSpatialIndexPrivate::MatchesItemInstance(ItemDrop.GetItemInstancePtr(), *this))
+	{
+		return false;
+	}
+
+	return !TakingInventory || ItemDrop.CanTakeItem(TakingInventory);
+}
+
+bool FItemDropQueryFilter::Matches(const AItemDropManager& DropManager, const FItemDropRecord& Drop) const
+{
+	if (!ItemDropSpatialIndexPrivate::MatchesItemInstance(Drop.ItemInstance.GetPtr(), *this))
+	{
+		return false;
+	}
+
+	return !TakingInventory || DropManager.CanTakeDrop(Drop.DropId, TakingInventory);
+}
+
+void UItemDropSpatialIndexSubsystem::Deinitialize()
+{
+	Cells.Empty();
+	ItemDropCells.Empty();
+	RecordCells.Empty();
+	ItemDropRecordCells.Empty();
+
+	Super::Deinitialize();
+}
+
+bool UItemDropSpatialIndexSubsystem::FindItemDropsInRadius(FVector Origin, float Radius, const FItemDropQueryFilter& Filter, TArray<AItemDrop*>& OutItemDrops) const
+{
+	const int32 NumItemDrops = OutItemDrops.Num();
+	const double RadiusSquared = FMath::Square(static_cast<double>(Radius));
+
+	ForEachItemDropInBox(Origin, Radius, [&](AItemDrop& ItemDrop, const FVector& Location)
+	{
+		if (FVector::DistSquared(Origin, Location) <= RadiusSquared && Filter.Matches(ItemDrop))
+		{
+			OutItemDrops.Add(&ItemDrop);
+		}
+	});
+
+	return OutItemDrops.Num() > NumItemDrops;
+}
+
+bool UItemDropSpatialIndexSubsystem::FindItemDropRecordsInRadius(FVector Origin, float Radius, const FItemDropQueryFilter& Filter, TArray<FItemDropRecordRef>& OutDrops) const
+{
+	const int32 NumDrops = OutDrops.Num();
+	const double RadiusSquared = FMath::Square(static_cast<double>(Radius));
+
+	const FIntVector MinCell = GetCellForLocation(Origin - FVector(Radius));
+	const FIntVector MaxCell = GetCellForLocation(Origin + FVector(Radius));
+	ItemDropSpatialIndexPrivate::ForEachCellInBox<FIndexedItemDropRecord>(RecordCells, MinCell, MaxCell, [&](const TArray<FIndexedItemDropRecord>& CellRecords)
+	{
+		for (const FIndexedItemDropRecord& IndexedRecord : CellRecords)
+		{
+			AItemDropManager* DropManager = IndexedRecord.DropManager.Get();
+			if (!DropManager || FVector::DistSquared(Origin, IndexedRecord.Location) > RadiusSquared)
+			{
+				continue;
+			}
+
+			const FItemDropRecord* Drop = DropManager->FindDrop(IndexedRecord.DropId);
+			if (Drop && Filter.Matches(*DropManager, *Drop))
+			{
+				FItemDropRecordRef& DropRef = OutDrops.AddDefaulted_GetRef();
+				DropRef.DropManager = DropManager;
+				DropRef.DropId = IndexedRecord.DropId;
+			}
+		}
+	});
+
+	return OutDrops.Num() > NumDrops;
+}
+
+void UItemDropSpatialIndexSubsystem::FindItemDropsInRadiusBatch(const TArray<FItemDropRadiusQuery>& Queries, TArray<FItemDropQueryResult>& OutResults) const
+{
+	OutResults.SetNum(Queries.Num());
+
+	TArray<AItemDrop*> ItemDrops;
+	for (int32 QueryIndex = 0; QueryIndex < Queries.Num(); QueryIndex++)
+	{
+		const FItemDropRadiusQuery& Query = Queries[QueryIndex];
+
+		ItemDrops.Reset();
+		FindItemDropsInRadius(Query.Origin, Query.Radius, Query.Filter, ItemDrops);
+		OutResults[QueryIndex].ItemDrops = ItemDrops;
+	}
+}
+
+AItemDrop* UItemDropSpatialIndexSubsystem::FindNearestItemDrop(FVector Origin, float MaxRadius, const FItemDropQueryFilter& Filter) const
+{
+	AItemDrop* NearestItemDrop = nullptr;
+	double NearestDistanceSquared = FMath::Square(static_cast<double>(MaxRadius));
+
+	auto ConsiderItemDrop = [&](AItemDrop& ItemDrop, const FVector& Location)
+	{
+		const double DistanceSquared = FVector::DistSquared(Origin, Location);
+		if (DistanceSquared <= NearestDistanceSquared && Filter.Matches(ItemDrop))
+		{
+			NearestItemDrop = &ItemDrop;
+			NearestDistanceSquared = DistanceSquared;
+		}
+	};
+
+	const double CellSize = GetCellSize();
+	const int32 MaxRing = FMath::CeilToInt32(MaxRadius / CellSize);
+
+	// Walking every ring outwards would visit far more cells than there are occupied ones, so just visit those instead.
+	if (FMath::Cube(2.0 * MaxRing + 1.0) > Cells.Num() * ItemDropSpatialIndexPrivate::RingWalkCostFactor)
+	{
+		ForEachItemDropInBox(Origin, MaxRadius, ConsiderItemDrop);
+		return NearestItemDrop;
+	}
+
+	const FIntVector OriginCell = GetCellForLocation(Origin);
+	for (int32 Ring = 0; Ring <= MaxRing; Ring++)
+	{
+		ForEachItemDropInRing(OriginCell, Ring, ConsiderItemDrop);
+
+		// Everything in the rings further out is at least this far away.
+		if (NearestItemDrop && NearestDistanceSquared <= FMath::Square(Ring * CellSize))
+		{
+			break;
+		}
+	}
+
+	return NearestItemDrop;
+}
+
+void UItemDropSpatialIndexSubsystem::AddItemDrop(AItemDrop* ItemDrop)
+{
+	if (!IsValid(ItemDrop) || ItemDropCells.Contains(ItemDrop))
+	{
+		return;
+	}
+
+	const FVector Location = ItemDrop->GetActorLocation();
+	const FIntVector Cell = GetCellForLocation(Location);
+
+	Cells.FindOrAdd(Cell).Add({ ItemDrop, Location });
+	ItemDropCells.Add(ItemDrop, Cell);
+}
+
+void UItemDropSpatialIndexSubsystem::UpdateItemDrop(AItemDrop* ItemDrop)
+{
+	FIntVector* IndexedCell = ItemDrop ? ItemDropCells.Find(ItemDrop) : nullptr;
+	if (!IndexedCell)
+	{
+		return;
+	}
+
+	const FVector Location = ItemDrop->GetActorLocation();
+	const FIntVector Cell = GetCellForLocation(Location);
+
+	if (Cell == *IndexedCell)
+	{
+		if (TArray<FIndexedItemDrop>* CellItemDrops = Cells.Find(Cell))
+		{
+			if (FIndexedItemDrop* IndexedItemDrop = CellItemDrops->FindByPredicate([ItemDrop](const FIndexedItemDrop& Entry) { return Entry.ItemDrop.Get() == ItemDrop; }))
+			{
+				IndexedItemDrop->Location = Location;
+			}
+		}
+
+		return;
+	}
+
+	RemoveFromCell(*IndexedCell, ItemDrop);
+	Cells.FindOrAdd(Cell).Add({ ItemDrop, Location });
+	*IndexedCell = Cell;
+}
+
+void UItemDropSpatialIndexSubsystem::RemoveItemDrop(AItemDrop* ItemDrop)
+{
+	FIntVector Cell;
+	if (ItemDrop && ItemDropCells.RemoveAndCopyValue(ItemDrop, Cell))
+	{
+		RemoveFromCell(Cell, ItemDrop);
+	}
+}
+
+void UItemDropSpatialIndexSubsystem::AddItemDropRecord(AItemDropManager* DropManager, const FItemDropRecord& Drop)
+{
+	if (!IsValid(DropManager) || ItemDropRecordCells.Contains(Drop.DropId))
+	{
+		return;
+	}
+
+	const FIntVector Cell = GetCellForLocation(Drop.Location);
+
+	RecordCells.FindOrAdd(Cell).Add({ DropManager, Drop.DropId, Drop.Location });
+	ItemDropRecordCells.Add(Drop.DropId, Cell);
+}
+
+void UItemDropSpatialIndexSubsystem::RemoveItemDropRecord(const FGuid& DropId)
+{
+	FIntVector Cell;
+	if (!ItemDropRecordCells.RemoveAndCopyValue(DropId, Cell))
+	{
+		return;
+	}
+
+	TArray<FIndexedItemDropRecord>* CellRecords = RecordCells.Find(Cell);
+	if (!CellRecords)
+	{
+		return;
+	}
+
+	const int32 Index = CellRecords->IndexOfByPredicate([&DropId](const FIndexedItemDropRecord& Entry) { return Entry.DropId == DropId; });
+	if (Index != INDEX_NONE)
+	{
+		CellRecords->RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	}
+
+	if (CellRecords->IsEmpty())
+	{
+		RecordCells.Remove(Cell);
+	}
+}
+
+void UItemDropSpatialIndexSubsystem::RemoveFromCell(const FIntVector& Cell, const AItemDrop* ItemDrop)
+{
+	TArray<FIndexedItemDrop>* CellItemDrops = Cells.Find(Cell);
+	if (!CellItemDrops)
+	{
+		return;
+	}
+
+	const int32 Index = CellItemDrops->IndexOfByPredicate([ItemDrop](const FIndexedItemDrop& Entry) { return Entry.ItemDrop.Get() == ItemDrop; });
+	if (Index != INDEX_NONE)
+	{
+		CellItemDrops->RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	}
+
+	if (CellItemDrops->IsEmpty())
+	{
+		Cells.Remove(Cell);
+	}
+}
+
+FIntVector UItemDropSpatialIndexSubsystem::GetCellForLocation(const FVector& Location) const
+{
+	const double CellSize = GetCellSize();
+	return FIntVector(
+		FMath::FloorToInt32(Location.X / CellSize),
+		FMath::FloorToInt32(Location.Y / CellSize),
+		FMath::FloorToInt32(Location.Z / CellSize));
+}
+
+double UItemDropSpatialIndexSubsystem::GetCellSize() const
+{
+	return FMath::Max(GetDefault<UGenericItemizationSettings>()->ItemDropSpatialIndexCellSize, 1.0f);
+}
+
+void UItemDropSpatialIndexSubsystem::ForEachItemDropInBox(const FVector& Origin, double Extent, TFunctionRef<void(AItemDrop&, const FVector&)> Visitor) const
+{
+	const FIntVector MinCell = GetCellForLocation(Origin - FVector(Extent));
+	const FIntVector MaxCell = GetCellForLocation(Origin + FVector(Extent));
+
+	ItemDropSpatialIndexPrivate::ForEachCellInBox<FIndexedItemDrop>(Cells, MinCell, MaxCell, [&Visitor](const TArray<FIndexedItemDrop>& CellItemDrops)
+	{
+		for (const FIndexedItemDrop& IndexedItemDrop : CellItemDrops)
+		{
+			if (AItemDrop* ItemDrop = IndexedItemDrop.ItemDrop.Get())
+			{
+				Visitor(*ItemDrop, IndexedItemDrop.Location);
+			}
+		}
+	});
+}
+
+void UItemDropSpatialIndexSubsystem::ForEachItemDropInRing(const FIntVector& Cell, int32 Ring, TFunctionRef<void(AItemDrop&, const FVector&)> Visitor) const
+{
+	for (int32 X = -Ring; X <= Ring; X++)
+	{
+		for (int32 Y = -Ring; Y <= Ring; Y++)
+		{
+			// Only the cells on the surface of the cube are in this Ring, the ones inside were visited by the smaller Rings.
+			const bool bOnSurfaceXY = FMath::Abs(X) == Ring || FMath::Abs(Y) == Ring;
+			const int32 ZStep = bOnSurfaceXY ? 1 : FMath::Max(2 * Ring, 1);
+
+			for (int32 Z = -Ring; Z <= Ring; Z += ZStep)
+			{
+				if (const TArray<FIndexedItemDrop>* CellItemDrops = Cells.Find(Cell + FIntVector(X, Y, Z)))
+				{
+					for (const FIndexedItemDrop& IndexedItemDrop : *CellItemDrops)
+					{
+						if (AItemDrop* ItemDrop = IndexedItemDrop.ItemDrop.Get())
+						{
+							Visitor(*ItemDrop, IndexedItemDrop.Location);
+						}
+					}
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,186 @@
+// Copyright Fissure Entertainment, Pty Ltd. All Rights Reserved.
+
+#include "ItemManagement/ItemDropSpawnSubsystem.h"
+#include "ItemManagement/ItemDrop.h"
+#include "ItemManagement/ItemDropperComponent.h"
+#include "ItemManagement/ItemDropPoolSubsystem.h"
+#include "GenericItemizationSettings.h"
+#include "GameFramework/PlayerController.h"
+#include "Engine/World.h"
+
+namespace ItemDropSpawnSubsystemPrivate
+{
+
+/* Orders the PendingSpawns heap so that the lowest Priority, the closest to a player, is spawned first. */
+static bool SpawnRequestPredicate(const FItemDropSpawnRequest& A, const FItemDropSpawnRequest& B)
+{
+	return A.Priority < B.Priority;
+}
+
+static double ComputeSpawnPriority(const FVector& Location, TConstArrayView<FVector> PlayerLocations)
+{
+	double Priority = PlayerLocations.IsEmpty() ? 0.0 : TNumericLimits<double>::Max();
+	for (const FVector& PlayerLocation : PlayerLocations)
+	{
+		Priority = FMath::Min(Priority, FVector::DistSquared(PlayerLocation, Location));
+	}
+
+	return Priority;
+}
+
+}
+
+void UItemDropSpawnSubsystem::Deinitialize()
+{
+	PendingSpawns.Empty();
+
+	Super::Deinitialize();
+}
+
+bool UItemDropSpawnSubsystem::IsTickable() const
+{
+	return !PendingSpawns.IsEmpty();
+}
+
+TStatId UItemDropSpawnSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UItemDropSpawnSubsystem, STATGROUP_Tickables);
+}
+
+void UItemDropSpawnSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	const double BudgetSeconds = GetDefault<UGenericItemizationSettings>()->ItemDropSpawnBudgetMs / 1000.0;
+	const double StartTime = FPlatformTime::Seconds();
+
+	// Players move slowly compared to how quickly the queue drains, so the heap is only rebuilt every so often. This counts against the budget too.
+	const double WorldTime = GetWorld()->GetTimeSeconds();
+	if (WorldTime - LastPrioritizeTime >= PrioritizeInterval)
+	{
+		LastPrioritizeTime = WorldTime;
+		PrioritizePendingSpawns();
+	}
+
+	// At least one ItemDrop is always spawned, so that the queue keeps moving no matter the budget.
+	do
+	{
+		SpawnNextItemDrop();
+	}
+	while (!PendingSpawns.IsEmpty() && FPlatformTime::Seconds() - StartTime < BudgetSeconds);
+}
+
+bool UItemDropSpawnSubsystem::IsItemDropSpawnSchedulingEnabled()
+{
+	return GetDefault<UGenericItemizationSettings>()->bScheduleItemDropSpawns;
+}
+
+bool UItemDropSpawnSubsystem::ShouldScatterItemDrops()
+{
+	const UGenericItemizationSettings* Settings = GetDefault<UGenericItemizationSettings>();
+	return Settings->bScheduleItemDropSpawns || Settings->bScatterItemDrops;
+}
+
+void UItemDropSpawnSubsystem::ComputeScatteredLocations(const FVector& Origin, int32 Count, TArray<FVector>& OutLocations)
+{
+	const double Spacing = GetDefault<UGenericItemizationSettings>()->ItemDropScatterSpacing;
+	const double GoldenAngle = UE_DOUBLE_PI * (3.0 - FMath::Sqrt(5.0));
+
+	OutLocations.Reserve(OutLocations.Num() + Count);
+	for (int32 Index = 0; Index < Count; Index++)
+	{
+		const double Radius = Spacing * FMath::Sqrt(static_cast<double>(Index));
+		const double Angle = GoldenAngle * Index;
+		OutLocations.Add(Origin + FVector(FMath::Cos(Angle) * Radius, FMath::Sin(Angle) * Radius, 0.0));
+	}
+}
+
+void UItemDropSpawnSubsystem::QueueItemDrops(UItemDropperComponent* Dropper, TSubclassOf<AItemDrop> ItemDropClass, const FTransform& Transform, AActor* Owner, TArray<FInstancedStruct>&& ItemInstances)
+{
+	const UWorld* World = GetWorld();
+	if (!World || World->GetNetMode() == NM_Client || !IsValid(ItemDropClass))
+	{
+		return;
+	}
+
+	TArray<FVector> Locations;
+	ComputeScatteredLocations(Transform.GetLocation(), ItemInstances.Num(), Locations);
+
+	TArray<FVector, TInlineAllocator<8>> PlayerLocations;
+	GetPlayerLocations(PlayerLocations);
+
+	PendingSpawns.Reserve(PendingSpawns.Num() + ItemInstances.Num());
+	for (int32 Index = 0; Index < ItemInstances.Num(); Index++)
+	{
+		FItemDropSpawnRequest Request;
+		Request.ItemInstance = MoveTemp(ItemInstances[Index]);
+		Request.ItemDropClass = ItemDropClass;
+		Request.Transform = FTransform(Transform.GetRotation(), Locations[Index]);
+		Request.Owner = Owner;
+		Request.Dropper = Dropper;
+		Request.Priority = ItemDropSpawnSubsystemPrivate::ComputeSpawnPriority(Locations[Index], PlayerLocations);
+		PendingSpawns.HeapPush(MoveTemp(Request), ItemDropSpawnSubsystemPrivate::SpawnRequestPredicate);
+	}
+
+	ItemInstances.Reset();
+}
+
+void UItemDropSpawnSubsystem::FlushItemDropSpawns()
+{
+	while (!PendingSpawns.IsEmpty())
+	{
+		SpawnNextItemDrop();
+	}
+}
+
+void UItemDropSpawnSubsystem::GetPlayerLocations(TArray<FVector, TInlineAllocator<8>>& OutPlayerLocations) const
+{
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PlayerController = It->Get();
+		if (PlayerController)
+		{
+			FVector ViewLocation;
+			FRotator ViewRotation;
+			PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+			OutPlayerLocations.Add(ViewLocation);
+		}
+	}
+}
+
+void UItemDropSpawnSubsystem::PrioritizePendingSpawns()
+{
+	TArray<FVector, TInlineAllocator<8>> PlayerLocations;
+	GetPlayerLocations(PlayerLocations);
+
+	// Without any players there is nothing to prioritize by, so the queue is left as it is.
+	if (PlayerLocations.IsEmpty())
+	{
+		return;
+	}
+
+	for (FItemDropSpawnRequest& Request : PendingSpawns)
+	{
+		Request.Priority = ItemDropSpawnSubsystemPrivate::ComputeSpawnPriority(Request.Transform.GetLocation(), PlayerLocations);
+	}
+
+	PendingSpawns.Heapify(ItemDropSpawnSubsystemPrivate::SpawnRequestPredicate);
+}
+
+void UItemDropSpawnSubsystem::SpawnNextItemDrop()
+{
+	FItemDropSpawnRequest Request;
+	PendingSpawns.HeapPop(Request, ItemDropSpawnSubsystemPrivate::SpawnRequestPredicate, EAllowShrinking::No);
+
+	UItemDropPoolSubsystem* ItemDropPool = GetWorld()->GetSubsystem<UItemDropPoolSubsystem>();
+	if (!ItemDropPool)
+	{
+		return;
+	}
+
+	AItemDrop* ItemDrop = ItemDropPool->AcquireItemDrop(Request.ItemDropClass, Request.Transform, Request.Owner.Get(), Request.ItemInstance);
+	if (IsValid(ItemDrop) && Request.Dropper.IsValid())
+	{
+		Request.Dropper->OnItemDropSpawnedDelegate.Broadcast(Request.Dropper.Get(), ItemDrop);
+	}
+}
@@ -3,7 +3,27 @@
 #include "ItemManagement/ItemDropperComponent.h"
 #include "ItemManagement/ItemDrop.h"
 #include "ItemManagement/ItemInstancer.h"
-#include "Kismet/GameplayStatics.h"
+#include "ItemManagement/ItemDropManagerSubsystem.h"
+#include "ItemManagement/ItemDropPoolSubsystem.h"
+#include "ItemManagement/ItemDropSpawnSubsystem.h"
+
+namespace ItemDropperComponentPrivate
+{
+
+/* Returns where each of the Count ItemDrops dropped at the Origin is placed. They all share the Origin unless ItemDrops are scattered. */
+static void GetDropLocations(const FVector& Origin, int32 Count, TArray<FVector>& OutLocations)
+{
+	if (UItemDropSpawnSubsystem::ShouldScatterItemDrops())
+	{
+		UItemDropSpawnSubsystem::ComputeScatteredLocations(Origin, Count, OutLocations);
+	}
+	else
+	{
+		OutLocations.Init(Origin, Count);
+	}
+}
+
+}
 
 UItemDropperComponent::UItemDropperComponent()
 {
@@ -29,13 +49,48 @@ bool UItemDropperComponent::DropItems_Implementation(FInstancedStruct UserContex
 	TArray<FInstancedStruct> ItemInstances;
 	if(ItemInstancer->GenerateItems(UserContextData, ItemInstances))
 	{
-		for (const FInstancedStruct& ItemInstance : ItemInstances)
+		// Drops are owned by the ItemDropManager for our cell instead of each being their own Actor.
+		UItemDropManagerSubsystem* DropManagerSubsystem = GetWorld()->GetSubsystem<UItemDropManagerSubsystem>();
+		if (DropManagerSubsystem && UItemDropManagerSubsystem::AreItemDropManagersEnabled())
+		{
+			TArray<FVector> Locations;
+			ItemDropperComponentPrivate::GetDropLocations(GetOwner()->GetActorLocation(), ItemInstances.Num(), Locations);
+
+			int32 NumDropped = 0;
+			for (int32 Index = 0; Index < ItemInstances.Num(); Index++)
+			{
+				AItemDropManager* DropManager = nullptr;
+				if (DropManagerSubsystem->DropItem(ItemInstances[Index], Locations[Index], DropManager).IsValid())
+				{
+					NumDropped++;
+				}
+			}
+
+			return NumDropped > 0;
+		}
+
+		// Spawning is spread over the next frames, the ItemDrops are passed out through OnItemDropSpawnedDelegate.
+		UItemDropSpawnSubsystem* DropSpawnSubsystem = GetWorld()->GetSubsystem<UItemDropSpawnSubsystem>();
+		if (DropSpawnSubsystem && UItemDropSpawnSubsystem::IsItemDropSpawnSchedulingEnabled())
+		{
+			const FTransform DropTransform = FTransform(GetOwner()->GetActorRotation(), GetOwner()->GetActorLocation());
+			DropSpawnSubsystem->QueueItemDrops(this, ItemDropClass, DropTransform, GetOwner(), MoveTemp(ItemInstances));
+			return true;
+		}
+
+		UItemDropPoolSubsystem* ItemDropPool = GetWorld()->GetSubsystem<UItemDropPoolSubsystem>();
+		if (!ItemDropPool)
+		{
+			return false;
+		}
+
+		TArray<FVector> Locations;
+		ItemDropperComponentPrivate::GetDropLocations(GetOwner()->GetActorLocation(), ItemInstances.Num(), Locations);
+
+		for (int32 Index = 0; Index < ItemInstances.Num(); Index++)
 		{
-			AItemDrop* ItemDrop = nullptr;
-			const FTransform SpawnTransform = FTransform(GetOwner()->GetActorRotation(), GetOwner()->GetActorLocation());
-			ItemDrop = GetWorld()->SpawnActorDeferred<AItemDrop>(ItemDropClass, SpawnTransform, GetOwner(), nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
-			ItemDrop->ItemInstance.InitializeAsScriptStruct(ItemInstance.GetScriptStruct(), ItemInstance.GetMemory());
-			UGameplayStatics::FinishSpawningActor(ItemDrop, SpawnTransform);
+			const FTransform SpawnTransform = FTransform(GetOwner()->GetActorRotation(), Locations[Index]);
+			AItemDrop* ItemDrop = ItemDropPool->AcquireItemDrop(ItemDropClass, SpawnTransform, GetOwner(), ItemInstances[Index]);
 
 			// Pass out the new ItemDrop.
 			if (IsValid(ItemDrop))
@@ -51,12 +51,12 @@ bool UItemInstancer::GenerateItems_Implementation(FInstancedStruct UserContextDa
 				FInstancedStruct ItemInstance;
 				if (UGenericItemizationStatics::GenerateItemInstanceFromItemDefinition(ItemDefinitionHandle, ItemInstancingContext, ItemInstance))
 				{
-					ItemInstances.Add(ItemInstance);
+					ItemInstances.Add(MoveTemp(ItemInstance));
 				}
 			}
 
-			OutItemInstances = ItemInstances;
-			return ItemInstances.Num() > 0;
+			OutItemInstances = MoveTemp(ItemInstances);
+			return OutItemInstances.Num() > 0;
 		}
 	}
 
@@ -2,12 +2,21 @@
 
 #include "ItemManagement/ItemInventoryComponent.h"
 #include "Net/UnrealNetwork.h"
-#include "Kismet/GameplayStatics.h"
 #include "ItemManagement/ItemDrop.h"
+#include "ItemManagement/ItemDropManager.h"
+#include "ItemManagement/ItemDropPoolSubsystem.h"
 #include "GenericItemizationStatics.h"
 #include "ItemManagement/ItemStackSettings.h"
 #include "GenericItemizationTags.h"
 #include "ItemManagement/ItemInstancer.h"
+#include "ItemManagement/ItemInventorySerialization.h"
+#include "ItemManagement/ItemInventoryTab.h"
+#include "Engine/ActorChannel.h"
+#include "Net/Core/PushModel/PushModel.h"
+#include "Engine/NetConnection.h"
+#include "Engine/ChildConnection.h"
+#include "GameFramework/PlayerController.h"
+#include "Net/NetworkSubsystem.h"
 
 UItemInventoryComponent::UItemInventoryComponent()
 {
@@ -29,8 +38,22 @@ void UItemInventoryComponent::GetLifetimeReplicatedProps(TArray<FLifetimePropert
 	FDoRepLifetimeParams SharedParams;
 	SharedParams.bIsPushBased = true;
 
+	// The ReplicationPolicy is per instance, so the actual condition is set in OnRegister, see UpdateItemInstancesCondition.
+	SharedParams.Condition = COND_Dynamic;
+
 	// Technically, this doesn't need to be PushModel based because it's a FastArray and they ignore it, but it can't hurt.
 	DOREPLIFETIME_WITH_PARAMS_FAST(UItemInventoryComponent, ItemInstances, SharedParams);
+
+	// The grid is only as visible as the ItemInstances it places.
+	DOREPLIFETIME_WITH_PARAMS_FAST(UItemInventoryComponent, Grid, SharedParams);
+
+	// Tabs are only ever viewed by the owner, and each tab is only written to it while it is subscribed.
+	SharedParams.Condition = COND_OwnerOnly;
+	DOREPLIFETIME_WITH_PARAMS_FAST(UItemInventoryComponent, Tabs, SharedParams);
+
+	// The owner always receives the full ItemInstances, so it never needs the summary.
+	SharedParams.Condition = COND_SkipOwner;
+	DOREPLIFETIME_WITH_PARAMS_FAST(UItemInventoryComponent, PublicSummary, SharedParams);
 }
 
 void UItemInventoryComponent::PreNetReceive()
@@ -52,6 +75,21 @@ void UItemInventoryComponent::OnRegister()
 	CacheIsNetSimulated();
 
 	ItemInstances.Register(this);
+	Grid.Register(this, GridSize);
+
+	UpdateItemInstancesCondition();
+}
+
+void UItemInventoryComponent::UpdateItemInstancesCondition()
+{
+	// Policies that never send the ItemInstances to anyone but the owner are also expressed as a condition. This skips the
+	// property entirely for other Connections, and is what enforces the policy under Iris where NetDeltaSerialize is not used.
+	// OwnerAndParty can't be expressed as a property condition, the whole Inventory is put in the party net condition group instead, see ReadyForReplication.
+	const bool bOwnerOnlyItemInstances = ReplicationPolicy == EItemInventoryReplicationPolicy::OwnerOnly || ReplicationPolicy == EItemInventoryReplicationPolicy::PublicSummaryOnly;
+	const ELifetimeCondition Condition = bOwnerOnlyItemInstances ? COND_OwnerOnly : COND_None;
+
+	DOREPDYNAMICCONDITION_SETCONDITION_FAST(UItemInventoryComponent, ItemInstances, Condition);
+	DOREPDYNAMICCONDITION_SETCONDITION_FAST(UItemInventoryComponent, Grid, Condition);
 }
 
 void UItemInventoryComponent::BeginPlay()
@@ -60,13 +98,74 @@ void UItemInventoryComponent::BeginPlay()
 
 	// Cache net role here as well since for map-placed actors on clients, the Role may not be set correctly yet in OnRegister.
 	CacheIsNetSimulated();
+
+	if (HasAuthority())
+	{
+		while (Tabs.Num() < InitialNumTabs)
+		{
+			AddTab();
+		}
+	}
+}
+
+void UItemInventoryComponent::ReadyForReplication()
+{
+	Super::ReadyForReplication();
+
+	// The party is only replicated to with COND_NetGroup, which only applies to SubObjects, so the Inventory Component itself is registered in the group.
+	// Only the owner and its party are members of it, so everyone else never receives the Inventory.
+	if (ReplicationPolicy == EItemInventoryReplicationPolicy::OwnerAndParty && HasAuthority())
+	{
+		if (UNetworkSubsystem* const NetworkSubsystem = GetWorld() ? GetWorld()->GetSubsystem<UNetworkSubsystem>() : nullptr)
+		{
+			NetworkSubsystem->GetNetConditionGroupManager().RegisterSubObjectInGroup(this, GetPartyNetConditionGroup());
+		}
+
+		GetOwner()->SetReplicatedComponentNetCondition(this, COND_NetGroup);
+
+		const UNetConnection* const OwningConnection = GetOwner()->GetNetConnection();
+		AddPartyMember(OwningConnection ? OwningConnection->PlayerController.Get() : nullptr);
+	}
+
+	// Only subscribed tabs are registered, so that Iris, which never asks the tabs whether to replicate, leaves the others alone.
+	// Tabs subscribed to after this are registered as they are subscribed to.
+	if (IsUsingRegisteredSubObjectList())
+	{
+		for (const int32 Tab : SubscribedTabs)
+		{
+			if (UItemInventoryTab* const InventoryTab = GetTab(Tab))
+			{
+				AddReplicatedSubObject(InventoryTab, COND_OwnerOnly);
+			}
+		}
+	}
+}
+
+bool UItemInventoryComponent::ReplicateSubobjects(UActorChannel* Channel, FOutBunch* Bunch, FReplicationFlags* RepFlags)
+{
+	bool bWroteSomething = Super::ReplicateSubobjects(Channel, Bunch, RepFlags);
+
+	if (RepFlags->bNetOwner)
+	{
+		for (UItemInventoryTab* Tab : Tabs)
+		{
+			if (Tab)
+			{
+				bWroteSomething |= Channel->ReplicateSubobject(Tab, *Bunch, *RepFlags);
+			}
+		}
+	}
+
+	return bWroteSomething;
 }
 
 bool UItemInventoryComponent::CanTakeItem_Implementation(const FInstancedStruct& Item, FInstancedStruct UserContextData)
 {
 	if (Item.IsValid() && Item.GetPtr<FItemInstance>() && Item.Get<FItemInstance>().IsValid())
 	{
-		return true;
+		// Items that do not fit anywhere within the grid cannot be taken.
+		FIntPoint GridLocation;
+		return !bUseGridLayout || FindGridLocationForItem(Item, GridLocation);
 	}
 
 	return false;
@@ -84,8 +183,8 @@ bool UItemInventoryComponent::TakeItem(FInstancedStruct& Item, FInstancedStruct
 		return false;
 	}
 
-	// Capture the ItemInstance so that we can take it and manage it thereafter.
-	ItemInstances.AddItemInstance(Item, UserContextData);
+	// Capture the ItemInstance so that we can take it and manage it thereafter, the caller's Item is left as it was.
+	AddOrStackItemInstance(FInstancedStruct(Item), MoveTemp(UserContextData));
 
 	return true;
 }
@@ -102,7 +201,14 @@ bool UItemInventoryComponent::TakeItemDrop(AItemDrop* ItemDrop, FInstancedStruct
 		return false;
 	}
 
-	// Capture the ItemInstance from the ItemDrop so that we can take it and manage it thereafter.
+	// ItemDrops that are only visualizing a drop owned by an ItemDropManager are taken from the drop itself.
+	FGuid DropId;
+	if (AItemDropManager* DropManager = ItemDrop->GetDropManager(DropId))
+	{
+		return TakeItemDropRecord(DropManager, DropId, UserContextData);
+	}
+
+	// CanTakeItem is given a copy, as it takes an FInstancedStruct. The ItemInstance itself is only moved out of the ItemDrop once it can be taken.
 	FInstancedStruct ItemInstance;
 	ItemInstance.InitializeAs(ItemDrop->ItemInstance.GetScriptStruct(), ItemDrop->ItemInstance.GetMemory());
 
@@ -111,45 +217,139 @@ bool UItemInventoryComponent::TakeItemDrop(AItemDrop* ItemDrop, FInstancedStruct
 		return false;
 	}
 
-	ItemInstances.AddItemInstance(ItemInstance, UserContextData);
+	AddOrStackItemInstance(MoveTemp(ItemDrop->ItemInstance), MoveTemp(UserContextData));
 
-	ItemDrop->ItemInstance.Reset(); // This is critical, we need to Reset the Instanced Struct on the ItemDrop, as we are actually making a logical transfer of ownership to the Inventory Component.
+	ItemDrop->ResetItemInstance(); // This is critical, we need to Reset the Instanced Struct on the ItemDrop, as we are actually making a logical transfer of ownership to the Inventory Component.
 
 	if (bDestroyItemDrop)
 	{
-		ItemDrop->Destroy(true);
+		ItemDrop->ReleaseToPool();
 	}
 
 	return true;
 }
 
-bool UItemInventoryComponent::DropItem_Implementation(FGuid ItemToDrop, AItemDrop*& OutItemDrop)
+bool UItemInventoryComponent::TakeItemDropRecord(AItemDropManager* DropManager, FGuid DropId, FInstancedStruct UserContextData)
+{
+	if (!HasAuthority() || !IsValid(DropManager))
+	{
+		return false;
+	}
+
+	const FItemDropRecord* Drop = DropManager->FindDrop(DropId);
+	if (!Drop || !Drop->ItemInstance.IsValid())
+	{
+		return false;
+	}
+
+	// CanTakeItem is given a copy, as it takes an FInstancedStruct. The ItemInstance itself is only moved out of the drop once it can be taken.
+	FInstancedStruct ItemInstance;
+	ItemInstance.InitializeAs(Drop->ItemInstance.GetScriptStruct(), Drop->ItemInstance.GetMemory());
+
+	if (!DropManager->CanTakeDrop(DropId, this) || !CanTakeItem(ItemInstance, UserContextData))
+	{
+		return false;
+	}
+
+	// This is critical, we need to remove the drop from the ItemDropManager, as we are actually making a logical transfer of ownership to the Inventory Component.
+	TInstancedStruct<FItemInstance> RemovedItemInstance;
+	if (!DropManager->RemoveDrop(DropId, RemovedItemInstance))
+	{
+		return false;
+	}
+
+	AddOrStackItemInstance(MoveTemp(RemovedItemInstance), MoveTemp(UserContextData));
+
+	return true;
+}
+
+void UItemInventoryComponent::RequestTakeItemDropRecord(AItemDropManager* DropManager, FGuid DropId)
 {
 	if (HasAuthority())
 	{
-		// Capture the ItemInstance from the managed container so that it can be dropped.
-		FInstancedStruct ItemInstance;
-		for (FFastItemInstance& FastItemInstance : ItemInstances)
+		ServerTakeItemDropRecord_Implementation(DropManager, DropId);
+		return;
+	}
+
+	ServerTakeItemDropRecord(DropManager, DropId);
+}
+
+void UItemInventoryComponent::ServerTakeItemDropRecord_Implementation(AItemDropManager* DropManager, FGuid DropId)
+{
+	// Any Client can name any drop, so the request is rejected here before anything is taken.
+	if (!IsValid(DropManager) || !DropManager->CanTakeDrop(DropId, this))
+	{
+		return;
+	}
+
+	TakeItemDropRecord(DropManager, DropId, FInstancedStruct());
+}
+
+int32 UItemInventoryComponent::TakeItemDropsInRadius(FVector Origin, float Radius, FItemDropQueryFilter Filter, FInstancedStruct UserContextData)
+{
+	const UItemDropSpatialIndexSubsystem* SpatialIndex = GetWorld()->GetSubsystem<UItemDropSpatialIndexSubsystem>();
+	if (!HasAuthority() || !SpatialIndex)
+	{
+		return 0;
+	}
+
+	Filter.TakingInventory = this;
+
+	TArray<AItemDrop*> ItemDrops;
+	const bool bFoundItemDrops = SpatialIndex->FindItemDropsInRadius(Origin, Radius, Filter, ItemDrops);
+
+	// Drops owned by an ItemDropManager are indexed by the Server on their own, as a dedicated Server has no ItemDrops visualizing them.
+	TArray<FItemDropRecordRef> Drops;
+	const bool bFoundDrops = SpatialIndex->FindItemDropRecordsInRadius(Origin, Radius, Filter, Drops);
+
+	if (!bFoundItemDrops && !bFoundDrops)
+	{
+		return 0;
+	}
+
+	FItemInventoryTransaction Transaction(this);
+
+	int32 NumTaken = 0;
+	for (AItemDrop* ItemDrop : ItemDrops)
+	{
+		// ItemDrops visualizing a drop of an ItemDropManager, which exist on a listen Server, are taken through the drop below.
+		FGuid DropId;
+		if (ItemDrop->GetDropManager(DropId))
 		{
-			const FItemInstance* const ItemInstancePtr = FastItemInstance.ItemInstance.GetPtr<FItemInstance>();
-			if (FastItemInstance.ItemInstance.IsValid() && ItemInstancePtr && ItemInstancePtr->ItemId == ItemToDrop)
-			{
-				ItemInstance = FastItemInstance.ItemInstance;
-				ItemInstances.RemoveItemInstance(ItemToDrop); // This is critical, we must remove the ItemInstance from the Inventory, since we are just copying the data here, we are actually making a logical transfer of ownership to the ItemDrop.
-				break;
-			}
+			continue;
 		}
 
-		if(ItemInstance.IsValid())
+		if (TakeItemDrop(ItemDrop, UserContextData))
 		{
-			AItemDrop* ItemDrop = nullptr;
-			const FTransform SpawnTransform = FTransform(GetOwner()->GetActorRotation(), GetOwner()->GetActorLocation());
-			ItemDrop = GetWorld()->SpawnActorDeferred<AItemDrop>(ItemDropClass, SpawnTransform, GetOwner(), nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
-			ItemDrop->ItemInstance.InitializeAsScriptStruct(ItemInstance.GetScriptStruct(), ItemInstance.GetMemory());
-			UGameplayStatics::FinishSpawningActor(ItemDrop, SpawnTransform);
+			NumTaken++;
+		}
+	}
 
-			OutItemDrop = ItemDrop;
-			return true;
+	for (const FItemDropRecordRef& Drop : Drops)
+	{
+		if (TakeItemDropRecord(Drop.DropManager, Drop.DropId, UserContextData))
+		{
+			NumTaken++;
+		}
+	}
+
+	return NumTaken;
+}
+
+bool UItemInventoryComponent::DropItem_Implementation(FGuid ItemToDrop, AItemDrop*& OutItemDrop)
+{
+	if (HasAuthority())
+	{
+		// Move the ItemInstance out of the managed container so that it can be dropped, we are making a logical transfer of ownership to the ItemDrop.
+		FInstancedStruct ItemInstance;
+		ItemInstances.RemoveItemInstance(ItemToDrop, ItemInstance);
+
+		UItemDropPoolSubsystem* ItemDropPool = GetWorld()->GetSubsystem<UItemDropPoolSubsystem>();
+		if(ItemInstance.IsValid() && ItemDropPool)
+		{
+			const FTransform SpawnTransform = FTransform(GetOwner()->GetActorRotation(), GetOwner()->GetActorLocation());
+			OutItemDrop = ItemDropPool->AcquireItemDrop(ItemDropClass, SpawnTransform, GetOwner(), ItemInstance);
+			return OutItemDrop != nullptr;
 		}
 	}
 
@@ -161,15 +361,10 @@ bool UItemInventoryComponent::ReleaseItem(FGuid ItemToRelease, FInstancedStruct&
 {
 	if (HasAuthority())
 	{
-		for (FFastItemInstance& FastItemInstance : ItemInstances)
+		// The ItemInstance is moved out of the Inventory as we are no longer managing it.
+		if (ItemInstances.RemoveItemInstance(ItemToRelease, OutItem))
 		{
-			const FItemInstance* const ItemInstancePtr = FastItemInstance.ItemInstance.GetPtr<FItemInstance>();
-			if (FastItemInstance.ItemInstance.IsValid() && ItemInstancePtr && ItemInstancePtr->ItemId == ItemToRelease)
-			{
-				OutItem = FastItemInstance.ItemInstance;
-				ItemInstances.RemoveItemInstance(ItemToRelease); // This is critical, we must remove the ItemInstance from the Inventory as we are no longer managing it.
-				return true;
-			}
+			return true;
 		}
 	}
 
@@ -365,6 +560,180 @@ bool UItemInventoryComponent::StackItemFromItemDrop(AItemDrop* ItemToStackFromIt
 		return false;
 	}
 
+	// ItemDrops that are only visualizing a drop owned by an ItemDropManager are stacked from the drop itself.
+	FGuid DropId;
+	if (AItemDropManager* DropManager = ItemToStackFromItemDrop->GetDropManager(DropId))
+	{
+		return StackItemFromItemDropRecord(DropManager, DropId, ItemToStackWith, bOutItemToStackFromWasExpunged);
+	}
+
+	TInstancedStruct<FItemInstance> ItemToStackFromInstance;
+	ItemToStackFromItemDrop->GetItemInstance(ItemToStackFromInstance);
+	if (!StackItemInstanceOnto(ItemToStackFromInstance, ItemToStackWith, bOutItemToStackFromWasExpunged))
+	{
+		return false;
+	}
+
+	if (!bOutItemToStackFromWasExpunged)
+	{
+		// The ItemToStackFrom keeps the remainder of its stack, which the ItemDrop replicates in place.
+		ItemToStackFromItemDrop->SetItemInstance(MoveTemp(ItemToStackFromInstance));
+	}
+	else
+	{
+		// Reset the ItemToStackFrom, as we are effectively destroying it since all of its stacks will be removed.
+		ItemToStackFromItemDrop->ResetItemInstance();
+
+		if (bDestroyItemDrop)
+		{
+			ItemToStackFromItemDrop->ReleaseToPool();
+		}
+	}
+
+	return true;
+}
+
+bool UItemInventoryComponent::StackItemFromItemDropRecord(AItemDropManager* DropManager, FGuid DropId, FGuid ItemToStackWith, bool& bOutItemToStackFromWasExpunged)
+{
+	if (!HasAuthority() || !IsValid(DropManager))
+	{
+		return false;
+	}
+
+	const FItemDropRecord* Drop = DropManager->FindDrop(DropId);
+	if (!Drop || !DropManager->CanTakeDrop(DropId, this))
+	{
+		return false;
+	}
+
+	TInstancedStruct<FItemInstance> ItemToStackFromInstance = Drop->ItemInstance;
+	if (!StackItemInstanceOnto(ItemToStackFromInstance, ItemToStackWith, bOutItemToStackFromWasExpunged))
+	{
+		return false;
+	}
+
+	if (bOutItemToStackFromWasExpunged)
+	{
+		TInstancedStruct<FItemInstance> ExpungedItemInstance;
+		DropManager->RemoveDrop(DropId, ExpungedItemInstance);
+	}
+	else
+	{
+		// Only the StackCount of the drop changed, so it is updated in place.
+		DropManager->SetDropItemInstance(DropId, ItemToStackFromInstance);
+	}
+
+	return true;
+}
+
+bool UItemInventoryComponent::FindItemToStackWith(const FInstancedStruct& Item, FGuid& OutItemToStackWith) const
+{
+	const FItemInstance* ItemPtr = Item.GetPtr<FItemInstance>();
+	const FItemDefinition* ItemDefinitionPtr = ItemPtr ? ItemPtr->GetItemDefinition().GetPtr() : nullptr;
+	const UItemStackSettings* StackSettingsCDO = ItemDefinitionPtr ? ItemDefinitionPtr->StackSettings.GetDefaultObject() : nullptr;
+	if (!StackSettingsCDO || !StackSettingsCDO->IsStackable())
+	{
+		return false;
+	}
+
+	// Items sharing a stack key are only candidates, the StackSettings still have the final say.
+	auto CanStackOnto = [ItemPtr, &Item](const FFastItemInstance* FastCandidateInstance)
+	{
+		const FItemInstance* CandidatePtr = FastCandidateInstance ? FastCandidateInstance->ItemInstance.GetPtr<FItemInstance>() : nullptr;
+		const FItemDefinition* CandidateItemDefinitionPtr = CandidatePtr ? CandidatePtr->GetItemDefinition().GetPtr() : nullptr;
+		const UItemStackSettings* CandidateStackSettingsCDO = CandidateItemDefinitionPtr ? CandidateItemDefinitionPtr->StackSettings.GetDefaultObject() : nullptr;
+
+		int32 StackRemainder = 0;
+		return CandidateStackSettingsCDO
+			&& CandidateStackSettingsCDO->CanStackWith(Item, FastCandidateInstance->ItemInstance, StackRemainder)
+			&& StackRemainder < ItemPtr->StackCount;
+	};
+
+	// A CanStackWith implemented in Blueprint may stack Items the stack key would keep apart, so every Item has to be asked.
+	if (!StackSettingsCDO->SupportsStackKeys())
+	{
+		for (const FFastItemInstance& FastCandidateInstance : ItemInstances)
+		{
+			const FItemInstance* CandidatePtr = FastCandidateInstance.ItemInstance.GetPtr<FItemInstance>();
+			if (CandidatePtr && CanStackOnto(&FastCandidateInstance))
+			{
+				OutItemToStackWith = CandidatePtr->ItemId;
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	uint32 StackKey = 0;
+	if (!StackSettingsCDO->ComputeStackKey(*ItemPtr, StackKey))
+	{
+		return false;
+	}
+
+	const TSet<FGuid>* OpenStacks = ItemInstances.FindOpenStacksWithStackKey(StackKey);
+	if (!OpenStacks)
+	{
+		return false;
+	}
+
+	for (const FGuid& Candidate : *OpenStacks)
+	{
+		if (CanStackOnto(ItemInstances.GetItemInstance(Candidate)))
+		{
+			OutItemToStackWith = Candidate;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void UItemInventoryComponent::AddOrStackItemInstance(FInstancedStruct&& ItemInstance, FInstancedStruct&& UserContextData)
+{
+	// Stacking onto several Items and adding the remainder is committed as a single change.
+	FItemInventoryTransaction Transaction(this);
+
+	if (bAutoStackOnTake && StackItemInstanceOntoOpenStacks(ItemInstance))
+	{
+		ItemInstance.Reset();
+		return;
+	}
+
+	ItemInstances.AddItemInstance(MoveTemp(ItemInstance), MoveTemp(UserContextData));
+}
+
+void UItemInventoryComponent::AddOrStackItemInstance(TInstancedStruct<FItemInstance>&& ItemInstance, FInstancedStruct&& UserContextData)
+{
+	AddOrStackItemInstance(FFastItemInstancesContainer::MoveToInstancedStruct(MoveTemp(ItemInstance)), MoveTemp(UserContextData));
+}
+
+bool UItemInventoryComponent::StackItemInstanceOntoOpenStacks(FInstancedStruct& ItemInstance)
+{
+	TInstancedStruct<FItemInstance> ItemToStackFromInstance;
+	ItemToStackFromInstance.InitializeAsScriptStruct(ItemInstance.GetScriptStruct(), ItemInstance.GetMemory());
+
+	// Every successful stack either takes all of what remains or fills the Item it was stacked onto, which then leaves the open stacks.
+	FGuid ItemToStackWith;
+	bool bWasExpunged = false;
+	while (!bWasExpunged && FindItemToStackWith(ItemInstance, ItemToStackWith))
+	{
+		if (!StackItemInstanceOnto(ItemToStackFromInstance, ItemToStackWith, bWasExpunged))
+		{
+			break;
+		}
+
+		if (!bWasExpunged)
+		{
+			ItemInstance.GetMutable<FItemInstance>().StackCount = ItemToStackFromInstance.Get().StackCount;
+		}
+	}
+
+	return bWasExpunged;
+}
+
+bool UItemInventoryComponent::StackItemInstanceOnto(TInstancedStruct<FItemInstance>& ItemToStackFromInstance, const FGuid& ItemToStackWith, bool& bOutItemToStackFromWasExpunged)
+{
 	const FFastItemInstance* FastItemToStackWithInstance = ItemInstances.GetItemInstance(ItemToStackWith);
 	if (!FastItemToStackWithInstance)
 	{
@@ -383,8 +752,6 @@ bool UItemInventoryComponent::StackItemFromItemDrop(AItemDrop* ItemToStackFromIt
 		return false;
 	}
 
-	TInstancedStruct<FItemInstance> ItemToStackFromInstance;
-	ItemToStackFromItemDrop->GetItemInstance(ItemToStackFromInstance);
 	if (!ItemToStackFromInstance.IsValid())
 	{
 		return false;
@@ -415,27 +782,11 @@ bool UItemInventoryComponent::StackItemFromItemDrop(AItemDrop* ItemToStackFromIt
 	{
 		// Since there is a remainder after the stacking operation, the ItemToStackFrom needs to be updated to reflect that change.
 		ItemToStackFromInstance.GetMutablePtr()->StackCount = StackRemainder;
-
-		// Because we changed the ItemToStackFrom, we should re-drop it as a new ItemDrop so that it can reflect these changes.
-		AItemDrop* NewItemDrop = nullptr;
-		const FTransform SpawnTransform = FTransform(ItemToStackFromItemDrop->GetActorRotation(), ItemToStackFromItemDrop->GetActorLocation());
-		NewItemDrop = GetWorld()->SpawnActorDeferred<AItemDrop>(ItemDropClass, SpawnTransform, GetOwner(), nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
-		NewItemDrop->ItemInstance.InitializeAsScriptStruct(ItemToStackFromInstance.GetScriptStruct(), ItemToStackFromInstance.GetMemory());
-		UGameplayStatics::FinishSpawningActor(NewItemDrop, SpawnTransform);
-
-		// Reset and Destroy the ItemToStackFrom that we originally came from as the NewItemDrop is taking its place.
-		ItemToStackFromInstance.Reset();
-		ItemToStackFromItemDrop->Destroy(true);
 	}
 	else
 	{
 		// Reset the ItemToStackFrom, as we are effectively destroying it since all of its stacks will be removed.
 		ItemToStackFromInstance.Reset();
-
-		if (bDestroyItemDrop)
-		{
-			ItemToStackFromItemDrop->Destroy(true);
-		}
 	}
 
 	ItemInstances.ModifyItemInstanceWithChangeDescriptor<FItemInstance>(
@@ -466,11 +817,23 @@ bool UItemInventoryComponent::CanSocketItem_Implementation(const FInstancedStruc
 		return false;
 	}
 
+	// An override in Blueprint may accept or refuse each Socket differently, so it has to be asked about every Socket. Otherwise the Sockets are
+	// checked in a single pass over the ItemToSocketInto we already have, rather than finding it again for each of them.
+	const bool bAskEachSocket = GetClass()->IsFunctionImplementedInScript(GET_FUNCTION_NAME_CHECKED(UItemInventoryComponent, CanSocketItemIntoSocket));
 	for (const TInstancedStruct<FItemSocketInstance>& SocketInstance : ItemToSocketIntoPtr->Sockets)
 	{
-		if (SocketInstance.GetPtr() && CanSocketItemIntoSocket(ItemToSocket, ItemToSocketInto, SocketInstance.GetPtr()->SocketId))
+		const FItemSocketInstance* SocketInstancePtr = SocketInstance.GetPtr();
+		if (!SocketInstancePtr)
+		{
+			continue;
+		}
+
+		const bool bCanSocket = bAskEachSocket
+			? CanSocketItemIntoSocket(ItemToSocket, ItemToSocketInto, SocketInstancePtr->SocketId)
+			: CanSocketItemIntoResolvedSocket(ItemToSocket, FastItemToSocketIntoPtr->ItemInstance, *SocketInstancePtr);
+		if (bCanSocket)
 		{
-			OutSocketId = SocketInstance.GetPtr()->SocketId;
+			OutSocketId = SocketInstancePtr->SocketId;
 			return true;
 		}
 	}
@@ -480,12 +843,6 @@ bool UItemInventoryComponent::CanSocketItem_Implementation(const FInstancedStruc
 
 bool UItemInventoryComponent::CanSocketItemIntoSocket_Implementation(const FInstancedStruct& ItemToSocket, FGuid ItemToSocketInto, FGuid SocketId)
 {
-	const FItemInstance* ItemToSocketInstancePtr = ItemToSocket.GetPtr<FItemInstance>();
-	if (!ItemToSocketInstancePtr)
-	{
-		return false;
-	}
-
 	const FFastItemInstance* FastItemToSocketIntoPtr = ItemInstances.GetItemInstance(ItemToSocketInto);
 	if (!FastItemToSocketIntoPtr)
 	{
@@ -498,18 +855,26 @@ bool UItemInventoryComponent::CanSocketItemIntoSocket_Implementation(const FInst
 		return false;
 	}
 
-	// Check for any empty sockets. We cant socket at all if they are full already.
-	bool bHasEmptySocket = false;
-	for (const TInstancedStruct<FItemSocketInstance>& SocketInstance : ItemToSocketIntoPtr->Sockets)
+	const FItemSocketInstance* SocketInstancePtr = ItemToSocketIntoPtr->FindSocket(SocketId);
+	if (!SocketInstancePtr)
 	{
-		if (SocketInstance.GetPtr() && SocketInstance.GetPtr()->SocketId == SocketId)
-		{
-			bHasEmptySocket = SocketInstance.GetPtr()->bIsEmpty;
-			break;
-		}
+		return false;
+	}
+
+	return CanSocketItemIntoResolvedSocket(ItemToSocket, FastItemToSocketIntoPtr->ItemInstance, *SocketInstancePtr);
+}
+
+bool UItemInventoryComponent::CanSocketItemIntoResolvedSocket(const FInstancedStruct& ItemToSocket, const FInstancedStruct& ItemToSocketInto, const FItemSocketInstance& SocketInstance) const
+{
+	const FItemInstance* ItemToSocketInstancePtr = ItemToSocket.GetPtr<FItemInstance>();
+	const FItemInstance* ItemToSocketIntoPtr = ItemToSocketInto.GetPtr<FItemInstance>();
+	if (!ItemToSocketInstancePtr || !ItemToSocketIntoPtr)
+	{
+		return false;
 	}
 
-	if (!bHasEmptySocket)
+	// Check the Socket is empty. We cant socket at all if it is full already.
+	if (!SocketInstance.bIsEmpty)
 	{
 		return false;
 	}
@@ -526,7 +891,7 @@ bool UItemInventoryComponent::CanSocketItemIntoSocket_Implementation(const FInst
 		return false;
 	}
 
-	return ItemSocketSettingsCDO->CanSocketInto(ItemToSocket, FastItemToSocketIntoPtr->ItemInstance, SocketId);
+	return ItemSocketSettingsCDO->CanSocketInto(ItemToSocket, ItemToSocketInto, SocketInstance.SocketId);
 }
 
 bool UItemInventoryComponent::HasAnyEmptyItemSockets(FGuid ItemToSocketInto)
@@ -567,16 +932,11 @@ bool UItemInventoryComponent::SocketItem(FInstancedStruct& ItemToSocket, FGuid I
 		{ GET_MEMBER_NAME_CHECKED(FItemInstance, Sockets) },
 		[&ItemToSocket, SocketId, &bResult](FItemInstance* MutableItemInstance)
 		{
-			for (TInstancedStruct<FItemSocketInstance>& Socket : MutableItemInstance->Sockets)
+			if (FItemSocketInstance* MutableSocketInstance = MutableItemInstance->FindMutableSocket(SocketId))
 			{
-				FItemSocketInstance* MutableSocketInstance = Socket.GetMutablePtr();
-				if (MutableSocketInstance && MutableSocketInstance->SocketId == SocketId)
-				{
-					MutableSocketInstance->SocketedItemInstance = ItemToSocket;
-					MutableSocketInstance->bIsEmpty = false;
-					bResult = true;
-					return;
-				}
+				MutableSocketInstance->SocketedItemInstance = ItemToSocket;
+				MutableSocketInstance->bIsEmpty = false;
+				bResult = true;
 			}
 		}
 	);
@@ -598,16 +958,11 @@ bool UItemInventoryComponent::UnsocketItem(FGuid ItemToUnsocketFrom, FGuid Socke
 		{ GET_MEMBER_NAME_CHECKED(FItemInstance, Sockets) },
 		[&OutUnsocketedItem, SocketId, &bResult](FItemInstance* MutableItemInstance)
 		{
-			for (TInstancedStruct<FItemSocketInstance>& Socket : MutableItemInstance->Sockets)
+			if (FItemSocketInstance* MutableSocketInstance = MutableItemInstance->FindMutableSocket(SocketId))
 			{
-				FItemSocketInstance* MutableSocketInstance = Socket.GetMutablePtr();
-				if (MutableSocketInstance && MutableSocketInstance->SocketId == SocketId)
-				{
-					OutUnsocketedItem = MutableSocketInstance->SocketedItemInstance;
-					MutableSocketInstance->bIsEmpty = true;
-					bResult = true;
-					return;
-				}
+				OutUnsocketedItem = MutableSocketInstance->SocketedItemInstance;
+				MutableSocketInstance->bIsEmpty = true;
+				bResult = true;
 			}
 		}
 	);
@@ -629,57 +984,814 @@ bool UItemInventoryComponent::GetItemAffixes(const FGuid& ItemId, TArray<TInstan
 	return false;
 }
 
+bool UItemInventoryComponent::GetItemModifierAggregate(FGuid Item, FGameplayTag ModType, FAffixModifierAggregate& OutAggregate) const
+{
+	OutAggregate = FAffixModifierAggregate();
+
+	if (bCacheModifierAggregates)
+	{
+		const TMap<FGameplayTag, FAffixModifierAggregate>* Aggregates = ItemModifierAggregates.Find(Item);
+		const FAffixModifierAggregate* Aggregate = Aggregates ? Aggregates->Find(ModType) : nullptr;
+		if (Aggregate)
+		{
+			OutAggregate = *Aggregate;
+		}
+	}
+	else if (const FItemInstance* ItemInstancePtr = GetItem(Item))
+	{
+		TMap<FGameplayTag, FAffixModifierAggregate> Aggregates;
+		UGenericItemizationStatics::AccumulateItemModifiers(*ItemInstancePtr, Aggregates);
+		if (const FAffixModifierAggregate* Aggregate = Aggregates.Find(ModType))
+		{
+			OutAggregate = *Aggregate;
+		}
+	}
+
+	return OutAggregate.NumModifiers > 0;
+}
+
+bool UItemInventoryComponent::GetInventoryModifierAggregate(FGameplayTag ModType, FAffixModifierAggregate& OutAggregate) const
+{
+	OutAggregate = FAffixModifierAggregate();
+
+	if (bCacheModifierAggregates)
+	{
+		if (const FAffixModifierAggregate* Aggregate = InventoryModifierAggregates.Find(ModType))
+		{
+			OutAggregate = *Aggregate;
+		}
+	}
+	else
+	{
+		TMap<FGameplayTag, FAffixModifierAggregate> Aggregates;
+		for (const FFastItemInstance& FastItemInstance : GetItemsView())
+		{
+			if (const FItemInstance* ItemInstancePtr = FastItemInstance.ItemInstance.GetPtr<FItemInstance>())
+			{
+				UGenericItemizationStatics::AccumulateItemModifiers(*ItemInstancePtr, Aggregates);
+			}
+		}
+
+		if (const FAffixModifierAggregate* Aggregate = Aggregates.Find(ModType))
+		{
+			OutAggregate = *Aggregate;
+		}
+	}
+
+	return OutAggregate.NumModifiers > 0;
+}
+
+bool UItemInventoryComponent::GetItemGridPlacement(FGuid Item, FIntPoint& OutLocation, FIntPoint& OutSize) const
+{
+	const FItemGridPlacement* Placement = Grid.FindPlacement(Item);
+	if (!Placement)
+	{
+		return false;
+	}
+
+	OutLocation = Placement->GetLocation();
+	OutSize = Placement->GetSize();
+	return true;
+}
+
+bool UItemInventoryComponent::CanPlaceItemInGridAt(FGuid Item, FIntPoint Location) const
+{
+	const FItemGridPlacement* Placement = Grid.FindPlacement(Item);
+	return Placement && Grid.CanPlace(Location, Placement->GetSize(), Item);
+}
+
+bool UItemInventoryComponent::FindGridLocationForItem(const FInstancedStruct& Item, FIntPoint& OutLocation) const
+{
+	const FItemInstance* ItemPtr = Item.GetPtr<FItemInstance>();
+	return ItemPtr && Grid.FindFirstFit(FItemInventoryGrid::GetItemFootprint(*ItemPtr), OutLocation);
+}
+
+bool UItemInventoryComponent::MoveItemInGrid(FGuid Item, FIntPoint Location)
+{
+	return HasAuthority() && bUseGridLayout && Grid.MoveItem(Item, Location);
+}
+
+bool UItemInventoryComponent::AutoArrangeGrid()
+{
+	if (!HasAuthority() || !bUseGridLayout)
+	{
+		return false;
+	}
+
+	bool bArranged = Grid.AutoArrange();
+
+	for (const FFastItemInstance& FastItemInstance : GetItemsView())
+	{
+		const FItemInstance* ItemInstancePtr = FastItemInstance.ItemInstance.GetPtr<FItemInstance>();
+		if (ItemInstancePtr && !Grid.FindPlacement(ItemInstancePtr->ItemId))
+		{
+			const FIntPoint Size = FItemInventoryGrid::GetItemFootprint(*ItemInstancePtr);
+			FIntPoint Location;
+			bArranged &= Grid.FindFirstFit(Size, Location) && Grid.PlaceItem(ItemInstancePtr->ItemId, Location, Size);
+		}
+	}
+
+	return bArranged;
+}
+
+int32 UItemInventoryComponent::SaveItems(TArray<uint8>& OutData) const
+{
+	TArray<FConstStructView> ItemsToSave;
+	ItemsToSave.Reserve(ItemInstances.GetNum());
+	for (const FFastItemInstance& FastItemInstance : ItemInstances)
+	{
+		ItemsToSave.Add(FConstStructView(FastItemInstance.ItemInstance));
+	}
+
+	// Items in tabs are still held by this Inventory, only which tab they are in is not saved.
+	for (const UItemInventoryTab* InventoryTab : Tabs)
+	{
+		if (InventoryTab)
+		{
+			for (const FFastItemInstance& FastItemInstance : InventoryTab->ItemInstances)
+			{
+				ItemsToSave.Add(FConstStructView(FastItemInstance.ItemInstance));
+			}
+		}
+	}
+
+	return FItemInventoryArchive::Write(ItemsToSave, OutData) ? ItemsToSave.Num() : -1;
+}
+
+int32 UItemInventoryComponent::LoadItems(const TArray<uint8>& Data)
+{
+	if (!HasAuthority())
+	{
+		return -1;
+	}
+
+	TArray<FInstancedStruct> LoadedItems;
+	if (!FItemInventoryArchive::Read(Data, LoadedItems))
+	{
+		return -1;
+	}
+
+	return LoadItemInstances(MoveTemp(LoadedItems));
+}
+
+int32 UItemInventoryComponent::LoadItemInstances(TArray<FInstancedStruct>&& ItemInstancesToLoad)
+{
+	if (!HasAuthority())
+	{
+		return 0;
+	}
+
+	FItemInventoryTransaction Transaction(this);
+	ItemInstances.Reserve(ItemInstances.GetNum() + ItemInstancesToLoad.Num());
+
+	int32 NumLoaded = 0;
+	for (FInstancedStruct& LoadedItem : ItemInstancesToLoad)
+	{
+		const FItemInstance* ItemInstancePtr = LoadedItem.GetPtr<FItemInstance>();
+		if (!ItemInstancePtr || !ItemInstancePtr->IsValid() || ItemInstances.GetItemInstance(ItemInstancePtr->ItemId) || FindTabItemInstance(ItemInstancePtr->ItemId))
+		{
+			continue;
+		}
+
+		ItemInstances.AddItemInstance(MoveTemp(LoadedItem), FInstancedStruct());
+		NumLoaded++;
+	}
+
+	return NumLoaded;
+}
+
+UItemInventoryTab* UItemInventoryComponent::GetTab(int32 Tab) const
+{
+	return Tabs.IsValidIndex(Tab) ? Tabs[Tab].Get() : nullptr;
+}
+
+int32 UItemInventoryComponent::AddTab()
+{
+	if (!HasAuthority())
+	{
+		return INDEX_NONE;
+	}
+
+	UItemInventoryTab* NewTab = NewObject<UItemInventoryTab>(this);
+	const int32 TabIndex = Tabs.Add(NewTab);
+	NewTab->ItemInstances.Register(this, TabIndex);
+
+	MARK_PROPERTY_DIRTY_FROM_NAME(UItemInventoryComponent, Tabs, this);
+	return TabIndex;
+}
+
+TArray<FInstancedStruct> UItemInventoryComponent::GetTabItems(int32 Tab) const
+{
+	const UItemInventoryTab* const InventoryTab = GetTab(Tab);
+	return InventoryTab ? InventoryTab->ItemInstances.GetItemInstances() : TArray<FInstancedStruct>();
+}
+
+bool UItemInventoryComponent::MoveItemToTab(const FGuid& ItemId, int32 Tab)
+{
+	UItemInventoryTab* const InventoryTab = GetTab(Tab);
+	const FFastItemInstance* const FastItemInstance = ItemInstances.GetItemInstance(ItemId);
+	if (!HasAuthority() || !InventoryTab || !FastItemInstance)
+	{
+		return false;
+	}
+
+	FInstancedStruct UserContextData = FastItemInstance->UserContextData;
+	FInstancedStruct ItemInstance;
+	if (!ItemInstances.RemoveItemInstance(ItemId, ItemInstance))
+	{
+		return false;
+	}
+
+	InventoryTab->ItemInstances.AddItemInstance(MoveTemp(ItemInstance), MoveTemp(UserContextData));
+	OnTabChangedDelegate.Broadcast(this, Tab);
+
+	// The Item is still held by this Inventory, so the move is not saved as its removal.
+	UnsavedRemovedItemIds.Remove(ItemId);
+	UnsavedItemIds.Add(ItemId);
+
+	return true;
+}
+
+bool UItemInventoryComponent::MoveItemFromTab(int32 Tab, const FGuid& ItemId)
+{
+	UItemInventoryTab* const InventoryTab = GetTab(Tab);
+	const FFastItemInstance* const FastItemInstance = InventoryTab ? InventoryTab->ItemInstances.GetItemInstance(ItemId) : nullptr;
+	if (!HasAuthority() || !FastItemInstance || !CanTakeItem(FastItemInstance->ItemInstance, FastItemInstance->UserContextData))
+	{
+		return false;
+	}
+
+	FInstancedStruct UserContextData = FastItemInstance->UserContextData;
+	FInstancedStruct ItemInstance;
+	if (!InventoryTab->ItemInstances.RemoveItemInstance(ItemId, ItemInstance))
+	{
+		return false;
+	}
+
+	AddOrStackItemInstance(MoveTemp(ItemInstance), MoveTemp(UserContextData));
+	OnTabChangedDelegate.Broadcast(this, Tab);
+
+	// An Item that was stacked entirely onto others no longer exists, it was never added to be saved as removed later.
+	if (!ItemInstances.GetItemInstance(ItemId))
+	{
+		UnsavedItemIds.Remove(ItemId);
+		UnsavedRemovedItemIds.Add(ItemId);
+	}
+
+	return true;
+}
+
+const FFastItemInstance* UItemInventoryComponent::FindTabItemInstance(const FGuid& ItemId) const
+{
+	for (const UItemInventoryTab* InventoryTab : Tabs)
+	{
+		if (const FFastItemInstance* FastItemInstance = InventoryTab ? InventoryTab->ItemInstances.GetItemInstance(ItemId) : nullptr)
+		{
+			return FastItemInstance;
+		}
+	}
+
+	return nullptr;
+}
+
+void UItemInventoryComponent::SetTabSubscribed(int32 Tab, bool bSubscribed)
+{
+	if (HasAuthority())
+	{
+		ServerSetTabSubscribed_Implementation(Tab, bSubscribed);
+		return;
+	}
+
+	// The owning Client remembers what it asked for, the Server decides what is actually sent.
+	if (bSubscribed)
+	{
+		SubscribedTabs.Add(Tab);
+	}
+	else
+	{
+		SubscribedTabs.Remove(Tab);
+	}
+
+	ServerSetTabSubscribed(Tab, bSubscribed);
+}
+
+void UItemInventoryComponent::ServerSetTabSubscribed_Implementation(int32 Tab, bool bSubscribed)
+{
+	UItemInventoryTab* const InventoryTab = GetTab(Tab);
+	if (!InventoryTab || IsSubscribedToTab(Tab) == bSubscribed)
+	{
+		return;
+	}
+
+	// The registered SubObject list is what Iris replicates from, the tab's NetDeltaSerialize is only asked by the legacy path.
+	const bool bUpdateSubObjectList = IsUsingRegisteredSubObjectList() && IsReadyForReplication();
+
+	if (bSubscribed)
+	{
+		SubscribedTabs.Add(Tab);
+		if (bUpdateSubObjectList)
+		{
+			AddReplicatedSubObject(InventoryTab, COND_OwnerOnly);
+		}
+
+		// Send whatever changed while the tab was dormant straight away.
+		GetOwner()->ForceNetUpdate();
+	}
+	else
+	{
+		SubscribedTabs.Remove(Tab);
+		if (bUpdateSubObjectList)
+		{
+			RemoveReplicatedSubObject(InventoryTab);
+		}
+	}
+}
+
+bool UItemInventoryComponent::IsSubscribedToTab(int32 Tab) const
+{
+	return SubscribedTabs.Contains(Tab);
+}
+
+bool UItemInventoryComponent::ShouldReplicateTabTo(int32 Tab, const UNetConnection* Connection) const
+{
+	return IsSubscribedToTab(Tab) && IsOwningConnection(Connection);
+}
+
+void UItemInventoryComponent::OnTabItemInstancesReceived(int32 Tab)
+{
+	OnTabChangedDelegate.Broadcast(this, Tab);
+}
+
+int32 UItemInventoryComponent::SaveItemChanges(TArray<uint8>& OutData, bool& bOutIsSnapshot, bool bFullSnapshot /*= false*/)
+{
+	bOutIsSnapshot = false;
+	if (!HasAuthority())
+	{
+		OutData.Reset();
+		return -1;
+	}
+
+	// A delta is meaningless without a snapshot before it to apply to.
+	bOutIsSnapshot = bFullSnapshot || NumDeltasSinceSnapshot == INDEX_NONE || (SnapshotSaveInterval > 0 && NumDeltasSinceSnapshot >= SnapshotSaveInterval);
+
+	int32 NumSaved = 0;
+	if (bOutIsSnapshot)
+	{
+		NumSaved = SaveItems(OutData);
+		if (NumSaved < 0)
+		{
+			return -1;
+		}
+
+		NumDeltasSinceSnapshot = 0;
+	}
+	else
+	{
+		TArray<FConstStructView> ChangedItems;
+		ChangedItems.Reserve(UnsavedItemIds.Num());
+		for (const FGuid& ItemId : UnsavedItemIds)
+		{
+			const FFastItemInstance* FastItemInstance = ItemInstances.GetItemInstance(ItemId);
+			if (!FastItemInstance)
+			{
+				FastItemInstance = FindTabItemInstance(ItemId);
+			}
+
+			if (FastItemInstance)
+			{
+				ChangedItems.Add(FConstStructView(FastItemInstance->ItemInstance));
+			}
+		}
+
+		const TArray<FGuid> RemovedItemIds = UnsavedRemovedItemIds.Array();
+		if (!FItemInventoryArchive::WriteDelta(ChangedItems, RemovedItemIds, OutData))
+		{
+			return -1;
+		}
+
+		NumSaved = ChangedItems.Num() + RemovedItemIds.Num();
+		NumDeltasSinceSnapshot++;
+	}
+
+	UnsavedItemIds.Reset();
+	UnsavedRemovedItemIds.Reset();
+
+	return NumSaved;
+}
+
 TArray<FInstancedStruct> UItemInventoryComponent::GetItems()
 {
-	return ItemInstances.GetItemInstances();
+	return ItemInstances.GetItemInstances();
+}
+
+TArray<FFastItemInstance> UItemInventoryComponent::GetItemsWithContext()
+{
+	TArray<FFastItemInstance> OutItems;
+	OutItems.Append(ItemInstances.ItemInstances);
+	return OutItems;
+}
+
+TConstArrayView<FFastItemInstance> UItemInventoryComponent::GetItemsView() const
+{
+	return ItemInstances.ItemInstances;
+}
+
+void UItemInventoryComponent::ForEachItem(TFunctionRef<bool(FConstStructView ItemInstance, FConstStructView UserContextData)> Visitor) const
+{
+	for (const FFastItemInstance& FastItemInstance : ItemInstances)
+	{
+		if (!Visitor(FConstStructView(FastItemInstance.ItemInstance), FConstStructView(FastItemInstance.UserContextData)))
+		{
+			return;
+		}
+	}
+}
+
+int32 UItemInventoryComponent::GetItemsPage(int32 Offset, int32 Count, const FItemInstanceQueryFilter& Filter, TArray<FInstancedStruct>& OutItems) const
+{
+	OutItems.Reset(FMath::Clamp(Count, 0, ItemInstances.GetNum()));
+
+	int32 NumMatching = 0;
+	auto AddMatchingItem = [&](const FFastItemInstance& FastItemInstance)
+	{
+		const FItemInstance* ItemInstancePtr = FastItemInstance.ItemInstance.GetPtr<FItemInstance>();
+		if (!ItemInstancePtr || !Filter.Matches(*ItemInstancePtr))
+		{
+			return;
+		}
+
+		// Only the Items on the page are copied, the rest are just counted.
+		if (NumMatching >= Offset && OutItems.Num() < Count)
+		{
+			OutItems.Add(FastItemInstance.ItemInstance);
+		}
+
+		NumMatching++;
+	};
+
+	if (Filter.IsEmpty())
+	{
+		for (const FFastItemInstance& FastItemInstance : ItemInstances)
+		{
+			AddMatchingItem(FastItemInstance);
+		}
+
+		return NumMatching;
+	}
+
+	// The indexes already hold each Item under the parents of its tags, so only the Items under the filtered tags need to be looked at.
+	// The smaller of the two candidate sets is used, and the Filter still checks the other one.
+	auto GatherCandidates = [this](const FGameplayTagContainer& Tags, bool bQualityTypes, TArray<int32>& OutIndices)
+	{
+		for (const FGameplayTag& Tag : Tags)
+		{
+			const TSet<FGuid>* ItemIds = bQualityTypes ? ItemInstances.FindItemInstancesOfQuality(Tag) : ItemInstances.FindItemInstancesOfType(Tag);
+			if (ItemIds)
+			{
+				for (const FGuid& ItemId : *ItemIds)
+				{
+					OutIndices.Add(ItemInstances.FindItemInstanceIndex(ItemId));
+				}
+			}
+		}
+	};
+
+	TArray<int32> CandidateIndices;
+	if (!Filter.QualityTypes.IsEmpty())
+	{
+		GatherCandidates(Filter.QualityTypes, true, CandidateIndices);
+	}
+
+	if (!Filter.ItemTypes.IsEmpty())
+	{
+		TArray<int32> ItemTypeCandidateIndices;
+		GatherCandidates(Filter.ItemTypes, false, ItemTypeCandidateIndices);
+		if (Filter.QualityTypes.IsEmpty() || ItemTypeCandidateIndices.Num() < CandidateIndices.Num())
+		{
+			CandidateIndices = MoveTemp(ItemTypeCandidateIndices);
+		}
+	}
+
+	// Pages follow the order Items are stored in, and an Item under more than one of the filtered tags is only counted once.
+	CandidateIndices.Sort();
+	int32 PreviousIndex = INDEX_NONE;
+	for (const int32 Index : CandidateIndices)
+	{
+		if (Index != PreviousIndex && Index != INDEX_NONE)
+		{
+			AddMatchingItem(ItemInstances.ItemInstances[Index]);
+		}
+
+		PreviousIndex = Index;
+	}
+
+	return NumMatching;
+}
+
+FInstancedStruct UItemInventoryComponent::GetItem(FGuid ItemId, bool& bSuccessful)
+{
+	const FFastItemInstance* ItemInstance = ItemInstances.GetItemInstance(ItemId);
+	bSuccessful = ItemInstance != nullptr;
+	return bSuccessful ? ItemInstance->ItemInstance : FInstancedStruct();
+}
+
+const FItemInstance* UItemInventoryComponent::GetItem(const FGuid& ItemId) const
+{
+	const FFastItemInstance* ItemInstance = ItemInstances.GetItemInstance(ItemId);
+	if (!ItemInstance)
+	{
+		return nullptr;
+	}
+
+	return ItemInstance->ItemInstance.GetPtr<FItemInstance>();
+}
+
+FInstancedStruct UItemInventoryComponent::GetItemContextData(FGuid ItemId, bool& bSuccessful)
+{
+	const FFastItemInstance* ItemInstance = ItemInstances.GetItemInstance(ItemId);
+	bSuccessful = ItemInstance != nullptr;
+	return bSuccessful ? ItemInstance->UserContextData : FInstancedStruct();
+}
+
+int32 UItemInventoryComponent::GetNumItems() const
+{
+	return ItemInstances.GetNum();
+}
+
+int32 UItemInventoryComponent::GetNumItemsWithDefinition(FDataTableRowHandle ItemDefinition, bool bCountStacks /*= false*/) const
+{
+	return CountItems(ItemInstances.FindItemInstancesWithDefinition(ItemDefinition), bCountStacks);
+}
+
+int32 UItemInventoryComponent::GetNumItemsOfType(FGameplayTag ItemType, bool bCountStacks /*= false*/) const
+{
+	return CountItems(ItemInstances.FindItemInstancesOfType(ItemType), bCountStacks);
+}
+
+int32 UItemInventoryComponent::GetNumItemsOfQuality(FGameplayTag QualityType, bool bCountStacks /*= false*/) const
+{
+	return CountItems(ItemInstances.FindItemInstancesOfQuality(QualityType), bCountStacks);
+}
+
+bool UItemInventoryComponent::FindItemsWithDefinition(FDataTableRowHandle ItemDefinition, TArray<FGuid>& OutItemIds) const
+{
+	const TSet<FGuid>* ItemIds = ItemInstances.FindItemInstancesWithDefinition(ItemDefinition);
+	OutItemIds = ItemIds ? ItemIds->Array() : TArray<FGuid>();
+	return !OutItemIds.IsEmpty();
+}
+
+bool UItemInventoryComponent::FindItemsOfType(FGameplayTag ItemType, TArray<FGuid>& OutItemIds) const
+{
+	const TSet<FGuid>* ItemIds = ItemInstances.FindItemInstancesOfType(ItemType);
+	OutItemIds = ItemIds ? ItemIds->Array() : TArray<FGuid>();
+	return !OutItemIds.IsEmpty();
+}
+
+bool UItemInventoryComponent::FindItemsOfQuality(FGameplayTag QualityType, TArray<FGuid>& OutItemIds) const
+{
+	const TSet<FGuid>* ItemIds = ItemInstances.FindItemInstancesOfQuality(QualityType);
+	OutItemIds = ItemIds ? ItemIds->Array() : TArray<FGuid>();
+	return !OutItemIds.IsEmpty();
+}
+
+int32 UItemInventoryComponent::CountItems(const TSet<FGuid>* ItemIds, bool bCountStacks) const
+{
+	if (!ItemIds)
+	{
+		return 0;
+	}
+
+	if (!bCountStacks)
+	{
+		return ItemIds->Num();
+	}
+
+	int32 NumStacks = 0;
+	for (const FGuid& ItemId : *ItemIds)
+	{
+		if (const FItemInstance* ItemInstancePtr = GetItem(ItemId))
+		{
+			NumStacks += ItemInstancePtr->StackCount;
+		}
+	}
+
+	return NumStacks;
+}
+
+bool UItemInventoryComponent::HasAuthority() const
+{
+	return !bCachedIsNetSimulated;
 }
 
-TArray<FFastItemInstance> UItemInventoryComponent::GetItemsWithContext()
+void UItemInventoryComponent::CacheIsNetSimulated()
 {
-	TArray<FFastItemInstance> OutItems;
-	OutItems.Append(ItemInstances.ItemInstances);
-	return OutItems;
+	bCachedIsNetSimulated = IsNetSimulating();
+	ItemInstances.bOwnerIsNetAuthority = HasAuthority();
 }
 
-FInstancedStruct UItemInventoryComponent::GetItem(FGuid ItemId, bool& bSuccessful)
+bool UItemInventoryComponent::ShouldReplicateItemInstancesTo(const UNetConnection* Connection) const
 {
-	const FFastItemInstance* ItemInstance = ItemInstances.GetItemInstance(ItemId);
-	bSuccessful = ItemInstance != nullptr;
-	return bSuccessful ? ItemInstance->ItemInstance : FInstancedStruct();
+	if (ReplicationPolicy == EItemInventoryReplicationPolicy::Public)
+	{
+		return true;
+	}
+
+	if (!Connection)
+	{
+		return false;
+	}
+
+	// Replays should record the Inventory as it was seen by the Server.
+	if (Connection->IsReplay() || IsOwningConnection(Connection))
+	{
+		return true;
+	}
+
+	if (ReplicationPolicy == EItemInventoryReplicationPolicy::OwnerAndParty)
+	{
+		return IsPartyMember(Connection->PlayerController);
+	}
+
+	return false;
 }
 
-const FItemInstance* UItemInventoryComponent::GetItem(const FGuid& ItemId) const
+bool UItemInventoryComponent::IsOwningConnection(const UNetConnection* Connection) const
 {
-	const FFastItemInstance* ItemInstance = ItemInstances.GetItemInstance(ItemId);
-	if (!ItemInstance)
+	const AActor* const OwningActor = GetOwner();
+	if (!Connection || !OwningActor)
 	{
-		return nullptr;
+		return false;
 	}
 
-	return ItemInstance->ItemInstance.GetPtr<FItemInstance>();
+	const UNetConnection* const OwningConnection = OwningActor->GetNetConnection();
+	if (!OwningConnection)
+	{
+		return false;
+	}
+
+	if (OwningConnection == Connection)
+	{
+		return true;
+	}
+
+	// Split screen players share the parent Connection.
+	for (const UChildConnection* ChildConnection : Connection->Children)
+	{
+		if (ChildConnection == OwningConnection)
+		{
+			return true;
+		}
+	}
+
+	return false;
 }
 
-FInstancedStruct UItemInventoryComponent::GetItemContextData(FGuid ItemId, bool& bSuccessful)
+bool UItemInventoryComponent::IsPartyMember_Implementation(const APlayerController* PlayerController) const
 {
-	const FFastItemInstance* ItemInstance = ItemInstances.GetItemInstance(ItemId);
-	bSuccessful = ItemInstance != nullptr;
-	return bSuccessful ? ItemInstance->UserContextData : FInstancedStruct();
+	return PlayerController && PlayerController->IsMemberOfNetConditionGroup(GetPartyNetConditionGroup());
 }
 
-int32 UItemInventoryComponent::GetNumItems() const
+void UItemInventoryComponent::AddPartyMember(APlayerController* PlayerController)
 {
-	return ItemInstances.GetNum();
+	if (HasAuthority() && PlayerController)
+	{
+		PlayerController->IncludeInNetConditionGroup(GetPartyNetConditionGroup());
+	}
 }
 
-bool UItemInventoryComponent::HasAuthority() const
+void UItemInventoryComponent::RemovePartyMember(APlayerController* PlayerController)
 {
-	return !bCachedIsNetSimulated;
+	if (HasAuthority() && PlayerController)
+	{
+		PlayerController->RemoveFromNetConditionGroup(GetPartyNetConditionGroup());
+	}
 }
 
-void UItemInventoryComponent::CacheIsNetSimulated()
+FName UItemInventoryComponent::GetPartyNetConditionGroup() const
 {
-	bCachedIsNetSimulated = IsNetSimulating();
-	ItemInstances.bOwnerIsNetAuthority = HasAuthority();
+	return PartyNetConditionGroup.IsNone() ? FName(TEXT("ItemInventoryParty"), static_cast<int32>(GetUniqueID())) : PartyNetConditionGroup;
+}
+
+void UItemInventoryComponent::OnRep_PublicSummary()
+{
+	OnPublicSummaryChangedDelegate.Broadcast(this);
+}
+
+void UItemInventoryComponent::OnRep_Tabs()
+{
+	// Tabs can be received before the Tabs array that refers to them, their ItemInstances are then only announced by OnTabChangedDelegate from here on.
+	for (int32 TabIndex = 0; TabIndex < Tabs.Num(); TabIndex++)
+	{
+		if (UItemInventoryTab* const InventoryTab = Tabs[TabIndex])
+		{
+			InventoryTab->ItemInstances.Register(this, TabIndex);
+		}
+	}
+}
+
+void UItemInventoryComponent::UpdateGridPlacement(const FFastItemInstance& FastItemInstance, bool bRemoved)
+{
+	const FItemInstance* ItemInstancePtr = FastItemInstance.ItemInstance.GetPtr<FItemInstance>();
+	if (!bUseGridLayout || !HasAuthority() || !ItemInstancePtr)
+	{
+		return;
+	}
+
+	if (bRemoved)
+	{
+		Grid.RemoveItem(ItemInstancePtr->ItemId);
+		return;
+	}
+
+	// Items added without going through CanTakeItem might not fit, they are left unplaced until AutoArrangeGrid makes room for them.
+	const FIntPoint Size = FItemInventoryGrid::GetItemFootprint(*ItemInstancePtr);
+	FIntPoint Location;
+	if (!Grid.FindPlacement(ItemInstancePtr->ItemId) && Grid.FindFirstFit(Size, Location))
+	{
+		Grid.PlaceItem(ItemInstancePtr->ItemId, Location, Size);
+	}
+}
+
+void UItemInventoryComponent::UpdateModifierAggregates(const FFastItemInstance& FastItemInstance, bool bRemoved)
+{
+	const FItemInstance* ItemInstancePtr = FastItemInstance.ItemInstance.GetPtr<FItemInstance>();
+	if (!bCacheModifierAggregates || !ItemInstancePtr)
+	{
+		return;
+	}
+
+	// Take out everything the ItemInstance contributed before, then add back what it contributes now.
+	TMap<FGameplayTag, FAffixModifierAggregate> OldAggregates;
+	if (ItemModifierAggregates.RemoveAndCopyValue(ItemInstancePtr->ItemId, OldAggregates))
+	{
+		for (const TPair<FGameplayTag, FAffixModifierAggregate>& OldAggregate : OldAggregates)
+		{
+			FAffixModifierAggregate& InventoryAggregate = InventoryModifierAggregates.FindOrAdd(OldAggregate.Key);
+			InventoryAggregate.Accumulate(OldAggregate.Value, -1);
+			if (InventoryAggregate.NumModifiers <= 0)
+			{
+				InventoryModifierAggregates.Remove(OldAggregate.Key);
+			}
+		}
+	}
+
+	if (bRemoved)
+	{
+		return;
+	}
+
+	TMap<FGameplayTag, FAffixModifierAggregate> NewAggregates;
+	UGenericItemizationStatics::AccumulateItemModifiers(*ItemInstancePtr, NewAggregates);
+	if (NewAggregates.IsEmpty())
+	{
+		return;
+	}
+
+	for (const TPair<FGameplayTag, FAffixModifierAggregate>& NewAggregate : NewAggregates)
+	{
+		InventoryModifierAggregates.FindOrAdd(NewAggregate.Key).Accumulate(NewAggregate.Value);
+	}
+
+	ItemModifierAggregates.Add(ItemInstancePtr->ItemId, MoveTemp(NewAggregates));
+}
+
+void UItemInventoryComponent::UpdatePublicSummary(const FFastItemInstance& FastItemInstance, bool bRemoved)
+{
+	if (ReplicationPolicy != EItemInventoryReplicationPolicy::PublicSummaryOnly || !HasAuthority())
+	{
+		return;
+	}
+
+	const FItemInstance* const ItemInstancePtr = FastItemInstance.ItemInstance.GetPtr<FItemInstance>();
+	if (!ItemInstancePtr)
+	{
+		return;
+	}
+
+	const int32 EntryIndex = PublicSummary.IndexOfByPredicate([ItemInstancePtr](const FItemInventorySummaryEntry& Entry)
+	{
+		return Entry.ItemId == ItemInstancePtr->ItemId;
+	});
+
+	if (bRemoved)
+	{
+		if (EntryIndex == INDEX_NONE)
+		{
+			return;
+		}
+
+		PublicSummary.RemoveAt(EntryIndex);
+	}
+	else
+	{
+		FItemInventorySummaryEntry& Entry = EntryIndex != INDEX_NONE ? PublicSummary[EntryIndex] : PublicSummary.AddDefaulted_GetRef();
+		Entry.ItemId = ItemInstancePtr->ItemId;
+		Entry.ItemDefinitionHandle = ItemInstancePtr->GetItemDefinitionHandle();
+		Entry.QualityType = ItemInstancePtr->QualityType;
+		Entry.StackCount = ItemInstancePtr->StackCount;
+	}
+
+	MARK_PROPERTY_DIRTY_FROM_NAME(UItemInventoryComponent, PublicSummary, this);
 }
 
 void UItemInventoryComponent::K2_OnAddedItem_Implementation(const FInstancedStruct& Item, const FInstancedStruct& UserContextData)
@@ -717,31 +1829,199 @@ void UItemInventoryComponent::OnItemInstancePropertyValueChanged(const FFastItem
 	// Left empty intentionally to be overridden.
 }
 
-void UItemInventoryComponent::OnAddedItemInstance(const FFastItemInstance& FastItemInstance)
+void UItemInventoryComponent::BeginTransaction()
+{
+	if (TransactionDepth++ == 0)
+	{
+		ItemInstances.bDeferMarkDirty = true;
+	}
+}
+
+void UItemInventoryComponent::CommitTransaction()
+{
+	if (!ensureMsgf(TransactionDepth > 0, TEXT("CommitTransaction was called on %s without a matching BeginTransaction."), *GetPathName()))
+	{
+		return;
+	}
+
+	if (--TransactionDepth == 0)
+	{
+		ItemInstances.FlushPendingDirty();
+		FlushPendingItemChanges();
+	}
+}
+
+UItemInventoryComponent::FPendingItemChange* UItemInventoryComponent::FindOrAddPendingItemChange(const FFastItemInstance& FastItemInstance)
+{
+	const FItemInstance* ItemInstancePtr = FastItemInstance.ItemInstance.GetPtr<FItemInstance>();
+	if (!ItemInstancePtr)
+	{
+		return nullptr;
+	}
+
+	if (const int32* PendingItemChangeIndex = PendingItemChangeIndices.Find(ItemInstancePtr->ItemId))
+	{
+		return &PendingItemChanges[*PendingItemChangeIndex];
+	}
+
+	PendingItemChangeIndices.Add(ItemInstancePtr->ItemId, PendingItemChanges.Num());
+	FPendingItemChange& PendingItemChange = PendingItemChanges.AddDefaulted_GetRef();
+	PendingItemChange.ItemId = ItemInstancePtr->ItemId;
+	return &PendingItemChange;
+}
+
+void UItemInventoryComponent::FlushPendingItemChanges()
 {
+	if (PendingItemChanges.IsEmpty())
+	{
+		return;
+	}
+
+	// Listeners are free to make further changes, which will open and flush their own Transactions.
+	TArray<FPendingItemChange> ItemChanges = MoveTemp(PendingItemChanges);
+	PendingItemChanges.Reset();
+	PendingItemChangeIndices.Reset();
+
 	GetOwner()->ForceNetUpdate();
 
-	const FInstancedStruct& ItemInstance = FastItemInstance.ItemInstance;
-	OnItemTakenDelegate.Broadcast(this, ItemInstance, FastItemInstance.UserContextData);
-	K2_OnAddedItem(ItemInstance, FastItemInstance.UserContextData);
+	FItemInventoryChangeSet ChangeSet;
+	for (const FPendingItemChange& ItemChange : ItemChanges)
+	{
+		if (ItemChange.bRemoved)
+		{
+			// An ItemInstance that was added and removed within the same Transaction was never seen by anyone.
+			if (!ItemChange.bAdded)
+			{
+				const FFastItemInstance& FastItemInstance = ItemChange.RemovedItemInstance;
+				UpdatePublicSummary(FastItemInstance, true);
+				ChangeSet.RemovedItems.Add(ItemChange.ItemId);
+				OnItemRemovedDelegate.Broadcast(this, FastItemInstance.ItemInstance, FastItemInstance.UserContextData);
+				K2_OnRemovedItem(FastItemInstance.ItemInstance, FastItemInstance.UserContextData);
+			}
+
+			continue;
+		}
+
+		// Always emit the latest state of the ItemInstance.
+		const FFastItemInstance* FastItemInstance = ItemInstances.GetItemInstance(ItemChange.ItemId);
+		if (!FastItemInstance)
+		{
+			continue;
+		}
+
+		UpdatePublicSummary(*FastItemInstance, false);
+
+		const FInstancedStruct& ItemInstance = FastItemInstance->ItemInstance;
+		const FInstancedStruct& UserContextData = FastItemInstance->UserContextData;
+		if (ItemChange.bAdded)
+		{
+			ChangeSet.AddedItems.Add(ItemChange.ItemId);
+			OnItemTakenDelegate.Broadcast(this, ItemInstance, UserContextData);
+			K2_OnAddedItem(ItemInstance, UserContextData);
+			continue;
+		}
+
+		if (ItemChange.bChanged)
+		{
+			ChangeSet.ChangedItems.Add(ItemChange.ItemId);
+			OnItemChangedDelegate.Broadcast(this, ItemInstance, UserContextData);
+			K2_OnChangedItem(ItemInstance, UserContextData);
+		}
+
+		if (ItemChange.bStackCountChanged && ItemChange.OldStackCount != ItemChange.NewStackCount)
+		{
+			OnItemStackCountChangedDelegate.Broadcast(this, ItemInstance, UserContextData, ItemChange.OldStackCount, ItemChange.NewStackCount);
+			K2_OnItemStackCountChanged(ItemInstance, UserContextData, ItemChange.OldStackCount, ItemChange.NewStackCount);
+		}
+
+		for (const TPair<FGuid, bool>& SocketChange : ItemChange.SocketChanges)
+		{
+			if (SocketChange.Value)
+			{
+				OnItemSocketedDelegate.Broadcast(this, ItemInstance, UserContextData, SocketChange.Key);
+				K2_OnItemSocketed(ItemInstance, UserContextData, SocketChange.Key);
+			}
+			else
+			{
+				OnItemUnsocketedDelegate.Broadcast(this, ItemInstance, UserContextData, SocketChange.Key);
+				K2_OnItemUnsocketed(ItemInstance, UserContextData, SocketChange.Key);
+			}
+		}
+	}
+
+	if (!ChangeSet.IsEmpty())
+	{
+		OnItemsChangedDelegate.Broadcast(this, ChangeSet);
+	}
+}
+
+void UItemInventoryComponent::MarkItemUnsaved(const FFastItemInstance& FastItemInstance, bool bRemoved)
+{
+	const FItemInstance* ItemInstancePtr = FastItemInstance.ItemInstance.GetPtr<FItemInstance>();
+	if (!ItemInstancePtr || !HasAuthority())
+	{
+		return;
+	}
+
+	if (bRemoved)
+	{
+		UnsavedItemIds.Remove(ItemInstancePtr->ItemId);
+		UnsavedRemovedItemIds.Add(ItemInstancePtr->ItemId);
+	}
+	else
+	{
+		UnsavedRemovedItemIds.Remove(ItemInstancePtr->ItemId);
+		UnsavedItemIds.Add(ItemInstancePtr->ItemId);
+	}
+}
+
+void UItemInventoryComponent::OnAddedItemInstance(const FFastItemInstance& FastItemInstance)
+{
+	UpdateGridPlacement(FastItemInstance, false);
+	UpdateModifierAggregates(FastItemInstance, false);
+	MarkItemUnsaved(FastItemInstance, false);
+
+	FItemInventoryTransaction Transaction(this);
+	if (FPendingItemChange* PendingItemChange = FindOrAddPendingItemChange(FastItemInstance))
+	{
+		// Removing and adding back the same ItemInstance is only a change to anyone that saw it before.
+		if (PendingItemChange->bRemoved)
+		{
+			PendingItemChange->bRemoved = false;
+			PendingItemChange->bChanged = true;
+		}
+		else
+		{
+			PendingItemChange->bAdded = true;
+		}
+	}
 }
 
 void UItemInventoryComponent::OnChangedItemInstance(const FFastItemInstance& FastItemInstance)
 {
-	GetOwner()->ForceNetUpdate();
+	// Socketing and Unsocketing are changes to the ItemInstance that was socketed into.
+	UpdateModifierAggregates(FastItemInstance, false);
+	MarkItemUnsaved(FastItemInstance, false);
 
-	const FInstancedStruct& ItemInstance = FastItemInstance.ItemInstance;
-	OnItemChangedDelegate.Broadcast(this, ItemInstance, FastItemInstance.UserContextData);
-	K2_OnChangedItem(ItemInstance, FastItemInstance.UserContextData);
+	FItemInventoryTransaction Transaction(this);
+	if (FPendingItemChange* PendingItemChange = FindOrAddPendingItemChange(FastItemInstance))
+	{
+		PendingItemChange->bChanged = true;
+	}
 }
 
 void UItemInventoryComponent::OnRemovedItemInstance(const FFastItemInstance& FastItemInstance)
 {
-	GetOwner()->ForceNetUpdate();
+	UpdateGridPlacement(FastItemInstance, true);
+	UpdateModifierAggregates(FastItemInstance, true);
+	MarkItemUnsaved(FastItemInstance, true);
 
-	const FInstancedStruct& ItemInstance = FastItemInstance.ItemInstance;
-	OnItemRemovedDelegate.Broadcast(this, ItemInstance, FastItemInstance.UserContextData);
-	K2_OnRemovedItem(ItemInstance, FastItemInstance.UserContextData);
+	FItemInventoryTransaction Transaction(this);
+	if (FPendingItemChange* PendingItemChange = FindOrAddPendingItemChange(FastItemInstance))
+	{
+		PendingItemChange->bRemoved = true;
+		PendingItemChange->RemovedItemInstance = FastItemInstance;
+	}
 }
 
 void UItemInventoryComponent::OnItemInstancePropertyValueChanged_Internal(const FFastItemInstance& FastItemInstance, const FGameplayTag& ChangeDescriptor, int32 ChangeId, const FName& PropertyName, const void* OldPropertyValue, const void* NewPropertyValue)
@@ -749,12 +2029,23 @@ void UItemInventoryComponent::OnItemInstancePropertyValueChanged_Internal(const
 	OnItemInstancePropertyValueChanged(FastItemInstance, ChangeDescriptor, ChangeId, PropertyName, OldPropertyValue, NewPropertyValue);
 	OnItemPropertyValueChangedDelegate.Broadcast(this, FastItemInstance, ChangeDescriptor, ChangeId, PropertyName, OldPropertyValue, NewPropertyValue);
 
+	FItemInventoryTransaction Transaction(this);
+	FPendingItemChange* PendingItemChange = FindOrAddPendingItemChange(FastItemInstance);
+	if (!PendingItemChange)
+	{
+		return;
+	}
+
 	if (ChangeDescriptor == GenericItemizationGameplayTags::ItemInstanceChange_StackCount && PropertyName == GET_MEMBER_NAME_CHECKED(FItemInstance, StackCount))
 	{
 		const int32* OldStackCount = static_cast<const int32*>(OldPropertyValue);
 		const int32* NewStackCount = static_cast<const int32*>(NewPropertyValue);
-		OnItemStackCountChangedDelegate.Broadcast(this, FastItemInstance.ItemInstance, FastItemInstance.UserContextData, *OldStackCount, *NewStackCount);
-		K2_OnItemStackCountChanged(FastItemInstance.ItemInstance, FastItemInstance.UserContextData, *OldStackCount, *NewStackCount);
+		if (!PendingItemChange->bStackCountChanged)
+		{
+			PendingItemChange->bStackCountChanged = true;
+			PendingItemChange->OldStackCount = *OldStackCount;
+		}
+		PendingItemChange->NewStackCount = *NewStackCount;
 	}
 
 	if (PropertyName == GET_MEMBER_NAME_CHECKED(FItemInstance, Sockets))
@@ -762,56 +2053,57 @@ void UItemInventoryComponent::OnItemInstancePropertyValueChanged_Internal(const
 		const TArray<TInstancedStruct<FItemSocketInstance>>* OldSockets = static_cast<const TArray<TInstancedStruct<FItemSocketInstance>>*>(OldPropertyValue);
 		const TArray<TInstancedStruct<FItemSocketInstance>>* NewSockets = static_cast<const TArray<TInstancedStruct<FItemSocketInstance>>*>(NewPropertyValue);
 
+		// Sockets keep their order, so they are compared in step and only looked up by SocketId once the two no longer line up.
 		FGuid ChangedSocketId;
 		bool bFoundChangedSocketId = false;
-		for (const TInstancedStruct<FItemSocketInstance>& OldSocket : *OldSockets)
+		TMap<FGuid, int32> NewSocketIdToIndex;
+		for (int32 OldIndex = 0; OldIndex < OldSockets->Num() && !bFoundChangedSocketId; OldIndex++)
 		{
-			if (bFoundChangedSocketId)
+			const FItemSocketInstance* const OldSocketInstancePtr = (*OldSockets)[OldIndex].GetPtr();
+			if (!OldSocketInstancePtr)
 			{
-				break;
+				continue;
 			}
 
-			for (const TInstancedStruct<FItemSocketInstance>& NewSocket : *NewSockets)
+			const FItemSocketInstance* NewSocketInstancePtr = NewSockets->IsValidIndex(OldIndex) ? (*NewSockets)[OldIndex].GetPtr() : nullptr;
+			if (!NewSocketInstancePtr || NewSocketInstancePtr->SocketId != OldSocketInstancePtr->SocketId)
 			{
-				const FItemSocketInstance* const OldSocketInstancePtr = OldSocket.GetPtr();
-				const FItemSocketInstance* const NewSocketInstancePtr = NewSocket.GetPtr();
-				if (OldSocketInstancePtr && NewSocketInstancePtr && OldSocketInstancePtr->SocketId == NewSocketInstancePtr->SocketId)
+				if (NewSocketIdToIndex.IsEmpty())
 				{
-					// Check if the bIsEmpty flag has changed. If it has then we can skip doing a more expensive compare.
-					if (OldSocketInstancePtr->bIsEmpty != NewSocketInstancePtr->bIsEmpty)
+					NewSocketIdToIndex.Reserve(NewSockets->Num());
+					for (int32 NewIndex = 0; NewIndex < NewSockets->Num(); NewIndex++)
 					{
-						ChangedSocketId = NewSocketInstancePtr->SocketId;
-						bFoundChangedSocketId = true;
-						break;
-					}
-
-					// Since we couldn't determine a change with the bIsEmpty flag we need to check if the ItemInstance itself was changed.
-					const FItemInstance* const OldSocketItemInstancePtr = OldSocketInstancePtr->SocketedItemInstance.GetPtr<FItemInstance>();
-					const FItemInstance* const NewSocketItemInstancePtr = NewSocketInstancePtr->SocketedItemInstance.GetPtr<FItemInstance>();
-					if (OldSocketInstancePtr && !NewSocketItemInstancePtr)
-					{
-						ChangedSocketId = OldSocketInstancePtr->SocketId;
-						bFoundChangedSocketId = true;
-						break;
-					}
-
-					if (!OldSocketInstancePtr && NewSocketItemInstancePtr)
-					{
-						ChangedSocketId = NewSocketInstancePtr->SocketId;
-						bFoundChangedSocketId = true;
-						break;
-					}
-
-					if (OldSocketItemInstancePtr && NewSocketItemInstancePtr)
-					{
-						if(OldSocketItemInstancePtr->ItemId != NewSocketItemInstancePtr->ItemId)
+						if (const FItemSocketInstance* const SocketInstancePtr = (*NewSockets)[NewIndex].GetPtr())
 						{
-							ChangedSocketId = NewSocketInstancePtr->SocketId;
-							bFoundChangedSocketId = true;
-							break;
+							NewSocketIdToIndex.Add(SocketInstancePtr->SocketId, NewIndex);
 						}
 					}
 				}
+
+				const int32* NewIndex = NewSocketIdToIndex.Find(OldSocketInstancePtr->SocketId);
+				NewSocketInstancePtr = NewIndex ? (*NewSockets)[*NewIndex].GetPtr() : nullptr;
+				if (!NewSocketInstancePtr)
+				{
+					continue;
+				}
+			}
+
+			// Check if the bIsEmpty flag has changed. If it has then we can skip doing a more expensive compare.
+			if (OldSocketInstancePtr->bIsEmpty != NewSocketInstancePtr->bIsEmpty)
+			{
+				ChangedSocketId = NewSocketInstancePtr->SocketId;
+				bFoundChangedSocketId = true;
+				break;
+			}
+
+			// Since we couldn't determine a change with the bIsEmpty flag we need to check if the socketed ItemInstance itself was changed.
+			const FItemInstance* const OldSocketItemInstancePtr = OldSocketInstancePtr->SocketedItemInstance.GetPtr<FItemInstance>();
+			const FItemInstance* const NewSocketItemInstancePtr = NewSocketInstancePtr->SocketedItemInstance.GetPtr<FItemInstance>();
+			if ((OldSocketItemInstancePtr != nullptr) != (NewSocketItemInstancePtr != nullptr)
+				|| (OldSocketItemInstancePtr && NewSocketItemInstancePtr && OldSocketItemInstancePtr->ItemId != NewSocketItemInstancePtr->ItemId))
+			{
+				ChangedSocketId = NewSocketInstancePtr->SocketId;
+				bFoundChangedSocketId = true;
 			}
 		}
 
@@ -819,14 +2111,34 @@ void UItemInventoryComponent::OnItemInstancePropertyValueChanged_Internal(const
 		{
 			if (ChangeDescriptor == GenericItemizationGameplayTags::ItemInstanceChange_SocketChange_Socketed)
 			{
-				OnItemSocketedDelegate.Broadcast(this, FastItemInstance.ItemInstance, FastItemInstance.UserContextData, ChangedSocketId);
-				K2_OnItemSocketed(FastItemInstance.ItemInstance, FastItemInstance.UserContextData, ChangedSocketId);
+				PendingItemChange->SocketChanges.Emplace(ChangedSocketId, true);
 			}
 			else if (ChangeDescriptor == GenericItemizationGameplayTags::ItemInstanceChange_SocketChange_Unsocketed)
 			{
-				OnItemUnsocketedDelegate.Broadcast(this, FastItemInstance.ItemInstance, FastItemInstance.UserContextData, ChangedSocketId);
-				K2_OnItemUnsocketed(FastItemInstance.ItemInstance, FastItemInstance.UserContextData, ChangedSocketId);
+				PendingItemChange->SocketChanges.Emplace(ChangedSocketId, false);
 			}
 		}
 	}
 }
+
+FItemInventoryTransaction::FItemInventoryTransaction(UItemInventoryComponent* InInventory) :
+	Inventory(InInventory)
+{
+	if (Inventory.IsValid())
+	{
+		Inventory->BeginTransaction();
+	}
+}
+
+FItemInventoryTransaction::~FItemInventoryTransaction()
+{
+	if (Inventory.IsValid())
+	{
+		Inventory->CommitTransaction();
+	}
+}
+
+bool FItemInstanceQueryFilter::Matches(const FItemInstance& ItemInstance) const
+{
+	return ItemInstance.MatchesTypes(ItemTypes, QualityTypes);
+}
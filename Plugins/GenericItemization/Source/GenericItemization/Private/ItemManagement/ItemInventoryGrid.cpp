@@ -0,0 +1,270 @@
+// Copyright Fissure Entertainment, Pty Ltd. All Rights Reserved.
+
+#include "ItemManagement/ItemInventoryGrid.h"
+#include "ItemManagement/ItemInventoryComponent.h"
+#include "GenericItemizationInstanceTypes.h"
+#include "Engine/PackageMapClient.h"
+
+void FItemInventoryGrid::PostReplicatedReceive(const FFastArraySerializer::FPostReplicatedReceiveParameters& Parameters)
+{
+	// Placements are few and small, so Clients simply rebuild the bitboards rather than tracking where each Placement moved from.
+	Rebuild();
+}
+
+bool FItemInventoryGrid::NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParams)
+{
+	// The layout is only sent to the Connections that are allowed to see the ItemInstances it places.
+	if (DeltaParams.Writer && Owner)
+	{
+		const UPackageMapClient* const PackageMapClient = Cast<UPackageMapClient>(DeltaParams.Map);
+		if (!Owner->ShouldReplicateItemInstancesTo(PackageMapClient ? PackageMapClient->GetConnection() : nullptr))
+		{
+			return false;
+		}
+	}
+
+	return FFastArraySerializer::FastArrayDeltaSerialize<FItemGridPlacement, FItemInventoryGrid>(Placements, DeltaParams, *this);
+}
+
+void FItemInventoryGrid::Register(UItemInventoryComponent* InOwner, const FIntPoint& InSize)
+{
+	Owner = InOwner;
+	Width = FMath::Clamp(InSize.X, 1, MaxWidth);
+	Height = FMath::Clamp(InSize.Y, 1, MaxHeight);
+
+	Rebuild();
+}
+
+const FItemGridPlacement* FItemInventoryGrid::FindPlacement(const FGuid& ItemId) const
+{
+	const int32* Index = ItemIdToIndex.Find(ItemId);
+	return Index ? &Placements[*Index] : nullptr;
+}
+
+bool FItemInventoryGrid::CanPlace(const FIntPoint& Location, const FIntPoint& Size, const FGuid& IgnoredItem /*= FGuid()*/) const
+{
+	if (Location.X < 0 || Location.Y < 0 || Size.X < 1 || Size.Y < 1 || Location.X + Size.X > Width || Location.Y + Size.Y > Height)
+	{
+		return false;
+	}
+
+	const FItemGridPlacement* IgnoredPlacement = IgnoredItem.IsValid() ? FindPlacement(IgnoredItem) : nullptr;
+	const uint64 IgnoredMask = IgnoredPlacement ? GetColumnMask(IgnoredPlacement->X, IgnoredPlacement->Width) : 0;
+
+	const uint64 Mask = GetColumnMask(Location.X, Size.X);
+	for (int32 Y = Location.Y; Y < Location.Y + Size.Y; Y++)
+	{
+		uint64 Occupied = Rows[Y];
+		if (IgnoredPlacement && Y >= IgnoredPlacement->Y && Y < IgnoredPlacement->Y + IgnoredPlacement->Height)
+		{
+			Occupied &= ~IgnoredMask;
+		}
+
+		if (Occupied & Mask)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool FItemInventoryGrid::FindFirstFit(const FIntPoint& Size, FIntPoint& OutLocation) const
+{
+	if (Size.X < 1 || Size.Y < 1 || Size.X > Width || Size.Y > Height)
+	{
+		return false;
+	}
+
+	const uint64 RowMask = GetRowMask();
+	for (int32 Y = 0; Y + Size.Y <= Height; Y++)
+	{
+		// The columns that are free in every row the Size would cover.
+		uint64 Free = RowMask;
+		for (int32 Row = Y; Row < Y + Size.Y && Free; Row++)
+		{
+			Free &= ~Rows[Row];
+		}
+
+		// Narrow the free columns down to those that begin a run of at least Size.X free columns, doubling the run length each step.
+		uint64 Runs = Free;
+		int32 RunLength = 1;
+		while (Runs && RunLength < Size.X)
+		{
+			const int32 Shift = FMath::Min(RunLength, Size.X - RunLength);
+			Runs &= Runs >> Shift;
+			RunLength += Shift;
+		}
+
+		if (Runs)
+		{
+			OutLocation = FIntPoint(static_cast<int32>(FMath::CountTrailingZeros64(Runs)), Y);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool FItemInventoryGrid::PlaceItem(const FGuid& ItemId, const FIntPoint& Location, const FIntPoint& Size)
+{
+	if (!ItemId.IsValid() || ItemIdToIndex.Contains(ItemId) || !CanPlace(Location, Size))
+	{
+		return false;
+	}
+
+	const int32 Index = Placements.AddDefaulted();
+	FItemGridPlacement& Placement = Placements[Index];
+	Placement.ItemId = ItemId;
+	Placement.X = static_cast<uint8>(Location.X);
+	Placement.Y = static_cast<uint8>(Location.Y);
+	Placement.Width = static_cast<uint8>(Size.X);
+	Placement.Height = static_cast<uint8>(Size.Y);
+
+	SetCells(Placement, true);
+	ItemIdToIndex.Add(ItemId, Index);
+	MarkItemDirty(Placement);
+
+	return true;
+}
+
+bool FItemInventoryGrid::MoveItem(const FGuid& ItemId, const FIntPoint& Location)
+{
+	const int32* Index = ItemIdToIndex.Find(ItemId);
+	if (!Index)
+	{
+		return false;
+	}
+
+	FItemGridPlacement& Placement = Placements[*Index];
+	if (!CanPlace(Location, Placement.GetSize(), ItemId))
+	{
+		return false;
+	}
+
+	SetCells(Placement, false);
+	Placement.X = static_cast<uint8>(Location.X);
+	Placement.Y = static_cast<uint8>(Location.Y);
+	SetCells(Placement, true);
+	MarkItemDirty(Placement);
+
+	return true;
+}
+
+bool FItemInventoryGrid::RemoveItem(const FGuid& ItemId)
+{
+	int32 Index = INDEX_NONE;
+	if (!ItemIdToIndex.RemoveAndCopyValue(ItemId, Index))
+	{
+		return false;
+	}
+
+	SetCells(Placements[Index], false);
+	Placements.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	if (Placements.IsValidIndex(Index))
+	{
+		ItemIdToIndex.Add(Placements[Index].ItemId, Index);
+	}
+
+	MarkArrayDirty();
+	return true;
+}
+
+bool FItemInventoryGrid::AutoArrange()
+{
+	TArray<int32> Order;
+	Order.Reserve(Placements.Num());
+	for (int32 Index = 0; Index < Placements.Num(); Index++)
+	{
+		Order.Add(Index);
+	}
+
+	// Largest first, as the small Items can fill the gaps that are left around them.
+	Order.Sort([this](int32 A, int32 B)
+	{
+		const FItemGridPlacement& PlacementA = Placements[A];
+		const FItemGridPlacement& PlacementB = Placements[B];
+		const int32 AreaA = PlacementA.Width * PlacementA.Height;
+		const int32 AreaB = PlacementB.Width * PlacementB.Height;
+		return AreaA != AreaB ? AreaA > AreaB : PlacementA.Height > PlacementB.Height;
+	});
+
+	TArray<uint64> OldRows = Rows;
+	FMemory::Memzero(Rows.GetData(), Rows.Num() * sizeof(uint64));
+
+	TArray<FIntPoint> NewLocations;
+	NewLocations.SetNum(Placements.Num());
+	for (const int32 Index : Order)
+	{
+		FItemGridPlacement NewPlacement = Placements[Index];
+		FIntPoint NewLocation;
+		if (!FindFirstFit(NewPlacement.GetSize(), NewLocation))
+		{
+			Rows = MoveTemp(OldRows);
+			return false;
+		}
+
+		NewPlacement.X = static_cast<uint8>(NewLocation.X);
+		NewPlacement.Y = static_cast<uint8>(NewLocation.Y);
+		SetCells(NewPlacement, true);
+		NewLocations[Index] = NewLocation;
+	}
+
+	for (int32 Index = 0; Index < Placements.Num(); Index++)
+	{
+		FItemGridPlacement& Placement = Placements[Index];
+		if (Placement.GetLocation() != NewLocations[Index])
+		{
+			Placement.X = static_cast<uint8>(NewLocations[Index].X);
+			Placement.Y = static_cast<uint8>(NewLocations[Index].Y);
+			MarkItemDirty(Placement);
+		}
+	}
+
+	return true;
+}
+
+FIntPoint FItemInventoryGrid::GetItemFootprint(const FItemInstance& ItemInstance)
+{
+	if (const FItemDefinition* ItemDefinition = ItemInstance.GetItemDefinition().GetPtr())
+	{
+		for (const FItemDefinitionUserData& UserData : ItemDefinition->CustomUserData)
+		{
+			if (const FItemGridFootprint* Footprint = UserData.UserData.GetPtr<FItemGridFootprint>())
+			{
+				return FIntPoint(FMath::Clamp(Footprint->Width, 1, MaxWidth), FMath::Clamp(Footprint->Height, 1, MaxHeight));
+			}
+		}
+	}
+
+	return FIntPoint(1, 1);
+}
+
+uint64 FItemInventoryGrid::GetColumnMask(int32 X, int32 Count)
+{
+	const uint64 Columns = Count >= MaxWidth ? ~uint64(0) : (uint64(1) << Count) - 1;
+	return Columns << X;
+}
+
+void FItemInventoryGrid::SetCells(const FItemGridPlacement& Placement, bool bOccupied)
+{
+	const uint64 Mask = GetColumnMask(Placement.X, Placement.Width) & GetRowMask();
+	const int32 LastRow = FMath::Min(Placement.Y + Placement.Height, Height);
+	for (int32 Y = Placement.Y; Y < LastRow; Y++)
+	{
+		Rows[Y] = bOccupied ? Rows[Y] | Mask : Rows[Y] & ~Mask;
+	}
+}
+
+void FItemInventoryGrid::Rebuild()
+{
+	Rows.Init(0, Height);
+	ItemIdToIndex.Reset();
+	ItemIdToIndex.Reserve(Placements.Num());
+
+	for (int32 Index = 0; Index < Placements.Num(); Index++)
+	{
+		SetCells(Placements[Index], true);
+		ItemIdToIndex.Add(Placements[Index].ItemId, Index);
+	}
+}
@@ -0,0 +1,745 @@
+// Copyright Fissure Entertainment, Pty Ltd. All Rights Reserved.
+
+#include "ItemManagement/ItemInventorySerialization.h"
+#include "ItemManagement/ItemSocketSettings.h"
+#include "GenericItemizationInstanceTypes.h"
+#include "GenericItemizationTableTypes.h"
+#include "GameplayTagsManager.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MemoryReader.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogGenericItemizationArchive, Log, All);
+
+namespace ItemInventoryArchivePrivate
+{
+
+/* The string table index that refers to nothing. */
+static constexpr uint32 InvalidString = MAX_uint32;
+
+/* Upper bounds used to reject malformed archives before anything is allocated for them. */
+static constexpr uint32 MaxStringLength = 1024;
+static constexpr uint32 MaxRecordsPerItem = MAX_uint16;
+
+/* Socket depth is always 1, anything deeper than this is considered malformed. */
+static constexpr int32 MaxSocketDepth = 4;
+
+/* Set in the Flags of a delta archive. */
+static constexpr uint32 DeltaFlag = 1 << 0;
+
+struct FArchiveHeader
+{
+	uint32 Magic = FItemInventoryArchive::Magic;
+	uint32 Version = static_cast<uint32>(EItemInventoryArchiveVersion::LatestVersion);
+	uint32 NumStrings = 0;
+	uint32 NumItems = 0;
+	uint32 NumSavedItems = 0;
+	uint32 NumAffixes = 0;
+	uint32 NumSockets = 0;
+	uint32 Flags = 0;
+	uint32 NumRemovedItems = 0;
+
+	void Serialize(FArchive& Ar)
+	{
+		Ar << Magic << Version << NumStrings << NumItems << NumSavedItems << NumAffixes << NumSockets;
+
+		if (Version >= static_cast<uint32>(EItemInventoryArchiveVersion::Deltas))
+		{
+			Ar << Flags << NumRemovedItems;
+		}
+	}
+};
+
+struct FItemRecord
+{
+	FGuid ItemId;
+	int32 ItemSeed = 0;
+	int32 ItemStreamSeed = 0;
+	int32 ItemLevel = 0;
+	int32 AffixLevel = 0;
+	int32 StackCount = 0;
+	uint32 StructType = InvalidString;
+	uint32 ItemDefinition = InvalidString;
+	uint32 QualityType = InvalidString;
+	uint16 NumAffixes = 0;
+	uint16 NumSockets = 0;
+
+	static constexpr int64 Size = 16 + 8 * 4 + 2 * 2;
+
+	void Serialize(FArchive& Ar)
+	{
+		Ar << ItemId << ItemSeed << ItemStreamSeed << ItemLevel << AffixLevel << StackCount << StructType << ItemDefinition << QualityType << NumAffixes << NumSockets;
+	}
+};
+
+struct FAffixRecord
+{
+	uint32 AffixDefinition = InvalidString;
+	uint32 StructType = InvalidString;
+	uint8 bPredefinedAffix = 0;
+
+	static int64 GetSize(uint32 Version)
+	{
+		return 4 + 1 + (Version >= static_cast<uint32>(EItemInventoryArchiveVersion::ElementStructTypes) ? 4 : 0);
+	}
+
+	void Serialize(FArchive& Ar, uint32 Version)
+	{
+		Ar << AffixDefinition << bPredefinedAffix;
+
+		if (Version >= static_cast<uint32>(EItemInventoryArchiveVersion::ElementStructTypes))
+		{
+			Ar << StructType;
+		}
+	}
+};
+
+struct FSocketRecord
+{
+	FGuid SocketId;
+
+	/* The index of the SocketDefinition within the SocketSettings of the owning Item's ItemDefinition, as SocketDefinitionHandles are generated per process. */
+	int32 SocketDefinitionIndex = INDEX_NONE;
+
+	/* The Item record of the ItemInstance socketed into this Socket. */
+	int32 SocketedItem = INDEX_NONE;
+
+	uint32 StructType = InvalidString;
+
+	uint8 bIsEmpty = 0;
+
+	static int64 GetSize(uint32 Version)
+	{
+		return 16 + 4 + 4 + 1 + (Version >= static_cast<uint32>(EItemInventoryArchiveVersion::ElementStructTypes) ? 4 : 0);
+	}
+
+	void Serialize(FArchive& Ar, uint32 Version)
+	{
+		Ar << SocketId << SocketDefinitionIndex << SocketedItem << bIsEmpty;
+
+		if (Version >= static_cast<uint32>(EItemInventoryArchiveVersion::ElementStructTypes))
+		{
+			Ar << StructType;
+		}
+	}
+};
+
+/* Returns the SocketDefinitionHandles of the SocketSettings of the ItemInstance's ItemDefinition, in the order they are defined. */
+static const TArray<FGuid>* GetSocketDefinitionHandles(const FItemInstance& ItemInstance, TMap<const UClass*, TArray<FGuid>>& Cache)
+{
+	const FItemDefinition* ItemDefinition = ItemInstance.GetItemDefinition().GetPtr();
+	const UItemSocketSettings* SocketSettingsCDO = ItemDefinition && ItemDefinition->SocketSettings ? ItemDefinition->SocketSettings.GetDefaultObject() : nullptr;
+	if (!SocketSettingsCDO)
+	{
+		return nullptr;
+	}
+
+	if (const TArray<FGuid>* Handles = Cache.Find(SocketSettingsCDO->GetClass()))
+	{
+		return Handles;
+	}
+
+	TArray<FGuid>& Handles = Cache.Add(SocketSettingsCDO->GetClass());
+	for (const FConstStructView& SocketDefinitionView : SocketSettingsCDO->GetSocketDefinitions())
+	{
+		const FItemSocketDefinition* SocketDefinition = SocketDefinitionView.GetPtr<const FItemSocketDefinition>();
+		Handles.Add(SocketDefinition ? SocketDefinition->SocketDefinitionHandle : FGuid());
+	}
+
+	return &Handles;
+}
+
+/* Flattens ItemInstances into records, writing each referenced string only once. */
+struct FArchiveWriter
+{
+	TArray<FString> Strings;
+	TMap<FString, uint32> StringIndices;
+
+	TArray<FConstStructView> Items;
+	TArray<FItemRecord> ItemRecords;
+	TArray<FAffixRecord> AffixRecords;
+	TArray<FSocketRecord> SocketRecords;
+
+	TMap<const UClass*, TArray<FGuid>> SocketDefinitionHandles;
+
+	uint32 AddString(FString&& String)
+	{
+		if (const uint32* Index = StringIndices.Find(String))
+		{
+			return *Index;
+		}
+
+		const uint32 Index = Strings.Num();
+		StringIndices.Add(String, Index);
+		Strings.Add(MoveTemp(String));
+		return Index;
+	}
+
+	uint32 AddDefinitionReference(const FDataTableRowHandle& Handle)
+	{
+		return Handle.IsNull() ? InvalidString : AddString(Handle.DataTable->GetPathName() + TEXT(":") + Handle.RowName.ToString());
+	}
+
+	/* Derived types are recorded by path, so that they are read back as the same type. */
+	uint32 AddStructType(const UScriptStruct* StructType, const UScriptStruct* BaseStruct)
+	{
+		return StructType && StructType != BaseStruct ? AddString(StructType->GetPathName()) : InvalidString;
+	}
+
+	/* Adds the record of Items[ItemIndex], appending anything socketed into it to Items. */
+	void AddItemRecord(int32 ItemIndex)
+	{
+		const FItemInstance& Item = Items[ItemIndex].Get<const FItemInstance>();
+
+		FItemRecord& Record = ItemRecords.AddDefaulted_GetRef();
+		Record.ItemId = Item.ItemId;
+		Record.ItemSeed = Item.ItemSeed;
+		Record.ItemStreamSeed = Item.ItemStream.GetCurrentSeed();
+		Record.ItemLevel = Item.ItemLevel;
+		Record.AffixLevel = Item.AffixLevel;
+		Record.StackCount = Item.StackCount;
+		Record.ItemDefinition = AddDefinitionReference(Item.GetItemDefinitionHandle());
+		Record.QualityType = Item.QualityType.IsValid() ? AddString(Item.QualityType.ToString()) : InvalidString;
+
+		Record.StructType = AddStructType(Items[ItemIndex].GetScriptStruct(), FItemInstance::StaticStruct());
+
+		for (const TInstancedStruct<FAffixInstance>& Affix : Item.Affixes)
+		{
+			const FAffixInstance* AffixInstance = Affix.GetPtr();
+			if (!AffixInstance || Record.NumAffixes == MaxRecordsPerItem)
+			{
+				continue;
+			}
+
+			FAffixRecord& AffixRecord = AffixRecords.AddDefaulted_GetRef();
+			AffixRecord.AffixDefinition = AddDefinitionReference(AffixInstance->GetAffixDefinitionHandle());
+			AffixRecord.StructType = AddStructType(Affix.GetScriptStruct(), FAffixInstance::StaticStruct());
+			AffixRecord.bPredefinedAffix = AffixInstance->bPredefinedAffix ? 1 : 0;
+			Record.NumAffixes++;
+		}
+
+		const TArray<FGuid>* Handles = GetSocketDefinitionHandles(Item, SocketDefinitionHandles);
+		for (const TInstancedStruct<FItemSocketInstance>& Socket : Item.Sockets)
+		{
+			const FItemSocketInstance* SocketInstance = Socket.GetPtr();
+			if (!SocketInstance || Record.NumSockets == MaxRecordsPerItem)
+			{
+				continue;
+			}
+
+			FSocketRecord& SocketRecord = SocketRecords.AddDefaulted_GetRef();
+			SocketRecord.SocketId = SocketInstance->SocketId;
+			SocketRecord.SocketDefinitionIndex = Handles ? Handles->IndexOfByKey(SocketInstance->SocketDefinitionHandle) : INDEX_NONE;
+			SocketRecord.bIsEmpty = SocketInstance->bIsEmpty ? 1 : 0;
+			SocketRecord.StructType = AddStructType(Socket.GetScriptStruct(), FItemSocketInstance::StaticStruct());
+
+			const FConstStructView SocketedItem = SocketInstance->GetSocketedItem();
+			if (SocketedItem.GetPtr<const FItemInstance>())
+			{
+				SocketRecord.SocketedItem = Items.Add(SocketedItem);
+			}
+
+			Record.NumSockets++;
+		}
+	}
+};
+
+/* Resolves the strings of an archive, each at most once. */
+struct FArchiveResolver
+{
+	const TArray<FString>& Strings;
+
+	TMap<uint32, FDataTableRowHandle> Handles;
+	TMap<uint32, const FItemDefinitionEntry*> ItemDefinitions;
+	TMap<uint32, const FAffixDefinitionEntry*> AffixDefinitions;
+	TMap<uint32, const UScriptStruct*> StructTypes;
+	TMap<uint32, FGameplayTag> Tags;
+	TMap<const UClass*, TArray<FGuid>> SocketDefinitionHandles;
+
+	explicit FArchiveResolver(const TArray<FString>& InStrings) :
+		Strings(InStrings)
+	{ }
+
+	const FDataTableRowHandle& ResolveHandle(uint32 StringIndex)
+	{
+		if (const FDataTableRowHandle* Handle = Handles.Find(StringIndex))
+		{
+			return *Handle;
+		}
+
+		FDataTableRowHandle& Handle = Handles.Add(StringIndex);
+
+		FString TablePath;
+		FString RowName;
+		if (Strings.IsValidIndex(StringIndex) && Strings[StringIndex].Split(TEXT(":"), &TablePath, &RowName, ESearchCase::CaseSensitive, ESearchDir::FromEnd))
+		{
+			Handle.DataTable = FindObject<UDataTable>(nullptr, *TablePath);
+			if (!Handle.DataTable)
+			{
+				Handle.DataTable = LoadObject<UDataTable>(nullptr, *TablePath);
+			}
+			Handle.RowName = FName(*RowName);
+		}
+
+		return Handle;
+	}
+
+	const FItemDefinitionEntry* ResolveItemDefinition(uint32 StringIndex)
+	{
+		if (const FItemDefinitionEntry* const* Entry = ItemDefinitions.Find(StringIndex))
+		{
+			return *Entry;
+		}
+
+		const FDataTableRowHandle& Handle = ResolveHandle(StringIndex);
+		return ItemDefinitions.Add(StringIndex, Handle.IsNull() ? nullptr : Handle.GetRow<FItemDefinitionEntry>(FString()));
+	}
+
+	const FAffixDefinitionEntry* ResolveAffixDefinition(uint32 StringIndex)
+	{
+		if (const FAffixDefinitionEntry* const* Entry = AffixDefinitions.Find(StringIndex))
+		{
+			return *Entry;
+		}
+
+		const FDataTableRowHandle& Handle = ResolveHandle(StringIndex);
+		return AffixDefinitions.Add(StringIndex, Handle.IsNull() ? nullptr : Handle.GetRow<FAffixDefinitionEntry>(FString()));
+	}
+
+	/* Returns the type recorded at the StringIndex, or the BaseStruct if nothing is recorded there or it is not a BaseStruct. */
+	const UScriptStruct* ResolveStructType(uint32 StringIndex, const UScriptStruct* BaseStruct)
+	{
+		if (StringIndex == InvalidString)
+		{
+			return BaseStruct;
+		}
+
+		if (const UScriptStruct* const* StructType = StructTypes.Find(StringIndex))
+		{
+			return (*StructType)->IsChildOf(BaseStruct) ? *StructType : BaseStruct;
+		}
+
+		const UScriptStruct* StructType = Strings.IsValidIndex(StringIndex) ? FindObject<UScriptStruct>(nullptr, *Strings[StringIndex]) : nullptr;
+		if (!StructType || !StructType->IsChildOf(BaseStruct))
+		{
+			UE_LOG(LogGenericItemizationArchive, Warning, TEXT("%s type %s could not be found, reading it as an F%s instead."), *BaseStruct->GetName(), Strings.IsValidIndex(StringIndex) ? *Strings[StringIndex] : TEXT("<invalid>"), *BaseStruct->GetName());
+			StructType = BaseStruct;
+		}
+
+		return StructTypes.Add(StringIndex, StructType);
+	}
+
+	FGameplayTag ResolveTag(uint32 StringIndex)
+	{
+		if (StringIndex == InvalidString || !Strings.IsValidIndex(StringIndex))
+		{
+			return FGameplayTag();
+		}
+
+		if (const FGameplayTag* Tag = Tags.Find(StringIndex))
+		{
+			return *Tag;
+		}
+
+		return Tags.Add(StringIndex, UGameplayTagsManager::Get().RequestGameplayTag(FName(*Strings[StringIndex]), false));
+	}
+};
+
+/* The records of an archive and where each Item record's Affixes and Sockets begin. */
+struct FArchiveContents
+{
+	FArchiveHeader Header;
+	TArray<FString> Strings;
+	TArray<FItemRecord> ItemRecords;
+	TArray<FAffixRecord> AffixRecords;
+	TArray<FSocketRecord> SocketRecords;
+	TArray<FGuid> RemovedItemIds;
+	TArray<uint32> FirstAffix;
+	TArray<uint32> FirstSocket;
+
+	/* Set once an Item record has been read, so that no record is socketed into more than one Socket. */
+	TBitArray<> ReadItems;
+};
+
+static bool ReadContents(FArchive& Ar, int64 TotalSize, FArchiveContents& Contents)
+{
+	FArchiveHeader& Header = Contents.Header;
+	Header.Serialize(Ar);
+	if (Ar.IsError() || Header.Magic != FItemInventoryArchive::Magic)
+	{
+		UE_LOG(LogGenericItemizationArchive, Warning, TEXT("Data is not an ItemInventoryArchive."));
+		return false;
+	}
+
+	if (Header.Version < static_cast<uint32>(EItemInventoryArchiveVersion::Initial) || Header.Version > static_cast<uint32>(EItemInventoryArchiveVersion::LatestVersion))
+	{
+		UE_LOG(LogGenericItemizationArchive, Warning, TEXT("ItemInventoryArchive version %u is not supported, the latest supported version is %u."), Header.Version, static_cast<uint32>(EItemInventoryArchiveVersion::LatestVersion));
+		return false;
+	}
+
+	// Every section must fit in what is left of the data, so that nothing is allocated for counts that can't be real.
+	const int64 MinimumSize = int64(Header.NumStrings) * sizeof(uint32)
+		+ int64(Header.NumItems) * FItemRecord::Size
+		+ int64(Header.NumAffixes) * FAffixRecord::GetSize(Header.Version)
+		+ int64(Header.NumSockets) * FSocketRecord::GetSize(Header.Version)
+		+ int64(Header.NumRemovedItems) * sizeof(FGuid);
+	if (Header.NumSavedItems > Header.NumItems || MinimumSize > TotalSize - Ar.Tell())
+	{
+		UE_LOG(LogGenericItemizationArchive, Warning, TEXT("ItemInventoryArchive is malformed, its sections do not fit within its data."));
+		return false;
+	}
+
+	Contents.Strings.Reserve(Header.NumStrings);
+	TArray<uint8> StringBytes;
+	for (uint32 Index = 0; Index < Header.NumStrings; Index++)
+	{
+		uint32 Length = 0;
+		Ar << Length;
+		if (Ar.IsError() || Length > MaxStringLength || Length > TotalSize - Ar.Tell())
+		{
+			UE_LOG(LogGenericItemizationArchive, Warning, TEXT("ItemInventoryArchive is malformed, its string table is invalid."));
+			return false;
+		}
+
+		StringBytes.SetNumUninitialized(Length, EAllowShrinking::No);
+		Ar.Serialize(StringBytes.GetData(), Length);
+
+		const FUTF8ToTCHAR StringTCHAR(reinterpret_cast<const ANSICHAR*>(StringBytes.GetData()), Length);
+		Contents.Strings.Emplace(StringTCHAR.Length(), StringTCHAR.Get());
+	}
+
+	Contents.ItemRecords.SetNum(Header.NumItems);
+	Contents.FirstAffix.SetNumUninitialized(Header.NumItems);
+	Contents.FirstSocket.SetNumUninitialized(Header.NumItems);
+
+	uint64 NumAffixes = 0;
+	uint64 NumSockets = 0;
+	for (uint32 Index = 0; Index < Header.NumItems; Index++)
+	{
+		FItemRecord& Record = Contents.ItemRecords[Index];
+		Record.Serialize(Ar);
+
+		Contents.FirstAffix[Index] = static_cast<uint32>(NumAffixes);
+		Contents.FirstSocket[Index] = static_cast<uint32>(NumSockets);
+		NumAffixes += Record.NumAffixes;
+		NumSockets += Record.NumSockets;
+	}
+
+	if (NumAffixes != Header.NumAffixes || NumSockets != Header.NumSockets)
+	{
+		UE_LOG(LogGenericItemizationArchive, Warning, TEXT("ItemInventoryArchive is malformed, its Item records do not match its Affix and Socket records."));
+		return false;
+	}
+
+	Contents.AffixRecords.SetNum(Header.NumAffixes);
+	for (FAffixRecord& Record : Contents.AffixRecords)
+	{
+		Record.Serialize(Ar, Header.Version);
+	}
+
+	Contents.SocketRecords.SetNum(Header.NumSockets);
+	for (FSocketRecord& Record : Contents.SocketRecords)
+	{
+		Record.Serialize(Ar, Header.Version);
+	}
+
+	Contents.RemovedItemIds.SetNum(Header.NumRemovedItems);
+	for (FGuid& RemovedItemId : Contents.RemovedItemIds)
+	{
+		Ar << RemovedItemId;
+	}
+
+	Contents.ReadItems.Init(false, Header.NumItems);
+
+	return !Ar.IsError();
+}
+
+/* Builds the ItemInstance of the Item record, and anything socketed into it, into OutItemInstance. */
+static bool ReadItem(FArchiveContents& Contents, FArchiveResolver& Resolver, int32 ItemIndex, int32 Depth, FInstancedStruct& OutItemInstance)
+{
+	if (Contents.ReadItems[ItemIndex])
+	{
+		UE_LOG(LogGenericItemizationArchive, Warning, TEXT("ItemInventoryArchive is malformed, Item record %d is referenced more than once."), ItemIndex);
+		return false;
+	}
+
+	Contents.ReadItems[ItemIndex] = true;
+	const FItemRecord& Record = Contents.ItemRecords[ItemIndex];
+
+	OutItemInstance.InitializeAs(Resolver.ResolveStructType(Record.StructType, FItemInstance::StaticStruct()));
+	FItemInstance& Item = OutItemInstance.GetMutable<FItemInstance>();
+
+	Item.ItemId = Record.ItemId;
+	Item.ItemSeed = Record.ItemSeed;
+	Item.ItemStream.Initialize(Record.ItemStreamSeed);
+	Item.ItemLevel = Record.ItemLevel;
+	Item.AffixLevel = Record.AffixLevel;
+	Item.StackCount = Record.StackCount;
+	Item.QualityType = Resolver.ResolveTag(Record.QualityType);
+
+	if (Record.ItemDefinition != InvalidString)
+	{
+		const FItemDefinitionEntry* ItemDefinitionEntry = Resolver.ResolveItemDefinition(Record.ItemDefinition);
+		Item.SetItemDefinition(Resolver.ResolveHandle(Record.ItemDefinition), ItemDefinitionEntry ? ItemDefinitionEntry->ItemDefinition : TInstancedStruct<FItemDefinition>());
+	}
+
+	Item.Affixes.Reset(Record.NumAffixes);
+	for (const FAffixRecord& AffixRecord : MakeArrayView(Contents.AffixRecords.GetData() + Contents.FirstAffix[ItemIndex], Record.NumAffixes))
+	{
+		TInstancedStruct<FAffixInstance> Affix;
+		Affix.InitializeAsScriptStruct(Resolver.ResolveStructType(AffixRecord.StructType, FAffixInstance::StaticStruct()));
+		FAffixInstance& AffixInstance = Affix.GetMutable();
+		AffixInstance.bPredefinedAffix = AffixRecord.bPredefinedAffix != 0;
+
+		if (AffixRecord.AffixDefinition != InvalidString)
+		{
+			const FAffixDefinitionEntry* AffixDefinitionEntry = Resolver.ResolveAffixDefinition(AffixRecord.AffixDefinition);
+			AffixInstance.SetAffixDefinition(Resolver.ResolveHandle(AffixRecord.AffixDefinition), AffixDefinitionEntry ? AffixDefinitionEntry->AffixDefinition : TInstancedStruct<FAffixDefinition>());
+		}
+
+		Item.Affixes.Add(MoveTemp(Affix));
+	}
+
+	// Sockets are added after the ItemDefinition is set, as they find their SocketDefinitions through it.
+	const TArray<FGuid>* Handles = GetSocketDefinitionHandles(Item, Resolver.SocketDefinitionHandles);
+	Item.Sockets.Reset(Record.NumSockets);
+	for (const FSocketRecord& SocketRecord : MakeArrayView(Contents.SocketRecords.GetData() + Contents.FirstSocket[ItemIndex], Record.NumSockets))
+	{
+		TInstancedStruct<FItemSocketInstance> Socket;
+		Socket.InitializeAsScriptStruct(Resolver.ResolveStructType(SocketRecord.StructType, FItemSocketInstance::StaticStruct()));
+		FItemSocketInstance& SocketInstance = Socket.GetMutable();
+		SocketInstance.SocketId = SocketRecord.SocketId;
+		SocketInstance.bIsEmpty = SocketRecord.bIsEmpty != 0;
+		SocketInstance.SocketDefinitionHandle = Handles && Handles->IsValidIndex(SocketRecord.SocketDefinitionIndex) ? (*Handles)[SocketRecord.SocketDefinitionIndex] : FGuid();
+
+		if (SocketRecord.SocketedItem != INDEX_NONE)
+		{
+			// Socketed Items are always written after the Item they are socketed into.
+			if (SocketRecord.SocketedItem <= ItemIndex || SocketRecord.SocketedItem >= Contents.ItemRecords.Num()
+				|| static_cast<uint32>(SocketRecord.SocketedItem) < Contents.Header.NumSavedItems || Depth >= MaxSocketDepth)
+			{
+				UE_LOG(LogGenericItemizationArchive, Warning, TEXT("ItemInventoryArchive is malformed, Item record %d has an invalid socketed Item."), ItemIndex);
+				return false;
+			}
+
+			if (!ReadItem(Contents, Resolver, SocketRecord.SocketedItem, Depth + 1, SocketInstance.SocketedItemInstance))
+			{
+				return false;
+			}
+		}
+
+		Item.AddSocket(Socket);
+	}
+
+	return true;
+}
+
+static bool WriteArchive(TConstArrayView<FConstStructView> ItemInstances, TConstArrayView<FGuid> RemovedItemIds, uint32 Flags, TArray<uint8>& OutData)
+{
+	OutData.Reset();
+
+	FArchiveWriter Writer;
+	Writer.Items.Reserve(ItemInstances.Num());
+	Writer.ItemRecords.Reserve(ItemInstances.Num());
+	for (const FConstStructView& ItemInstance : ItemInstances)
+	{
+		if (ItemInstance.GetPtr<const FItemInstance>())
+		{
+			Writer.Items.Add(ItemInstance);
+		}
+	}
+
+	const int32 NumSavedItems = Writer.Items.Num();
+
+	// Items grows as socketed ItemInstances are found, they are appended after the ones being saved.
+	for (int32 ItemIndex = 0; ItemIndex < Writer.Items.Num(); ItemIndex++)
+	{
+		Writer.AddItemRecord(ItemIndex);
+	}
+
+	// Readers reject longer strings as malformed, so they are refused here rather than written in a form that cannot be read back.
+	for (const FString& String : Writer.Strings)
+	{
+		if (static_cast<uint32>(FTCHARToUTF8(*String).Length()) > MaxStringLength)
+		{
+			UE_LOG(LogGenericItemizationArchive, Error, TEXT("ItemInventoryArchive could not be written, '%s' is longer than %u bytes."), *String, MaxStringLength);
+			return false;
+		}
+	}
+
+	FArchiveHeader Header;
+	Header.NumItems = Writer.ItemRecords.Num();
+	Header.NumSavedItems = NumSavedItems;
+	Header.NumAffixes = Writer.AffixRecords.Num();
+	Header.NumSockets = Writer.SocketRecords.Num();
+	Header.Flags = Flags;
+	Header.NumRemovedItems = RemovedItemIds.Num();
+
+	FMemoryWriter Ar(OutData);
+
+	Header.NumStrings = Writer.Strings.Num();
+	Header.Serialize(Ar);
+
+	for (const FString& String : Writer.Strings)
+	{
+		const FTCHARToUTF8 StringUTF8(*String);
+		uint32 Length = StringUTF8.Length();
+		Ar << Length;
+		Ar.Serialize(const_cast<ANSICHAR*>(StringUTF8.Get()), Length);
+	}
+
+	for (FItemRecord& Record : Writer.ItemRecords)
+	{
+		Record.Serialize(Ar);
+	}
+
+	for (FAffixRecord& Record : Writer.AffixRecords)
+	{
+		Record.Serialize(Ar, Header.Version);
+	}
+
+	for (FSocketRecord& Record : Writer.SocketRecords)
+	{
+		Record.Serialize(Ar, Header.Version);
+	}
+
+	for (FGuid RemovedItemId : RemovedItemIds)
+	{
+		Ar << RemovedItemId;
+	}
+
+	return true;
+}
+
+}
+
+bool FItemInventoryArchive::Write(TConstArrayView<FConstStructView> ItemInstances, TArray<uint8>& OutData)
+{
+	return ItemInventoryArchivePrivate::WriteArchive(ItemInstances, TConstArrayView<FGuid>(), 0, OutData);
+}
+
+bool FItemInventoryArchive::WriteDelta(TConstArrayView<FConstStructView> ChangedItemInstances, TConstArrayView<FGuid> RemovedItemIds, TArray<uint8>& OutData)
+{
+	return ItemInventoryArchivePrivate::WriteArchive(ChangedItemInstances, RemovedItemIds, ItemInventoryArchivePrivate::DeltaFlag, OutData);
+}
+
+bool FItemInventoryArchive::Read(TConstArrayView<uint8> Data, TArray<FInstancedStruct>& OutItemInstances)
+{
+	TArray<FGuid> RemovedItemIds;
+	bool bIsDelta = false;
+	return Read(Data, OutItemInstances, RemovedItemIds, bIsDelta);
+}
+
+bool FItemInventoryArchive::Read(TConstArrayView<uint8> Data, TArray<FInstancedStruct>& OutItemInstances, TArray<FGuid>& OutRemovedItemIds, bool& bOutIsDelta)
+{
+	using namespace ItemInventoryArchivePrivate;
+
+	OutItemInstances.Reset();
+	OutRemovedItemIds.Reset();
+	bOutIsDelta = false;
+
+	FMemoryReaderView Ar(Data);
+	FArchiveContents Contents;
+	if (!ReadContents(Ar, Data.Num(), Contents))
+	{
+		return false;
+	}
+
+	FArchiveResolver Resolver(Contents.Strings);
+
+	OutItemInstances.SetNum(Contents.Header.NumSavedItems);
+	for (uint32 ItemIndex = 0; ItemIndex < Contents.Header.NumSavedItems; ItemIndex++)
+	{
+		if (!ReadItem(Contents, Resolver, ItemIndex, 0, OutItemInstances[ItemIndex]))
+		{
+			OutItemInstances.Reset();
+			return false;
+		}
+	}
+
+	OutRemovedItemIds = MoveTemp(Contents.RemovedItemIds);
+	bOutIsDelta = (Contents.Header.Flags & DeltaFlag) != 0;
+
+	return true;
+}
+
+bool FItemInventoryArchive::Compact(TConstArrayView<uint8> Snapshot, TConstArrayView<TConstArrayView<uint8>> Deltas, TArray<uint8>& OutSnapshot)
+{
+	TArray<FInstancedStruct> ItemInstances;
+	TArray<FGuid> RemovedItemIds;
+	bool bIsDelta = false;
+	if (!Read(Snapshot, ItemInstances, RemovedItemIds, bIsDelta))
+	{
+		return false;
+	}
+
+	if (bIsDelta)
+	{
+		UE_LOG(LogGenericItemizationArchive, Warning, TEXT("ItemInventoryArchives can only be compacted onto a snapshot, not a delta."));
+		return false;
+	}
+
+	TMap<FGuid, int32> ItemIdToIndex;
+	const auto IndexItemInstances = [&ItemInstances, &ItemIdToIndex]()
+	{
+		ItemIdToIndex.Reset();
+		ItemIdToIndex.Reserve(ItemInstances.Num());
+		for (int32 Index = 0; Index < ItemInstances.Num(); Index++)
+		{
+			ItemIdToIndex.Add(ItemInstances[Index].Get<FItemInstance>().ItemId, Index);
+		}
+	};
+
+	IndexItemInstances();
+
+	TArray<FInstancedStruct> DeltaItemInstances;
+	for (const TConstArrayView<uint8>& Delta : Deltas)
+	{
+		if (!Read(Delta, DeltaItemInstances, RemovedItemIds, bIsDelta))
+		{
+			return false;
+		}
+
+		if (!bIsDelta)
+		{
+			ItemInstances = MoveTemp(DeltaItemInstances);
+			IndexItemInstances();
+			continue;
+		}
+
+		// Removed ItemInstances are only Reset here, so that the indices of the others stay valid.
+		for (const FGuid& RemovedItemId : RemovedItemIds)
+		{
+			int32 Index = INDEX_NONE;
+			if (ItemIdToIndex.RemoveAndCopyValue(RemovedItemId, Index))
+			{
+				ItemInstances[Index].Reset();
+			}
+		}
+
+		for (FInstancedStruct& DeltaItemInstance : DeltaItemInstances)
+		{
+			const FGuid ItemId = DeltaItemInstance.Get<FItemInstance>().ItemId;
+			if (const int32* Index = ItemIdToIndex.Find(ItemId))
+			{
+				ItemInstances[*Index] = MoveTemp(DeltaItemInstance);
+			}
+			else
+			{
+				ItemIdToIndex.Add(ItemId, ItemInstances.Num());
+				ItemInstances.Add(MoveTemp(DeltaItemInstance));
+			}
+		}
+	}
+
+	TArray<FConstStructView> ItemInstanceViews;
+	ItemInstanceViews.Reserve(ItemIdToIndex.Num());
+	for (const FInstancedStruct& ItemInstance : ItemInstances)
+	{
+		if (ItemInstance.IsValid())
+		{
+			ItemInstanceViews.Add(FConstStructView(ItemInstance));
+		}
+	}
+
+	return Write(ItemInstanceViews, OutSnapshot);
+}
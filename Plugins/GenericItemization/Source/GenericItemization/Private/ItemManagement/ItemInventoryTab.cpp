@@ -0,0 +1,18 @@
+// Copyright Fissure Entertainment, Pty Ltd. All Rights Reserved.
+
+#include "ItemManagement/ItemInventoryTab.h"
+#include "ItemManagement/ItemInventoryComponent.h"
+#include "Net/UnrealNetwork.h"
+
+void UItemInventoryTab::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	// Whether each Connection is written to is decided per tab by FFastItemInstancesContainer::NetDeltaSerialize.
+	DOREPLIFETIME(UItemInventoryTab, ItemInstances);
+}
+
+UItemInventoryComponent* UItemInventoryTab::GetInventory() const
+{
+	return GetTypedOuter<UItemInventoryComponent>();
+}
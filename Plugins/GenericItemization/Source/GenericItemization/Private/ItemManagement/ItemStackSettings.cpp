@@ -3,6 +3,20 @@
 #include "ItemManagement/ItemStackSettings.h"
 #include "GenericItemizationInstanceTypes.h"
 
+/* Returns true if every Affix on the ItemInstance is a Predefined Affix. */
+static bool HasOnlyPredefinedAffixes(const FItemInstance& ItemInstance)
+{
+	for (const TInstancedStruct<FAffixInstance>& Affix : ItemInstance.Affixes)
+	{
+		if (!Affix.Get().bPredefinedAffix)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
 UItemStackSettings::UItemStackSettings()
 {
 	StackingRequirements = TInstancedStruct<FItemStackingRequirements>::Make();
@@ -65,16 +79,9 @@ bool UItemStackSettings::CanStackWith_Implementation(const FInstancedStruct& Ite
 	if (!StackSettingsCDO->StackingRequirements.Get().bIgnoreAffixes)
 	{
 		// Check if there are any Affixes that are not Predefined, if there are then we assume they cannot be reconciled.
-		TArray<TInstancedStruct<FAffixInstance>> Affixes;
-		Affixes.Append(ItemToStackFromPtr->Affixes);
-		Affixes.Append(ItemToStackWithPtr->Affixes);
-
-		for (const TInstancedStruct<FAffixInstance>& Affix : Affixes)
+		if (!HasOnlyPredefinedAffixes(*ItemToStackFromPtr) || !HasOnlyPredefinedAffixes(*ItemToStackWithPtr))
 		{
-			if (!Affix.Get().bPredefinedAffix)
-			{
-				return false;
-			}
+			return false;
 		}
 	}
 
@@ -116,3 +123,57 @@ bool UItemStackSettings::CanStackWith_Implementation(const FInstancedStruct& Ite
 
 	return true;
 }
+
+bool UItemStackSettings::ComputeStackKey(const FItemInstance& ItemInstance, uint32& OutStackKey) const
+{
+	const FItemDefinition* const ItemDefinition = ItemInstance.GetItemDefinition().GetPtr();
+	if (!ItemDefinition || !IsStackable())
+	{
+		return false;
+	}
+
+	const FItemStackingRequirements& Requirements = StackingRequirements.Get();
+	if (!Requirements.DoesNotStackWithQualityTypes.IsEmpty() && ItemInstance.QualityType.MatchesAny(Requirements.DoesNotStackWithQualityTypes))
+	{
+		return false;
+	}
+
+	if (!Requirements.bIgnoreAffixes && !HasOnlyPredefinedAffixes(ItemInstance))
+	{
+		return false;
+	}
+
+	// The same fields that FItemDefinition::IsSameItemDefinition compares.
+	uint32 StackKey = HashCombine(GetTypeHash(ItemDefinition->ItemType), GetTypeHash(ItemDefinition->ItemIdentifier));
+
+	if (!Requirements.bIgnoreQualityLevel)
+	{
+		StackKey = HashCombine(StackKey, GetTypeHash(ItemDefinition->QualityLevel));
+	}
+
+	if (!Requirements.bIgnoreItemLevel)
+	{
+		StackKey = HashCombine(StackKey, GetTypeHash(ItemInstance.ItemLevel));
+	}
+
+	if (!Requirements.bIgnoreAffixLevel)
+	{
+		StackKey = HashCombine(StackKey, GetTypeHash(ItemInstance.AffixLevel));
+	}
+
+	OutStackKey = StackKey;
+	return true;
+}
+
+bool UItemStackSettings::SupportsStackKeys() const
+{
+	// A C++ override of CanStackWith is expected to override ComputeStackKey alongside it, a Blueprint one cannot.
+	return !GetClass()->IsFunctionImplementedInScript(GET_FUNCTION_NAME_CHECKED(UItemStackSettings, CanStackWith));
+}
+
+bool UItemStackSettings::GetStackKeyForItemInstance(const FItemInstance& ItemInstance, uint32& OutStackKey)
+{
+	const FItemDefinition* const ItemDefinition = ItemInstance.GetItemDefinition().GetPtr();
+	const UItemStackSettings* const StackSettingsCDO = ItemDefinition ? ItemDefinition->StackSettings.GetDefaultObject() : nullptr;
+	return StackSettingsCDO && StackSettingsCDO->SupportsStackKeys() && StackSettingsCDO->ComputeStackKey(ItemInstance, OutStackKey);
+}
@@ -0,0 +1,714 @@
+// Copyright Fissure Entertainment, Pty Ltd. All Rights Reserved.
+
+#include "ItemManagement/ItemStashStorage.h"
+#include "ItemManagement/ItemInventorySerialization.h"
+#include "ItemManagement/ItemInventoryComponent.h"
+#include "GenericItemizationInstanceTypes.h"
+#include "GenericItemizationSettings.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/Crc.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MemoryReader.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogGenericItemizationStash, Log, All);
+
+namespace ItemStashStoragePrivate
+{
+
+/* Identifies the first page of the file as a stash. */
+static constexpr uint32 StashMagic = 0x54534947;
+
+/* Identifies a page of the file as a commit record. */
+static constexpr uint32 CommitMagic = 0x54494D43;
+
+static constexpr uint32 StashVersion = 1;
+
+/* The bounds a page size must be within. The page size is stored in each file, so these only guard against malformed files. */
+static constexpr uint32 MinFilePageSize = 1024;
+static constexpr uint32 MaxFilePageSize = 16 * 1024 * 1024;
+
+/* The first page of the file. */
+struct FStashHeader
+{
+	uint32 Magic = StashMagic;
+	uint32 Version = StashVersion;
+	uint32 FilePageSize = 0;
+
+	static constexpr int64 Size = 3 * 4;
+
+	void Serialize(FArchive& Ar)
+	{
+		Ar << Magic << Version << FilePageSize;
+	}
+};
+
+/* The last page written by each Flush, which points to the page table that it committed. */
+struct FCommitRecord
+{
+	uint32 Magic = CommitMagic;
+	uint32 PageTableFirstFilePage = 0;
+	uint32 PageTableNumFilePages = 0;
+	uint32 NumPageTableEntries = 0;
+	uint32 NumTabs = 0;
+	uint32 PageTableCrc = 0;
+
+	/* The size of the fields above, which are followed by their Crc. */
+	static constexpr int64 Size = 6 * 4;
+
+	void Serialize(FArchive& Ar)
+	{
+		Ar << Magic << PageTableFirstFilePage << PageTableNumFilePages << NumPageTableEntries << NumTabs << PageTableCrc;
+	}
+};
+
+/* The location of one page of a tab. Entries are written in the order of the tabs and their pages. */
+struct FPageTableEntry
+{
+	uint32 Tab = 0;
+	uint32 FirstFilePage = 0;
+	uint32 NumFilePages = 0;
+	uint32 DataSize = 0;
+	uint32 NumItems = 0;
+
+	static constexpr int64 Size = 5 * 4;
+
+	void Serialize(FArchive& Ar)
+	{
+		Ar << Tab << FirstFilePage << NumFilePages << DataSize << NumItems;
+	}
+};
+
+/* Returns the number of pages of the file that Size bytes occupy. */
+static uint32 GetNumFilePages(int64 Size, uint32 FilePageSize)
+{
+	return static_cast<uint32>(FMath::DivideAndRoundUp<int64>(Size, FilePageSize));
+}
+
+/* Writes the Data to the end of the File, padded out to a whole number of pages. */
+static bool WriteFilePages(IFileHandle& File, TConstArrayView<uint8> Data, uint32 FilePageSize)
+{
+	if (!Data.IsEmpty() && !File.Write(Data.GetData(), Data.Num()))
+	{
+		return false;
+	}
+
+	const int64 PaddingSize = static_cast<int64>(GetNumFilePages(Data.Num(), FilePageSize)) * FilePageSize - Data.Num();
+	if (PaddingSize > 0)
+	{
+		TArray<uint8> Padding;
+		Padding.SetNumZeroed(static_cast<int32>(PaddingSize));
+		return File.Write(Padding.GetData(), Padding.Num());
+	}
+
+	return true;
+}
+
+/* Returns the commit record written to the page of the file, false if there isn't a valid one. */
+static bool ReadCommitRecord(TConstArrayView<uint8> Data, FCommitRecord& OutCommit)
+{
+	FMemoryReaderView Ar(Data);
+	OutCommit.Serialize(Ar);
+
+	uint32 RecordCrc = 0;
+	Ar << RecordCrc;
+
+	return !Ar.IsError() && OutCommit.Magic == CommitMagic && RecordCrc == FCrc::MemCrc32(Data.GetData(), FCommitRecord::Size);
+}
+
+/* The files Compact writes alongside the stash, the compacted copy and the previous file while it is being replaced. */
+static FString GetTempFilename(const FString& Filename) { return Filename + TEXT(".tmp"); }
+static FString GetBackupFilename(const FString& Filename) { return Filename + TEXT(".bak"); }
+
+/**
+ * Finishes a Compact that was interrupted while replacing the file. The previous file is only moved to its backup once the compacted
+ * copy is complete, so if the file is missing the backup is restored, and if the file exists the backup and any copy are left over.
+ */
+static void RecoverInterruptedCompact(IPlatformFile& PlatformFile, const FString& Filename)
+{
+	const FString BackupFilename = GetBackupFilename(Filename);
+	if (PlatformFile.FileExists(*BackupFilename))
+	{
+		if (!PlatformFile.FileExists(*Filename))
+		{
+			UE_LOG(LogGenericItemizationStash, Warning, TEXT("Restoring %s from %s, it was being compacted."), *Filename, *BackupFilename);
+			PlatformFile.MoveFile(*Filename, *BackupFilename);
+		}
+		else
+		{
+			PlatformFile.DeleteFile(*BackupFilename);
+		}
+	}
+
+	const FString TempFilename = GetTempFilename(Filename);
+	if (PlatformFile.FileExists(*TempFilename))
+	{
+		PlatformFile.DeleteFile(*TempFilename);
+	}
+}
+
+}
+
+void UItemStashStorage::BeginDestroy()
+{
+	Close();
+
+	Super::BeginDestroy();
+}
+
+bool UItemStashStorage::Open(const FString& InFilename)
+{
+	using namespace ItemStashStoragePrivate;
+
+	Close();
+
+	if (InFilename.IsEmpty())
+	{
+		return false;
+	}
+
+	Filename = InFilename;
+	FilePageSize = static_cast<uint32>(FMath::Clamp<int32>(GetDefault<UGenericItemizationSettings>()->ItemStashPageSize, MinFilePageSize, MaxFilePageSize));
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	RecoverInterruptedCompact(PlatformFile, Filename);
+
+	if (!PlatformFile.FileExists(*Filename))
+	{
+		return true;
+	}
+
+	if (!MapFile() || !ReadPageTable())
+	{
+		UE_LOG(LogGenericItemizationStash, Warning, TEXT("%s is not a valid item stash."), *InFilename);
+		Close();
+		return false;
+	}
+
+	return true;
+}
+
+void UItemStashStorage::Close()
+{
+	UnmapFile();
+
+	Filename.Reset();
+	FilePageSize = 0;
+	NumFilePages = 0;
+	Tabs.Reset();
+	bNeedsCompaction = false;
+	bHasPendingChanges = false;
+}
+
+int32 UItemStashStorage::GetNumItemsInTab(int32 Tab) const
+{
+	if (!Tabs.IsValidIndex(Tab))
+	{
+		return 0;
+	}
+
+	int32 NumItems = 0;
+	for (const FItemStashPage& Page : Tabs[Tab])
+	{
+		NumItems += Page.NumItems;
+	}
+
+	return NumItems;
+}
+
+bool UItemStashStorage::LoadTab(int32 Tab, TArray<FInstancedStruct>& OutItems) const
+{
+	if (!Tabs.IsValidIndex(Tab))
+	{
+		return false;
+	}
+
+	const int32 NumOriginalItems = OutItems.Num();
+	OutItems.Reserve(NumOriginalItems + GetNumItemsInTab(Tab));
+
+	TArray<FInstancedStruct> PageItems;
+	for (const FItemStashPage& Page : Tabs[Tab])
+	{
+		const TConstArrayView<uint8> Data = GetPageData(Page);
+		if (Data.IsEmpty() || !FItemInventoryArchive::Read(Data, PageItems))
+		{
+			UE_LOG(LogGenericItemizationStash, Warning, TEXT("A page of tab %d of %s could not be read."), Tab, *Filename);
+			OutItems.SetNum(NumOriginalItems);
+			return false;
+		}
+
+		for (FInstancedStruct& PageItem : PageItems)
+		{
+			OutItems.Add(MoveTemp(PageItem));
+		}
+	}
+
+	return true;
+}
+
+int32 UItemStashStorage::LoadTabIntoInventory(int32 Tab, UItemInventoryComponent* Inventory) const
+{
+	if (!Inventory)
+	{
+		return -1;
+	}
+
+	TArray<FInstancedStruct> Items;
+	if (!LoadTab(Tab, Items))
+	{
+		return -1;
+	}
+
+	return Inventory->LoadItemInstances(MoveTemp(Items));
+}
+
+bool UItemStashStorage::WriteTab(int32 Tab, TConstArrayView<FConstStructView> Items)
+{
+	if (!IsOpen() || Tab < 0 || Tab >= MaxTabs)
+	{
+		return false;
+	}
+
+	if (Tab >= Tabs.Num())
+	{
+		Tabs.SetNum(Tab + 1);
+		bHasPendingChanges = true;
+	}
+
+	const int32 ItemsPerPage = FMath::Max(GetDefault<UGenericItemizationSettings>()->ItemStashItemsPerPage, 1);
+
+	TArray<FItemStashPage>& OldPages = Tabs[Tab];
+	TArray<FItemStashPage> NewPages;
+	NewPages.Reserve(FMath::DivideAndRoundUp(Items.Num(), ItemsPerPage));
+
+	// Pages that are kept are only moved over once every page was written, so that the tab is left as it was if one could not be.
+	TArray<int32> KeptPages;
+	TArray<uint8> Data;
+	for (int32 FirstItem = 0; FirstItem < Items.Num(); FirstItem += ItemsPerPage)
+	{
+		const TConstArrayView<FConstStructView> PageItems = Items.Slice(FirstItem, FMath::Min(ItemsPerPage, Items.Num() - FirstItem));
+		if (!FItemInventoryArchive::Write(PageItems, Data))
+		{
+			return false;
+		}
+
+		// A page that is written with the same contents it already has keeps its place in the file, so only the pages that changed are written by Flush.
+		const int32 PageIndex = NewPages.Num();
+		if (OldPages.IsValidIndex(PageIndex))
+		{
+			const TConstArrayView<uint8> OldData = GetPageData(OldPages[PageIndex]);
+			if (OldData.Num() == Data.Num() && FMemory::Memcmp(OldData.GetData(), Data.GetData(), Data.Num()) == 0)
+			{
+				KeptPages.Add(PageIndex);
+				NewPages.AddDefaulted();
+				continue;
+			}
+		}
+
+		FItemStashPage& NewPage = NewPages.AddDefaulted_GetRef();
+		NewPage.DataSize = Data.Num();
+		NewPage.PendingData = MoveTemp(Data);
+		for (const FConstStructView& PageItem : PageItems)
+		{
+			NewPage.NumItems += PageItem.GetPtr<const FItemInstance>() ? 1 : 0;
+		}
+
+		bHasPendingChanges = true;
+	}
+
+	for (const int32 PageIndex : KeptPages)
+	{
+		NewPages[PageIndex] = MoveTemp(OldPages[PageIndex]);
+	}
+
+	bHasPendingChanges |= NewPages.Num() != OldPages.Num();
+	OldPages = MoveTemp(NewPages);
+
+	return true;
+}
+
+bool UItemStashStorage::WriteTabFromInventory(int32 Tab, const UItemInventoryComponent* Inventory)
+{
+	if (!Inventory)
+	{
+		return false;
+	}
+
+	TArray<FConstStructView> Items;
+	Items.Reserve(Inventory->GetItemsView().Num());
+	Inventory->ForEachItem([&Items](FConstStructView ItemInstance, FConstStructView UserContextData)
+	{
+		Items.Add(ItemInstance);
+		return true;
+	});
+
+	return WriteTab(Tab, Items);
+}
+
+bool UItemStashStorage::Flush()
+{
+	if (!IsOpen())
+	{
+		return false;
+	}
+
+	if (!bHasPendingChanges)
+	{
+		return true;
+	}
+
+	// A new file is created by compacting, as is one that has pages beyond its last commit or that is mostly pages that are no longer used.
+	if (NumFilePages == 0 || bNeedsCompaction || NumFilePages > 2 * GetNumLiveFilePages())
+	{
+		return Compact();
+	}
+
+	// Pages that are not pending are not read while appending, so the mapping is released before the file is written to.
+	UnmapFile();
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	TArray<uint32> PageLocations;
+	uint32 NewNumFilePages = 0;
+	bool bWritten = false;
+	{
+		TUniquePtr<IFileHandle> File(PlatformFile.OpenWrite(*Filename, true));
+		bWritten = File.IsValid() && File->Size() == static_cast<int64>(NumFilePages) * FilePageSize && WriteCommit(*File, NumFilePages, false, PageLocations, NewNumFilePages);
+	}
+
+	if (bWritten)
+	{
+		ApplyCommit(PageLocations, NewNumFilePages);
+	}
+	else
+	{
+		// The previous commit is still the last valid one, but anything that was written after it must be compacted away before appending again.
+		UE_LOG(LogGenericItemizationStash, Warning, TEXT("Failed to write to %s, its pending pages are kept."), *Filename);
+		bNeedsCompaction = true;
+	}
+
+	if (!MapFile())
+	{
+		UE_LOG(LogGenericItemizationStash, Error, TEXT("Failed to map %s after writing to it."), *Filename);
+		return false;
+	}
+
+	return bWritten;
+}
+
+bool UItemStashStorage::Compact()
+{
+	using namespace ItemStashStoragePrivate;
+
+	if (!IsOpen())
+	{
+		return false;
+	}
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	const FString TempFilename = GetTempFilename(Filename);
+	const FString BackupFilename = GetBackupFilename(Filename);
+
+	TArray<uint32> PageLocations;
+	uint32 NewNumFilePages = 0;
+	bool bWritten = false;
+	{
+		TUniquePtr<IFileHandle> File(PlatformFile.OpenWrite(*TempFilename));
+		if (File.IsValid())
+		{
+			FStashHeader Header;
+			Header.FilePageSize = FilePageSize;
+
+			TArray<uint8> HeaderData;
+			FMemoryWriter Ar(HeaderData);
+			Header.Serialize(Ar);
+
+			bWritten = WriteFilePages(*File, HeaderData, FilePageSize) && WriteCommit(*File, 1, true, PageLocations, NewNumFilePages);
+		}
+	}
+
+	if (!bWritten)
+	{
+		UE_LOG(LogGenericItemizationStash, Warning, TEXT("Failed to compact %s, it is left as it was."), *Filename);
+		PlatformFile.DeleteFile(*TempFilename);
+		return false;
+	}
+
+	// The previous file is only replaced once the compacted one is complete, and is kept as a backup until it has been.
+	// There is always a complete file to recover from if this is interrupted, see RecoverInterruptedCompact.
+	UnmapFile();
+	const bool bHadFile = PlatformFile.FileExists(*Filename);
+	if (bHadFile && PlatformFile.FileExists(*BackupFilename))
+	{
+		PlatformFile.DeleteFile(*BackupFilename);
+	}
+
+	if (bHadFile && !PlatformFile.MoveFile(*BackupFilename, *Filename))
+	{
+		UE_LOG(LogGenericItemizationStash, Error, TEXT("Failed to move %s to %s before replacing it with its compacted copy."), *Filename, *BackupFilename);
+		PlatformFile.DeleteFile(*TempFilename);
+		MapFile();
+		return false;
+	}
+
+	if (!PlatformFile.MoveFile(*Filename, *TempFilename))
+	{
+		UE_LOG(LogGenericItemizationStash, Error, TEXT("Failed to replace %s with its compacted copy %s."), *Filename, *TempFilename);
+		PlatformFile.DeleteFile(*TempFilename);
+		if (bHadFile && PlatformFile.MoveFile(*Filename, *BackupFilename))
+		{
+			MapFile();
+		}
+
+		return false;
+	}
+
+	if (bHadFile)
+	{
+		PlatformFile.DeleteFile(*BackupFilename);
+	}
+
+	ApplyCommit(PageLocations, NewNumFilePages);
+	bNeedsCompaction = false;
+
+	if (!MapFile())
+	{
+		UE_LOG(LogGenericItemizationStash, Error, TEXT("Failed to map %s after compacting it."), *Filename);
+		return false;
+	}
+
+	return true;
+}
+
+bool UItemStashStorage::MapFile()
+{
+	UnmapFile();
+
+	MappedFile.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*Filename));
+	if (MappedFile.IsValid() && MappedFile->GetFileSize() > 0)
+	{
+		MappedRegion.Reset(MappedFile->MapRegion(0, MappedFile->GetFileSize()));
+	}
+
+	if (!MappedRegion.IsValid())
+	{
+		UnmapFile();
+		return false;
+	}
+
+	return true;
+}
+
+void UItemStashStorage::UnmapFile()
+{
+	// The region must be released before the handle it was mapped from.
+	MappedRegion.Reset();
+	MappedFile.Reset();
+}
+
+bool UItemStashStorage::ReadPageTable()
+{
+	using namespace ItemStashStoragePrivate;
+
+	const uint8* FileData = MappedRegion->GetMappedPtr();
+	const int64 FileSize = MappedRegion->GetMappedSize();
+	if (FileSize < FStashHeader::Size)
+	{
+		return false;
+	}
+
+	FStashHeader Header;
+	FMemoryReaderView HeaderAr(MakeArrayView(FileData, FStashHeader::Size));
+	Header.Serialize(HeaderAr);
+
+	if (Header.Magic != StashMagic || Header.Version > StashVersion || Header.FilePageSize < MinFilePageSize || Header.FilePageSize > MaxFilePageSize)
+	{
+		return false;
+	}
+
+	FilePageSize = Header.FilePageSize;
+
+	// A Flush that failed part way through can leave pages after the last commit, so the last page that holds a valid commit record is searched for.
+	for (int64 CommitFilePage = FileSize / FilePageSize - 1; CommitFilePage >= 1; CommitFilePage--)
+	{
+		FCommitRecord Commit;
+		if (!ReadCommitRecord(MakeArrayView(FileData + CommitFilePage * FilePageSize, FCommitRecord::Size + sizeof(uint32)), Commit))
+		{
+			continue;
+		}
+
+		const int64 PageTableSize = static_cast<int64>(Commit.NumPageTableEntries) * FPageTableEntry::Size;
+		if (Commit.NumTabs > MaxTabs
+			|| Commit.PageTableFirstFilePage < 1
+			|| static_cast<int64>(Commit.PageTableFirstFilePage) + Commit.PageTableNumFilePages > CommitFilePage
+			|| PageTableSize > static_cast<int64>(Commit.PageTableNumFilePages) * FilePageSize)
+		{
+			continue;
+		}
+
+		const TConstArrayView<uint8> PageTableData = MakeArrayView(FileData + static_cast<int64>(Commit.PageTableFirstFilePage) * FilePageSize, static_cast<int32>(PageTableSize));
+		if (FCrc::MemCrc32(PageTableData.GetData(), PageTableData.Num()) != Commit.PageTableCrc)
+		{
+			continue;
+		}
+
+		Tabs.SetNum(Commit.NumTabs);
+
+		FMemoryReaderView Ar(PageTableData);
+		for (uint32 EntryIndex = 0; EntryIndex < Commit.NumPageTableEntries; EntryIndex++)
+		{
+			FPageTableEntry Entry;
+			Entry.Serialize(Ar);
+
+			if (Entry.Tab >= Commit.NumTabs
+				|| Entry.FirstFilePage < 1
+				|| Entry.DataSize == 0
+				|| Entry.NumFilePages != GetNumFilePages(Entry.DataSize, FilePageSize)
+				|| static_cast<int64>(Entry.FirstFilePage) + Entry.NumFilePages > CommitFilePage)
+			{
+				Tabs.Reset();
+				return false;
+			}
+
+			FItemStashPage& Page = Tabs[Entry.Tab].AddDefaulted_GetRef();
+			Page.FirstFilePage = Entry.FirstFilePage;
+			Page.NumFilePages = Entry.NumFilePages;
+			Page.DataSize = Entry.DataSize;
+			Page.NumItems = Entry.NumItems;
+		}
+
+		NumFilePages = static_cast<uint32>(CommitFilePage + 1);
+		bNeedsCompaction = FileSize != static_cast<int64>(NumFilePages) * FilePageSize;
+
+		return true;
+	}
+
+	return false;
+}
+
+TConstArrayView<uint8> UItemStashStorage::GetPageData(const FItemStashPage& Page) const
+{
+	if (Page.IsPending())
+	{
+		return Page.PendingData;
+	}
+
+	const int64 Offset = static_cast<int64>(Page.FirstFilePage) * FilePageSize;
+	if (!MappedRegion.IsValid() || Page.FirstFilePage < 1 || Offset + Page.DataSize > MappedRegion->GetMappedSize())
+	{
+		return TConstArrayView<uint8>();
+	}
+
+	return MakeArrayView(MappedRegion->GetMappedPtr() + Offset, static_cast<int32>(Page.DataSize));
+}
+
+uint32 UItemStashStorage::GetNumLiveFilePages() const
+{
+	using namespace ItemStashStoragePrivate;
+
+	// The header and the commit record.
+	uint32 NumLiveFilePages = 2;
+
+	int64 NumPageTableEntries = 0;
+	for (const TArray<FItemStashPage>& Pages : Tabs)
+	{
+		for (const FItemStashPage& Page : Pages)
+		{
+			NumLiveFilePages += GetNumFilePages(Page.DataSize, FilePageSize);
+		}
+
+		NumPageTableEntries += Pages.Num();
+	}
+
+	return NumLiveFilePages + GetNumFilePages(NumPageTableEntries * FPageTableEntry::Size, FilePageSize);
+}
+
+bool UItemStashStorage::WriteCommit(IFileHandle& File, uint32 FirstFilePage, bool bWriteAllPages, TArray<uint32>& OutPageLocations, uint32& OutNumFilePages) const
+{
+	using namespace ItemStashStoragePrivate;
+
+	uint32 NextFilePage = FirstFilePage;
+
+	TArray<uint8> PageTableData;
+	FMemoryWriter PageTableAr(PageTableData);
+
+	FCommitRecord Commit;
+	Commit.NumTabs = Tabs.Num();
+
+	for (int32 Tab = 0; Tab < Tabs.Num(); Tab++)
+	{
+		for (const FItemStashPage& Page : Tabs[Tab])
+		{
+			FPageTableEntry Entry;
+			Entry.Tab = Tab;
+			Entry.FirstFilePage = Page.FirstFilePage;
+			Entry.NumFilePages = GetNumFilePages(Page.DataSize, FilePageSize);
+			Entry.DataSize = Page.DataSize;
+			Entry.NumItems = Page.NumItems;
+
+			if (bWriteAllPages || Page.IsPending())
+			{
+				const TConstArrayView<uint8> Data = GetPageData(Page);
+				if (Data.IsEmpty() || !WriteFilePages(File, Data, FilePageSize))
+				{
+					return false;
+				}
+
+				Entry.FirstFilePage = NextFilePage;
+				NextFilePage += Entry.NumFilePages;
+			}
+
+			Entry.Serialize(PageTableAr);
+			OutPageLocations.Add(Entry.FirstFilePage);
+			Commit.NumPageTableEntries++;
+		}
+	}
+
+	Commit.PageTableFirstFilePage = NextFilePage;
+	Commit.PageTableNumFilePages = GetNumFilePages(PageTableData.Num(), FilePageSize);
+	Commit.PageTableCrc = FCrc::MemCrc32(PageTableData.GetData(), PageTableData.Num());
+	if (!WriteFilePages(File, PageTableData, FilePageSize))
+	{
+		return false;
+	}
+
+	NextFilePage += Commit.PageTableNumFilePages;
+
+	// Everything the commit record points to must be written before it is.
+	if (!File.Flush(true))
+	{
+		return false;
+	}
+
+	TArray<uint8> CommitData;
+	FMemoryWriter CommitAr(CommitData);
+	Commit.Serialize(CommitAr);
+
+	uint32 RecordCrc = FCrc::MemCrc32(CommitData.GetData(), CommitData.Num());
+	CommitAr << RecordCrc;
+
+	if (!WriteFilePages(File, CommitData, FilePageSize) || !File.Flush(true))
+	{
+		return false;
+	}
+
+	OutNumFilePages = NextFilePage + 1;
+	return true;
+}
+
+void UItemStashStorage::ApplyCommit(const TArray<uint32>& PageLocations, uint32 InNumFilePages)
+{
+	using namespace ItemStashStoragePrivate;
+
+	int32 PageLocationIndex = 0;
+	for (TArray<FItemStashPage>& Pages : Tabs)
+	{
+		for (FItemStashPage& Page : Pages)
+		{
+			Page.FirstFilePage = PageLocations[PageLocationIndex++];
+			Page.NumFilePages = GetNumFilePages(Page.DataSize, FilePageSize);
+			Page.PendingData.Empty();
+		}
+	}
+
+	NumFilePages = InNumFilePages;
+	bHasPendingChanges = false;
+}
@@ -11,4 +11,8 @@ public:
 
 	virtual void StartupModule() override;
 	virtual void ShutdownModule() override;
+
+private:
+
+	FDelegateHandle ReloadCompleteHandle;
 };
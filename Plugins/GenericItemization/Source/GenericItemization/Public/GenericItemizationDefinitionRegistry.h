@@ -0,0 +1,146 @@
+// Copyright Fissure Entertainment, Pty Ltd. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/EngineSubsystem.h"
+#include "Engine/DataTable.h"
+#include "InstancedStruct.h"
+#include "Misc/NetworkVersion.h"
+#include "GenericItemizationDefinitionRegistry.generated.h"
+
+struct FItemDefinition;
+struct FAffixDefinition;
+struct FItemDefinitionEntry;
+struct FAffixDefinitionEntry;
+struct FItemSocketDefinition;
+class UItemSocketSettings;
+
+/**
+ * Assigns a compact, deterministic Id to every ItemDefinition, AffixDefinition and SocketDefinition that is known to the project.
+ *
+ * Ids are assigned by sorting the registered DataTables by their path and then their rows by name, so any two processes that have the same
+ * content will agree on them. This lets ItemInstances replicate a packed integer instead of a DataTable reference and RowName, and lets
+ * Clients resolve definitions with an array index instead of a row lookup.
+ *
+ * The Registry is built when the Engine starts, or once the Asset Registry has finished its initial scan when auto discovering DataTables.
+ * Its Checksum is folded into the local network version, so a Client whose Registry differs from the Server's is refused during the
+ * connection handshake rather than decoding Ids that resolve to the wrong definitions.
+ * See UGenericItemizationSettings for controlling which DataTables are registered.
+ */
+UCLASS()
+class GENERICITEMIZATION_API UGenericItemizationDefinitionRegistry : public UEngineSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	/* The Id that represents a definition that is not registered. */
+	static constexpr uint32 InvalidId = 0;
+
+	/* Returns the Registry, or nullptr if the Engine is not available. */
+	static UGenericItemizationDefinitionRegistry* Get();
+
+	//~ Begin of USubsystem
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	//~ End of USubsystem
+
+	/* Rebuilds all of the Ids from the registered DataTables. */
+	void Rebuild();
+
+	/* Returns the Id of the ItemDefinition referenced by the Handle, or InvalidId if it is not registered. */
+	uint32 GetItemDefinitionId(const FDataTableRowHandle& Handle);
+
+	/* Returns the Id of the AffixDefinition referenced by the Handle, or InvalidId if it is not registered. */
+	uint32 GetAffixDefinitionId(const FDataTableRowHandle& Handle);
+
+	/* Returns the Id of the SocketDefinition with the given SocketDefinitionHandle, or InvalidId if it is not registered. */
+	uint32 GetSocketDefinitionId(const FGuid& SocketDefinitionHandle);
+
+	/* Returns the ItemDefinitionEntry registered with the Id and its Handle. */
+	const FItemDefinitionEntry* FindItemDefinition(uint32 Id, FDataTableRowHandle& OutHandle);
+
+	/* Returns the AffixDefinitionEntry registered with the Id and its Handle. */
+	const FAffixDefinitionEntry* FindAffixDefinition(uint32 Id, FDataTableRowHandle& OutHandle);
+
+	/* Returns the SocketDefinition registered with the Id. */
+	const FItemSocketDefinition* FindSocketDefinition(uint32 Id);
+
+	/* Returns a checksum of every registered definition, processes that exchange Ids must have the same checksum. */
+	uint32 GetChecksum() const { return Checksum; }
+
+	/**
+	 * Net serializes a handle to an ItemDefinition. Writes the registered Id when possible, otherwise the DataTable and RowName.
+	 * When loading, OutItemDefinition is set if the handle was resolved through the Registry.
+	 */
+	static void NetSerializeItemDefinitionHandle(FArchive& Ar, FDataTableRowHandle& Handle, const TInstancedStruct<FItemDefinition>*& OutItemDefinition);
+
+	/**
+	 * Net serializes a handle to an AffixDefinition. Writes the registered Id when possible, otherwise the DataTable and RowName.
+	 * When loading, OutAffixDefinition is set if the handle was resolved through the Registry.
+	 */
+	static void NetSerializeAffixDefinitionHandle(FArchive& Ar, FDataTableRowHandle& Handle, const TInstancedStruct<FAffixDefinition>*& OutAffixDefinition);
+
+	/**
+	 * Net serializes the SocketDefinitionHandle of a SocketInstance. Writes the registered Id when possible, otherwise the raw handle.
+	 * When loading a registered Id, the handle is remapped to the local SocketDefinition so it can be matched against the local SocketSettings.
+	 */
+	static void NetSerializeSocketDefinitionHandle(FArchive& Ar, FGuid& SocketDefinitionHandle);
+
+private:
+
+	struct FItemDefinitionRecord
+	{
+		FDataTableRowHandle Handle;
+		const FItemDefinitionEntry* Entry = nullptr;
+	};
+
+	struct FAffixDefinitionRecord
+	{
+		FDataTableRowHandle Handle;
+		const FAffixDefinitionEntry* Entry = nullptr;
+	};
+
+	struct FSocketDefinitionRecord
+	{
+		TSubclassOf<UItemSocketSettings> SocketSettings;
+		int32 SocketDefinitionIndex = INDEX_NONE;
+	};
+
+	using FDefinitionKey = TPair<const UDataTable*, FName>;
+
+	/* All of the DataTables that have been registered, held so that our cached rows stay alive. */
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UDataTable>> RegisteredTables;
+
+	/* Registered definitions, the Id of each is its index + 1. */
+	TArray<FItemDefinitionRecord> ItemDefinitions;
+	TArray<FAffixDefinitionRecord> AffixDefinitions;
+	TArray<FSocketDefinitionRecord> SocketDefinitions;
+
+	TMap<FDefinitionKey, uint32> ItemDefinitionIds;
+	TMap<FDefinitionKey, uint32> AffixDefinitionIds;
+	TMap<FGuid, uint32> SocketDefinitionIds;
+
+	uint32 Checksum = 0;
+
+	/* The network version override that was bound before ours, our Checksum is combined with its result. */
+	FGetLocalNetworkVersionOverride PreviousNetworkVersionOverride;
+
+	/* Returns the local network version combined with our Checksum. */
+	uint32 GetLocalNetworkVersion() const;
+
+	void OnAssetRegistryFilesLoaded();
+
+	/* Collects every DataTable that should be registered for the given RowStruct, sorted by path. */
+	void GatherDefinitionTables(const TArray<TSoftObjectPtr<UDataTable>>& ConfiguredTables, const UScriptStruct* RowStruct, bool bAutoDiscover, TArray<UDataTable*>& OutTables) const;
+
+	/* Registers all of the SocketDefinitions on the SocketSettings of the ItemDefinitions we registered. */
+	void RegisterSocketDefinitions();
+
+#if WITH_EDITOR
+	void OnRegisteredTableChanged();
+#endif
+
+};
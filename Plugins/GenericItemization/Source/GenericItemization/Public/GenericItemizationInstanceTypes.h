@@ -10,8 +10,16 @@
 #include "GenericItemizationTableTypes.h"
 #include "ItemManagement/ItemSocketSettings.h"
 #include "StructView.h"
+#include "UObject/ObjectKey.h"
 #include "GenericItemizationInstanceTypes.generated.h"
 
+namespace UE::Net
+{
+    struct FItemInstanceNetSerializer;
+}
+
+class UNetConnection;
+
 /************************************************************************/
 /* Affixes
 /************************************************************************/
@@ -33,8 +41,12 @@ public:
     bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
 
     const TInstancedStruct<FAffixDefinition>& GetAffixDefinition() const { return AffixDefinition; }
+    const FDataTableRowHandle& GetAffixDefinitionHandle() const { return AffixDefinitionHandle; }
     void SetAffixDefinition(const FDataTableRowHandle& Handle);
 
+    /* Sets the AffixDefinition from one that has already been resolved, such as through the Definition Registry. */
+    void SetAffixDefinition(const FDataTableRowHandle& Handle, const TInstancedStruct<FAffixDefinition>& InAffixDefinition);
+
 protected:
 
     /* The static data that describes this Affix. */
@@ -56,6 +68,38 @@ struct TStructOpsTypeTraits<FAffixInstance> : public TStructOpsTypeTraitsBase2<F
     };
 };
 
+/**
+ * The sum of every Affix Modifier of a single ModType, across the Affixes of one or more ItemInstances.
+ */
+USTRUCT(BlueprintType)
+struct GENERICITEMIZATION_API FAffixModifierAggregate
+{
+    GENERATED_BODY()
+
+public:
+
+    /* The sum of the ModMinimum of the Modifiers. */
+    UPROPERTY(BlueprintReadOnly)
+    int32 ModMinimum = 0;
+
+    /* The sum of the ModMaximum of the Modifiers. */
+    UPROPERTY(BlueprintReadOnly)
+    int32 ModMaximum = 0;
+
+    /* How many Modifiers were summed. */
+    UPROPERTY(BlueprintReadOnly)
+    int32 NumModifiers = 0;
+
+    /* Adds, or subtracts if Sign is negative, the Other aggregate onto this one. */
+    void Accumulate(const FAffixModifierAggregate& Other, int32 Sign = 1)
+    {
+        ModMinimum += Sign * Other.ModMinimum;
+        ModMaximum += Sign * Other.ModMaximum;
+        NumModifiers += Sign * Other.NumModifiers;
+    }
+
+};
+
 /************************************************************************/
 /* Items
 /************************************************************************/
@@ -99,6 +143,7 @@ public:
 
     friend struct FSetSocketInstanceSocketDefinition;
     friend class UItemInventoryComponent;
+    friend struct UE::Net::FItemInstanceNetSerializer;
 
     FItemSocketInstance();
 
@@ -114,6 +159,8 @@ public:
     UPROPERTY()
     FGuid SocketDefinitionHandle;
 
+    bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+
     const TInstancedStruct<FItemSocketDefinition>& GetSocketDefinition() const { return SocketDefinition; }
     const FConstStructView GetSocketedItem() const;
 
@@ -129,6 +176,49 @@ protected:
 
 };
 
+template<>
+struct TStructOpsTypeTraits<FItemSocketInstance> : public TStructOpsTypeTraitsBase2<FItemSocketInstance>
+{
+    enum
+    {
+        WithNetSerializer = true,
+    };
+};
+
+/**
+ * Identifies the individually replicated fields of an FItemInstance, so that a change only needs to replicate the fields it touched.
+ */
+enum class EItemInstanceFields : uint16
+{
+    None            = 0,
+    ItemId          = 1 << 0,
+    ItemSeed        = 1 << 1,
+    ItemStream      = 1 << 2,
+    ItemLevel       = 1 << 3,
+    AffixLevel      = 1 << 4,
+    QualityType     = 1 << 5,
+    ItemDefinition  = 1 << 6,
+    Affixes         = 1 << 7,
+    StackCount      = 1 << 8,
+    Sockets         = 1 << 9,
+
+    All             = (1 << 10) - 1
+};
+ENUM_CLASS_FLAGS(EItemInstanceFields);
+
+/* The number of bits needed to replicate a set of EItemInstanceFields. */
+static constexpr uint32 ItemInstanceFieldsNumBits = 10;
+
+/* The index within Sockets of each SocketInstance of an FItemInstance, by its SocketId. A copy starts empty and is rebuilt on first use, so copying an ItemInstance does not copy its index. */
+struct FItemSocketIdToIndex : public TMap<FGuid, int32>
+{
+    FItemSocketIdToIndex() = default;
+    FItemSocketIdToIndex(const FItemSocketIdToIndex&) : TMap<FGuid, int32>() {}
+    FItemSocketIdToIndex(FItemSocketIdToIndex&&) = default;
+    FItemSocketIdToIndex& operator=(const FItemSocketIdToIndex&) { Reset(); return *this; }
+    FItemSocketIdToIndex& operator=(FItemSocketIdToIndex&&) = default;
+};
+
 /**
  * An actual instance of an Item that was generated.
  */
@@ -183,13 +273,26 @@ public:
 
     bool HasAnyAffixOfType(const FGameplayTag& AffixType) const;
 
+    /* Returns true if this Item has one of the QualityTypes and its ItemDefinition has one of the ItemTypes. Either matches anything if it is empty. */
+    bool MatchesTypes(const FGameplayTagContainer& ItemTypes, const FGameplayTagContainer& QualityTypes) const;
+
     bool IsValid() const;
 
     bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
 
+    /* Net serializes only the given Fields of this ItemInstance. NetSerialize is the same as serializing all of them. */
+    bool NetSerializeFields(FArchive& Ar, class UPackageMap* Map, EItemInstanceFields Fields, bool& bOutSuccess);
+
+    /* Finds the Fields dirtied by a change to the named property. Returns false for properties that cannot be replicated individually, such as those on derived types. */
+    static bool GetFieldsForProperty(const FName& PropertyName, EItemInstanceFields& OutFields);
+
     const TInstancedStruct<FItemDefinition>& GetItemDefinition() const { return ItemDefinition; }
+    const FDataTableRowHandle& GetItemDefinitionHandle() const { return ItemDefinitionHandle; }
     void SetItemDefinition(const FDataTableRowHandle& Handle);
 
+    /* Sets the ItemDefinition from one that has already been resolved, such as through the Definition Registry. */
+    void SetItemDefinition(const FDataTableRowHandle& Handle, const TInstancedStruct<FItemDefinition>& InItemDefinition);
+
     /* Adds a new SocketInstance to this ItemInstance. */
     void AddSocket(TInstancedStruct<FItemSocketInstance>& NewSocket);
 
@@ -199,6 +302,13 @@ public:
     /* Returns true if this ItemInstance has a SocketInstance with the given SocketId .*/
     bool HasSocket(const FGuid SocketId) const;
 
+    /* Returns the index within Sockets of the SocketInstance with the given SocketId, INDEX_NONE if this ItemInstance doesn't have it. */
+    int32 FindSocketIndex(const FGuid& SocketId) const;
+
+    /* Returns the SocketInstance with the given SocketId, nullptr if this ItemInstance doesn't have it. */
+    const FItemSocketInstance* FindSocket(const FGuid& SocketId) const;
+    FItemSocketInstance* FindMutableSocket(const FGuid& SocketId);
+
 protected:
 
     /* The static data that describes this Item. */
@@ -209,6 +319,18 @@ protected:
     UPROPERTY()
     FDataTableRowHandle ItemDefinitionHandle;
 
+    void NetSerializeAffixes(FArchive& Ar, class UPackageMap* Map);
+    void NetSerializeSockets(FArchive& Ar, class UPackageMap* Map);
+
+    /* 
+     * The index within Sockets of each SocketInstance, by its SocketId.
+     * Sockets can be changed directly, so entries are checked against Sockets when used and the map is rebuilt when one is found to be stale or it holds a different number of Sockets.
+     */
+    mutable FItemSocketIdToIndex SocketIdToIndex;
+
+    /* Rebuilds SocketIdToIndex from Sockets. */
+    void RebuildSocketIndex() const;
+
 };
 
 template<>
@@ -266,6 +388,22 @@ public:
 
 };
 
+/**
+ * Identifies the individually replicated members of an FFastItemInstance.
+ */
+enum class EFastItemInstanceFields : uint8
+{
+    None            = 0,
+
+    /* The entire ItemInstance including its type, used when a change could not be narrowed down to EItemInstanceFields. */
+    ItemInstance    = 1 << 0,
+    UserContextData = 1 << 1,
+    RecentChanges   = 1 << 2,
+
+    All             = ItemInstance | UserContextData | RecentChanges
+};
+ENUM_CLASS_FLAGS(EFastItemInstanceFields);
+
 /**
  * FastArraySerializerItem wrapper for an ItemInstance.
  * 
@@ -285,6 +423,7 @@ public:
     friend class UItemInventoryComponent;
 
     void Initialize(const FInstancedStruct& InItemInstance, const FInstancedStruct& InUserContextData);
+    void Initialize(FInstancedStruct&& InItemInstance, FInstancedStruct&& InUserContextData);
 
     //~ Begin of FFastArraySerializerItem
     void PostReplicatedAdd(const struct FFastItemInstancesContainer& InArray);
@@ -292,6 +431,12 @@ public:
     void PreReplicatedRemove(const struct FFastItemInstancesContainer& InArray);
     //~ End of FFastArraySerializerItem
 
+    /* Only writes the fields the receiving Connection has not yet been sent, see DirtyFieldsHistory. */
+    bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+
+    /* Releases the properties resolved for every ItemInstance ScriptStruct, as a reload may have changed them. */
+    static void ResetPropertyCaches();
+
 private:
 
     /* The actual ItemInstance we are replicating. */
@@ -302,20 +447,143 @@ private:
     UPROPERTY(BlueprintReadOnly, meta = (AllowPrivateAccess))
     FInstancedStruct UserContextData;
 
-    /* List of all recent changes made to the ItemInstance. */
+    /**
+     * Ring buffer of the most recent changes made to the ItemInstance, NumRecentChanges of them starting at RecentChangesHead, use GetRecentChange to read them oldest first.
+     * Changes every Connection has acknowledged are trimmed as new ones are added. MaxRecentChanges is only a hard cap, once it is reached the oldest Change is
+     * overwritten and Clients that had not received it yet are resynchronized with a full diff instead.
+     */
     UPROPERTY()
     TArray<FItemInstanceChange> RecentChangesBuffer;
 
+    /* Index within the RecentChangesBuffer of the oldest Change. */
+    UPROPERTY()
+    int32 RecentChangesHead = 0;
+
+    /* The number of Changes held by the RecentChangesBuffer, the rest of its entries are unused. */
+    UPROPERTY()
+    int32 NumRecentChanges = 0;
+
     /* Id of the current ChangeList. */
     UPROPERTY()
     int32 RecentChangesId = 0;
 
-    /* A copy of the ItemInstance which we use as a lookup for the previous values of changed properties that come in from the RecentChangesBuffer. */
-    FInstancedStruct PreReplicatedChangeItemInstance;
-
     /* Id of the ChangeList we have executed up to. */
     int32 PreviousChangesId = 0;
 
+    /* A copy of the value of a single property of the ItemInstance from before it was changed. */
+    struct FPropertySnapshot
+    {
+        FPropertySnapshot(const FProperty* InProperty, int32 InContainerOffset, const void* InValue);
+        ~FPropertySnapshot();
+
+        UE_NONCOPYABLE(FPropertySnapshot);
+
+        const FProperty* Property = nullptr;
+
+        /* Offset of the struct that contains the Property from the start of the ItemInstance, non zero for properties of nested structs. */
+        int32 ContainerOffset = 0;
+
+        void* Value = nullptr;
+    };
+
+    /**
+     * Snapshots of the properties named by the Changes that have not been diffed yet, which we use as a lookup for their previous values.
+     * Snapshots are never modified once taken, so copies of this FFastItemInstance share them.
+     */
+    TArray<TSharedRef<const FPropertySnapshot>, TInlineAllocator<2>> PropertySnapshots;
+
+    /* The ScriptStruct of the ItemInstance the PropertySnapshots were taken from. */
+    const UScriptStruct* PropertySnapshotsStruct = nullptr;
+
+    /* Takes a snapshot of the property with the given name, unless we already have one. */
+    void CapturePropertySnapshot(const FName& PropertyName);
+
+    /* Takes a snapshot of every property of the ItemInstance, used when we can't tell which properties are about to change. */
+    void CaptureAllPropertySnapshots();
+
+    /* Returns the snapshot of the property, if we have one. */
+    const FPropertySnapshot* FindPropertySnapshot(const FProperty* Property) const;
+
+    /* Releases all of the PropertySnapshots, called once they have been diffed. */
+    void ResetPropertySnapshots();
+
+    /* True if some of the Changes after PreviousChangesId are no longer in the RecentChangesBuffer. */
+    bool HasMissedRecentChanges() const;
+
+    /* Returns the number of Changes in the RecentChangesBuffer. */
+    int32 GetNumRecentChanges() const;
+
+    /* Returns the Change at the Index, counting from the oldest Change in the RecentChangesBuffer. */
+    const FItemInstanceChange& GetRecentChange(int32 Index) const { return RecentChangesBuffer[GetRecentChangeBufferIndex(Index)]; }
+
+    /* Returns the index within the RecentChangesBuffer of the Change at the Index, counting from the oldest Change. */
+    int32 GetRecentChangeBufferIndex(int32 Index) const;
+
+    struct FConnectionChangesId
+    {
+        TObjectKey<UNetConnection> Connection;
+        int32 RecentChangesId = 0;
+    };
+
+    /**
+     * The RecentChangesId each Connection was last written against, which it has acknowledged having. Changes up to the lowest of these are no
+     * longer needed by anyone. Only maintained on the Server by the legacy replication path, Iris relies on MaxRecentChanges alone.
+     */
+    TArray<FConnectionChangesId, TInlineAllocator<2>> ConnectionChangesIds;
+
+    /* Records the RecentChangesId the Connection currently being written to has acknowledged. */
+    void RecordConnectionChangesId(int32 ConnectionChangesId);
+
+    /* Drops the Changes every Connection has acknowledged from the front of the RecentChangesBuffer. */
+    void TrimAcknowledgedRecentChanges();
+
+    struct FDirtyFields
+    {
+        int32 ReplicationKey = INDEX_NONE;
+        int32 RecentChangesId = 0;
+        EFastItemInstanceFields Fields = EFastItemInstanceFields::None;
+        EItemInstanceFields ItemFields = EItemInstanceFields::None;
+    };
+
+    /* The maximum number of entries kept in the RecentChangesBuffer. */
+    static constexpr int32 MaxRecentChanges = 32;
+
+    /* The maximum number of entries kept in the DirtyFieldsHistory. */
+    static constexpr int32 MaxDirtyFieldsHistory = 16;
+
+    /* The fields that were dirtied by each of our recent ReplicationKeys, oldest first. Only maintained on the Server. */
+    TArray<FDirtyFields, TInlineAllocator<4>> DirtyFieldsHistory;
+
+    /* The ReplicationKey before the oldest entry in the DirtyFieldsHistory. Connections that were last sent an older key are sent every field. */
+    int32 DirtyFieldsHistoryFloor = INDEX_NONE;
+
+    /* The RecentChangesId as of the DirtyFieldsHistoryFloor. */
+    int32 DirtyFieldsHistoryFloorChangesId = 0;
+
+    /* Pushes a new Change onto the RecentChangesBuffer, after trimming the acknowledged Changes. Overwrites the oldest Change if it still holds MaxRecentChanges. */
+    void AddRecentChange(FItemInstanceChange&& Change);
+
+    /* Finds what the RecentChangesId was as of the ReplicationKey. Returns false if that is no longer known. */
+    bool GetRecentChangesIdAt(int32 InReplicationKey, int32& OutRecentChangesId) const;
+
+    /* Records the fields that were dirtied by our current ReplicationKey. */
+    void RecordDirtyFields(EFastItemInstanceFields Fields, EItemInstanceFields ItemFields);
+
+    /* Finds the fields that were dirtied after BaseReplicationKey. Returns false if they are no longer known and every field must be sent. */
+    bool GetDirtyFieldsSince(int32 BaseReplicationKey, EFastItemInstanceFields& OutFields, EItemInstanceFields& OutItemFields) const;
+
+};
+
+// Iris does not use NetSerialize for FastArray items, it tracks changes to each member of the FFastItemInstance itself. This also lets
+// the ItemInstance reach its own Iris NetSerializer rather than going through the legacy bridge. Whether Iris is used is only decided
+// at runtime, so the trait is always declared and FastItemInstance is listed in SupportsStructNetSerializerList for Iris.
+template<>
+struct TStructOpsTypeTraits<FFastItemInstance> : public TStructOpsTypeTraitsBase2<FFastItemInstance>
+{
+    enum
+    {
+        WithNetSerializer = true,
+    };
 };
 
 /**
@@ -345,14 +613,17 @@ public:
     void PostReplicatedAdd(const TArrayView<int32>& AddedIndices, int32 FinalSize);
     void PostReplicatedChange(const TArrayView<int32>& ChangedIndices, int32 FinalSize);
     void PreReplicatedRemove(const TArrayView<int32>& RemovedIndices, int32 FinalSize);
+    void PostReplicatedReceive(const FFastArraySerializer::FPostReplicatedReceiveParameters& Parameters);
     //~ End of FFastArraySerializer
 
-    bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParams)
-    {
-        // @TODO: Introduce per connection functionality. We will want to specify that only replication occurs to the owner or all.
-        // An Inventory may only want to display its contents to a particular connection.
-        return FFastArraySerializer::FastArrayDeltaSerialize<FFastItemInstance, FFastItemInstancesContainer>(ItemInstances, DeltaParams, *this);
-    }
+    /* Only writes to Connections that the Owner's ReplicationPolicy allows to receive the ItemInstances. */
+    bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParams);
+
+    /* Returns the base state of the Connection that is currently being written to by NetDeltaSerialize on this thread, if any. */
+    static const FNetFastArrayBaseState* GetActiveWriteBaseState();
+
+    /* Returns the Connection that is currently being written to by NetDeltaSerialize on this thread, if any. */
+    static const UNetConnection* GetActiveWriteConnection();
 
     bool HasAuthority() const
     {
@@ -362,12 +633,27 @@ public:
     typedef TArray<FFastItemInstance>::TConstIterator TConstIterator;
     TConstIterator CreateConstIterator() const { return ItemInstances.CreateConstIterator(); }
 
-    /* Must be called in order to correctly initialize the container! */
-    void Register(UItemInventoryComponent* InOwner);
+    /* Must be called in order to correctly initialize the container! Containers of a tab of the Owner pass its index as InTab. */
+    void Register(UItemInventoryComponent* InOwner, int32 InTab = INDEX_NONE);
+
+    /* Returns true if this container holds a tab of the Owner rather than its own ItemInstances. */
+    bool IsTab() const { return Tab != INDEX_NONE; }
 
     /* Adds an Item to the container. */
     void AddItemInstance(FInstancedStruct& ItemInstance, FInstancedStruct& UserContextData);
 
+    /* Adds an Item to the container, moving it and its UserContextData in rather than copying them. */
+    void AddItemInstance(FInstancedStruct&& ItemInstance, FInstancedStruct&& UserContextData);
+
+    /* Adds an Item to the container, moving it and its UserContextData in rather than copying them. See MoveToInstancedStruct. */
+    void AddItemInstance(TInstancedStruct<FItemInstance>&& ItemInstance, FInstancedStruct&& UserContextData);
+
+    /**
+     * Moves the ItemInstance into an FInstancedStruct, which is how the container holds its ItemInstances, leaving it Reset.
+     * Only the members of an FItemInstance can be moved, derived ItemInstance types are only known through reflection and are copied instead.
+     */
+    static FInstancedStruct MoveToInstancedStruct(TInstancedStruct<FItemInstance>&& ItemInstance);
+
     /* Creates a scope to make mutable changes to an ItemInstance. This should always be called if you intend to mutate an ItemInstance! */
     template<typename InstanceType>
     bool ModifyItemInstance(
@@ -387,6 +673,9 @@ public:
     /* Removes an Item from the container. */
     bool RemoveItemInstance(const FGuid& Item);
 
+    /* Removes an Item from the container and moves it out into OutItemInstance, as a logical transfer of ownership to the caller. */
+    bool RemoveItemInstance(const FGuid& Item, FInstancedStruct& OutItemInstance);
+
     /* Returns a copy of all of the ItemInstances within the container. */
     TArray<FInstancedStruct> GetItemInstances() const;
 
@@ -396,6 +685,21 @@ public:
     /* Returns the number of ItemInstances in the container. */
     int32 GetNum() const;
 
+    /* Reserves room for Number ItemInstances in total, so that adding many of them at once does not grow the container and its indexes repeatedly. */
+    void Reserve(int32 Number);
+
+    /* Returns the Ids of the ItemInstances with the ItemDefinition, nullptr if there are none. */
+    const TSet<FGuid>* FindItemInstancesWithDefinition(const FDataTableRowHandle& ItemDefinition) const;
+
+    /* Returns the Ids of the ItemInstances whose ItemDefinition has the ItemType or any ItemType beneath it, nullptr if there are none. */
+    const TSet<FGuid>* FindItemInstancesOfType(const FGameplayTag& ItemType) const;
+
+    /* Returns the Ids of the ItemInstances with the QualityType or any QualityType beneath it, nullptr if there are none. */
+    const TSet<FGuid>* FindItemInstancesOfQuality(const FGameplayTag& QualityType) const;
+
+    /* Returns the Ids of the ItemInstances with the stack key that still have room in their stack, nullptr if there are none. See UItemStackSettings::ComputeStackKey. */
+    const TSet<FGuid>* FindOpenStacksWithStackKey(uint32 StackKey) const;
+
 private:
 
 	UPROPERTY()
@@ -406,12 +710,88 @@ private:
 
     bool bOwnerIsNetAuthority;
 
+    /* The index of the Owner's tab this container holds, INDEX_NONE for the Owner's own ItemInstances. The Owner is not notified of each change to the ItemInstances of a tab. */
+    int32 Tab = INDEX_NONE;
+
+    /* True while the Owner has a Transaction open, dirtying is then deferred until FlushPendingDirty. */
+    bool bDeferMarkDirty = false;
+
+    /* True if MarkArrayDirty was deferred. */
+    bool bPendingMarkArrayDirty = false;
+
+    /* The fields of each ItemInstance that were dirtied while bDeferMarkDirty was set. */
+    TMap<FGuid, TPair<EFastItemInstanceFields, EItemInstanceFields>> PendingDirtyItems;
+
+    /* Marks everything that was dirtied while bDeferMarkDirty was set, each ItemInstance only once. */
+    void FlushPendingDirty();
+
+    /* Marks the array dirty, or defers it if the Owner has a Transaction open. */
+    void MarkItemInstancesArrayDirty();
+
     /* Called when an ItemInstance was changed. Calls, DiffItemInstanceChanges and updates any cached state for the changed ItemInstance. */
-    void OnItemInstanceChanged(FFastItemInstance& ChangedItemInstance) const;
+    void OnItemInstanceChanged(FFastItemInstance& ChangedItemInstance);
 
     /* Diffs the RecentChangesBuffer for the ItemInstance and emits any actual changes that took place to the ItemInventoryComponent. */
     void DiffItemInstanceChanges(const FFastItemInstance& ChangedItemInstance) const;
 
+    /* Used when Changes are missing from the RecentChangesBuffer. Emits every property that differs from its PropertySnapshot, with an empty ChangeDescriptor. */
+    void DiffAllItemInstanceProperties(const FFastItemInstance& ChangedItemInstance) const;
+
+    /* Marks the ItemInstance dirty and records which of its fields were changed, so only those are replicated. Deferred if the Owner has a Transaction open. */
+    void MarkItemFieldsDirty(FFastItemInstance& ItemInstance, EFastItemInstanceFields Fields, EItemInstanceFields ItemFields);
+
+    /* The index within ItemInstances of each ItemInstance, by its ItemId. */
+    mutable TMap<FGuid, int32> ItemIdToIndex;
+
+    /* True if ItemIdToIndex must be rebuilt before it is next used. Set when ItemInstances are removed, as the indices after them have moved. */
+    mutable bool bItemIdToIndexDirty = false;
+
+    /* Returns the index within ItemInstances of the ItemInstance, INDEX_NONE if it does not exist. */
+    int32 FindItemInstanceIndex(const FGuid& Item) const;
+
+    /* Returns the ItemInstance for making mutable changes, if it exists. */
+    FFastItemInstance* FindItemInstance(const FGuid& Item);
+
+    /* Rebuilds ItemIdToIndex from ItemInstances. */
+    void RebuildItemIdToIndex() const;
+
+    typedef TPair<TObjectKey<const UDataTable>, FName> FItemDefinitionKey;
+
+    /* The keys an ItemInstance is currently indexed under by the secondary indexes. */
+    struct FItemInstanceIndexKeys
+    {
+        FItemDefinitionKey ItemDefinition;
+
+        /* The ItemType, which is indexed under itself and every one of its parents so that querying a parent ItemType finds its children too. */
+        FGameplayTag ItemType;
+
+        /* The QualityType, which is indexed under itself and every one of its parents. */
+        FGameplayTag QualityType;
+
+        /* The stack key, only set while the ItemInstance is stackable and still has room in its stack. */
+        TOptional<uint32> OpenStackKey;
+
+        bool operator==(const FItemInstanceIndexKeys& Other) const
+        {
+            return ItemDefinition == Other.ItemDefinition && ItemType == Other.ItemType && QualityType == Other.QualityType && OpenStackKey == Other.OpenStackKey;
+        }
+    };
+
+    /* Secondary indexes of the Ids of the ItemInstances, maintained on both the Server and Clients. */
+    TMap<FItemDefinitionKey, TSet<FGuid>> ItemsByDefinition;
+    TMap<FGameplayTag, TSet<FGuid>> ItemsByItemType;
+    TMap<FGameplayTag, TSet<FGuid>> ItemsByQualityType;
+    TMap<uint32, TSet<FGuid>> OpenStacksByStackKey;
+
+    /* The keys each ItemInstance is indexed under, so that it can be removed from the secondary indexes. */
+    TMap<FGuid, FItemInstanceIndexKeys> IndexedItemKeys;
+
+    /* Adds the ItemInstance to the secondary indexes, or updates them if its keys have changed. */
+    void IndexItemInstance(const FFastItemInstance& FastItemInstance);
+
+    /* Removes the ItemInstance from the secondary indexes. */
+    void UnindexItemInstance(const FGuid& ItemId);
+
     /**
      * DO NOT USE DIRECTLY
      * STL-like iterators to enable range-based for loop support.
@@ -435,28 +815,22 @@ bool FFastItemInstancesContainer::ModifyItemInstance(const FGuid& Item, const TF
     static_assert(std::is_same_v<InstanceType, FItemInstance> ||
         TIsDerivedFrom<InstanceType, FItemInstance>::IsDerived, "Changes can only be made on FItemInstance types.");
 
-    for (FFastItemInstance& ItemInstance : ItemInstances)
+    FFastItemInstance* ItemInstance = FindItemInstance(Item);
+    if (!ItemInstance)
     {
-        const FItemInstance* ItemInstancePtr = ItemInstance.ItemInstance.GetPtr<FItemInstance>();
-        if (ItemInstancePtr && ItemInstancePtr->ItemId == Item)
-        {
-            // Update our cached state.
-            ItemInstance.PreReplicatedChangeItemInstance.InitializeAs(ItemInstance.ItemInstance.GetScriptStruct(), ItemInstance.ItemInstance.GetMemory());
-
-            // Commit the changes to the actual ItemInstance being requested.
-            MakeChanges(ItemInstance.ItemInstance.GetMutablePtr<InstanceType>());
+        return false;
+    }
 
-            if (HasAuthority())
-            {
-                OnItemInstanceChanged(ItemInstance);
-                MarkItemDirty(ItemInstance);
-            }
+    // Commit the changes to the actual ItemInstance being requested.
+    MakeChanges(ItemInstance->ItemInstance.GetMutablePtr<InstanceType>());
 
-            return true;
-        }
+    if (HasAuthority())
+    {
+        OnItemInstanceChanged(*ItemInstance);
+        MarkItemFieldsDirty(*ItemInstance, EFastItemInstanceFields::ItemInstance, EItemInstanceFields::All);
     }
 
-    return false;
+    return true;
 }
 
 template<typename InstanceType>
@@ -465,40 +839,54 @@ bool FFastItemInstancesContainer::ModifyItemInstanceWithChangeDescriptor(const F
     static_assert(std::is_same_v<InstanceType, FItemInstance> ||
         TIsDerivedFrom<InstanceType, FItemInstance>::IsDerived, "Changes can only be made on FItemInstance types.");
 
-    for (FFastItemInstance& ItemInstance : ItemInstances)
+    FFastItemInstance* ItemInstance = FindItemInstance(Item);
+    if (!ItemInstance)
     {
-        const FItemInstance* ItemInstancePtr = ItemInstance.ItemInstance.GetPtr<FItemInstance>();
-        if (ItemInstancePtr && ItemInstancePtr->ItemId == Item)
+        return false;
+    }
+
+    // Snapshot only the properties this Change is going to modify.
+    for (const FName& PropertyName : PendingChangeProperties)
+    {
+        ItemInstance->CapturePropertySnapshot(PropertyName);
+    }
+
+    // This is a new Change, update the ID.
+    ItemInstance->RecentChangesId++;
+
+    // Push the change descriptor onto the ItemInstance.
+    // This is replicated to the Client so it can perform the same diff operation.
+    FItemInstanceChange NewChange;
+    NewChange.ChangeDescriptor = ChangeDescriptor;
+    NewChange.ChangedProperties.Append(PendingChangeProperties);
+    NewChange.ChangeId = ItemInstance->RecentChangesId;
+    ItemInstance->AddRecentChange(MoveTemp(NewChange));
+
+    // Commit the changes to the actual ItemInstance being requested.
+    // We then diff these against the PropertySnapshots.
+    MakeChanges(ItemInstance->ItemInstance.GetMutablePtr<InstanceType>());
+
+    if(HasAuthority())
+	{
+        OnItemInstanceChanged(*ItemInstance);
+
+        // Only the fields named by the change need to be replicated, unless we don't know how to replicate one of them individually.
+        EFastItemInstanceFields DirtyFields = EFastItemInstanceFields::RecentChanges;
+        EItemInstanceFields DirtyItemFields = EItemInstanceFields::None;
+        for (const FName& PropertyName : PendingChangeProperties)
         {
-            // Update our cached state.
-            ItemInstance.PreReplicatedChangeItemInstance.InitializeAs(ItemInstance.ItemInstance.GetScriptStruct(), ItemInstance.ItemInstance.GetMemory());
-
-            // This is a new Change, update the ID.
-            ItemInstance.RecentChangesId++;
-
-            // Push the change descriptor onto the ItemInstance.
-            // This is replicated to the Client so it can perform the same diff operation.
-            FItemInstanceChange NewChange;
-            NewChange.ChangeDescriptor = ChangeDescriptor;
-            NewChange.ChangedProperties.Append(PendingChangeProperties);
-            NewChange.ChangeId = ItemInstance.RecentChangesId;
-            ItemInstance.RecentChangesBuffer.Add(NewChange);
-
-            // Commit the changes to the actual ItemInstance being requested.
-            // We then diff these against the PreReplicatedChangeItemInstance.
-            MakeChanges(ItemInstance.ItemInstance.GetMutablePtr<InstanceType>());
-
-            if(HasAuthority())
-			{
-                OnItemInstanceChanged(ItemInstance);
-				MarkItemDirty(ItemInstance);
-			}
-
-            return true;
+            EItemInstanceFields PropertyFields = EItemInstanceFields::None;
+            if (!FItemInstance::GetFieldsForProperty(PropertyName, PropertyFields))
+            {
+                DirtyFields |= EFastItemInstanceFields::ItemInstance;
+            }
+            DirtyItemFields |= PropertyFields;
         }
-    }
 
-    return false;
+		MarkItemFieldsDirty(*ItemInstance, DirtyFields, DirtyItemFields);
+	}
+
+    return true;
 }
 
 template<>
@@ -508,4 +896,43 @@ struct TStructOpsTypeTraits<FFastItemInstancesContainer> : public TStructOpsType
     {
         WithNetDeltaSerializer = true
     };
-};
\ No newline at end of file
+};
+
+/**
+ * A lightweight public description of an ItemInstance, replicated in place of the ItemInstance to Connections that are not allowed to see its full contents.
+ */
+USTRUCT(BlueprintType)
+struct GENERICITEMIZATION_API FItemInventorySummaryEntry
+{
+    GENERATED_BODY()
+
+public:
+
+    /* The Unique Id of the Item. */
+    UPROPERTY(BlueprintReadOnly)
+    FGuid ItemId;
+
+    /* Handle to the ItemDefinition of the Item. */
+    UPROPERTY(BlueprintReadOnly)
+    FDataTableRowHandle ItemDefinitionHandle;
+
+    /* The Quality Type of the Item. */
+    UPROPERTY(BlueprintReadOnly, meta = (Categories = "Itemization.QualityType"))
+    FGameplayTag QualityType;
+
+    /* The number of stacks of the Item. */
+    UPROPERTY(BlueprintReadOnly)
+    int32 StackCount = 0;
+
+    bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+
+};
+
+template<>
+struct TStructOpsTypeTraits<FItemInventorySummaryEntry> : public TStructOpsTypeTraitsBase2<FItemInventorySummaryEntry>
+{
+    enum
+    {
+        WithNetSerializer = true,
+    };
+};
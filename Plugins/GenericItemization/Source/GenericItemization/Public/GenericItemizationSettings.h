@@ -0,0 +1,109 @@
+// Copyright Fissure Entertainment, Pty Ltd. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DeveloperSettings.h"
+#include "Engine/DataTable.h"
+#include "GenericItemizationSettings.generated.h"
+
+class AItemDrop;
+class AItemDropManager;
+
+/**
+ * Project wide settings for the Generic Itemization Plugin.
+ */
+UCLASS(Config = Game, DefaultConfig, meta = (DisplayName = "Generic Itemization"))
+class GENERICITEMIZATION_API UGenericItemizationSettings : public UDeveloperSettings
+{
+	GENERATED_BODY()
+
+public:
+
+	UGenericItemizationSettings();
+
+	/**
+	 * True if ItemInstances, AffixInstances and SocketInstances should replicate the compact Ids assigned by the Definition Registry instead of DataTable references and RowNames.
+	 * Definitions that are not registered will always fall back to replicating their DataTable and RowName.
+	 */
+	UPROPERTY(Config, EditAnywhere, Category = "Definition Registry")
+	bool bUseDefinitionRegistry = true;
+
+	/**
+	 * True if every DataTable in the Asset Registry whose RowStructure is exactly FItemDefinitionEntry or FAffixDefinitionEntry should be registered.
+	 * DataTables using a derived RowStructure must be added to the lists below.
+	 */
+	UPROPERTY(Config, EditAnywhere, Category = "Definition Registry")
+	bool bAutoDiscoverDefinitionTables = true;
+
+	/* DataTables containing ItemDefinitions that are always registered with the Definition Registry. */
+	UPROPERTY(Config, EditAnywhere, Category = "Definition Registry", meta = (RequiredAssetDataTags = "RowStructure=/Script/GenericItemization.ItemDefinitionEntry"))
+	TArray<TSoftObjectPtr<UDataTable>> ItemDefinitionTables;
+
+	/* DataTables containing AffixDefinitions that are always registered with the Definition Registry. */
+	UPROPERTY(Config, EditAnywhere, Category = "Definition Registry", meta = (RequiredAssetDataTags = "RowStructure=/Script/GenericItemization.AffixDefinitionEntry"))
+	TArray<TSoftObjectPtr<UDataTable>> AffixDefinitionTables;
+
+	/**
+	 * True if dropped Items should be owned by an AItemDropManager for their cell of the world, instead of each being its own replicated AItemDrop Actor.
+	 * Applies to UItemDropperComponent::DropItems.
+	 */
+	UPROPERTY(Config, EditAnywhere, Category = "Item Drop Managers")
+	bool bUseItemDropManagers = false;
+
+	/* The type of ItemDropManager that is spawned for each cell. */
+	UPROPERTY(Config, EditAnywhere, Category = "Item Drop Managers", meta = (EditCondition = "bUseItemDropManagers"))
+	TSoftClassPtr<AItemDropManager> ItemDropManagerClass;
+
+	/* The size of each cell of the world that has its own ItemDropManager. */
+	UPROPERTY(Config, EditAnywhere, Category = "Item Drop Managers", meta = (EditCondition = "bUseItemDropManagers", ClampMin = "100.0", ForceUnits = "cm"))
+	float ItemDropManagerCellSize = 5000.0f;
+
+	/* How far away a Client can be from the center of a cell and still receive the drops within it. */
+	UPROPERTY(Config, EditAnywhere, Category = "Item Drop Managers", meta = (EditCondition = "bUseItemDropManagers", ClampMin = "100.0", ForceUnits = "cm"))
+	float ItemDropManagerNetCullDistance = 10000.0f;
+
+	/* True if ItemDrops should be put into a pool of dormant Actors and reused, instead of being destroyed once they are taken. */
+	UPROPERTY(Config, EditAnywhere, Category = "Item Drop Pool")
+	bool bPoolItemDrops = false;
+
+	/* The most dormant ItemDrops of each class that are kept in the pool, any more are destroyed. */
+	UPROPERTY(Config, EditAnywhere, Category = "Item Drop Pool", meta = (EditCondition = "bPoolItemDrops", ClampMin = "0"))
+	int32 MaxPooledItemDropsPerClass = 128;
+
+	/* ItemDrops of these classes are spawned into the pool on the Server as the World begins play. */
+	UPROPERTY(Config, EditAnywhere, Category = "Item Drop Pool", meta = (EditCondition = "bPoolItemDrops"))
+	TMap<TSoftClassPtr<AItemDrop>, int32> PrewarmedItemDrops;
+
+	/* The size of each cell of the grid the UItemDropSpatialIndexSubsystem indexes ItemDrops within. Should be close to the radius of typical queries. */
+	UPROPERTY(Config, EditAnywhere, Category = "Item Drop Spatial Index", meta = (ClampMin = "10.0", ForceUnits = "cm"))
+	float ItemDropSpatialIndexCellSize = 1000.0f;
+
+	/**
+	 * True if the ItemDrops of UItemDropperComponent::DropItems should be queued and spawned over multiple frames by the UItemDropSpawnSubsystem.
+	 * DropItems then passes out no ItemDrops, bind to UItemDropperComponent::OnItemDropSpawnedDelegate instead.
+	 */
+	UPROPERTY(Config, EditAnywhere, Category = "Item Drop Spawning")
+	bool bScheduleItemDropSpawns = false;
+
+	/* How much time, in milliseconds, can be spent spawning queued ItemDrops each frame. At least one ItemDrop is always spawned. */
+	UPROPERTY(Config, EditAnywhere, Category = "Item Drop Spawning", meta = (EditCondition = "bScheduleItemDropSpawns", ClampMin = "0.0", ForceUnits = "ms"))
+	float ItemDropSpawnBudgetMs = 1.0f;
+
+	/* True if the ItemDrops of UItemDropperComponent::DropItems are scattered around the dropper even when their spawns are not scheduled. Scheduled spawns are always scattered. */
+	UPROPERTY(Config, EditAnywhere, Category = "Item Drop Spawning")
+	bool bScatterItemDrops = false;
+
+	/* How far apart ItemDrops that are dropped together are scattered from one another. */
+	UPROPERTY(Config, EditAnywhere, Category = "Item Drop Spawning", meta = (EditCondition = "bScheduleItemDropSpawns || bScatterItemDrops", ClampMin = "0.0", ForceUnits = "cm"))
+	float ItemDropScatterSpacing = 50.0f;
+
+	/* The size of each page of a newly created UItemStashStorage file. Existing files keep the page size they were created with. */
+	UPROPERTY(Config, EditAnywhere, Category = "Item Stash Storage", meta = (ClampMin = "1024", ForceUnits = "Bytes"))
+	int32 ItemStashPageSize = 16384;
+
+	/* The most ItemInstances that are written to each page of a UItemStashStorage. A page whose ItemInstances do not fit in ItemStashPageSize spans several consecutive pages of the file. */
+	UPROPERTY(Config, EditAnywhere, Category = "Item Stash Storage", meta = (ClampMin = "1"))
+	int32 ItemStashItemsPerPage = 64;
+
+};
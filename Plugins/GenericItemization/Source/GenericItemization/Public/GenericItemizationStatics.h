@@ -109,4 +109,19 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Generic Itemization")
 	static bool GetItemAffixes(const TInstancedStruct<FItemInstance>& Item, TArray<TInstancedStruct<FAffixInstance>>& OutAffixes, bool bIncludeSocketedItems = true);
 
+	/**
+	 * Sums the Modifiers of all of the AffixInstances for the passed in ItemInstance by their ModType, without copying any of the AffixInstances.
+	 * Socketed ItemInstances are included in the same way as GetItemAffixes.
+	 *
+	 * @param Item						The ItemInstance to sum the Modifiers of.
+	 * @param OutAggregates				The summed Modifiers, by their ModType.
+	 * @param bIncludeSocketedItems		Whether or not we will sum the Modifiers of Items socketed into this one.
+	 * @return							True if we found any Modifiers.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Generic Itemization")
+	static bool GetItemModifierAggregates(const TInstancedStruct<FItemInstance>& Item, TMap<FGameplayTag, FAffixModifierAggregate>& OutAggregates, bool bIncludeSocketedItems = true);
+
+	/* Adds the Modifiers of all of the AffixInstances for the ItemInstance onto OutAggregates by their ModType. */
+	static void AccumulateItemModifiers(const FItemInstance& ItemInstance, TMap<FGameplayTag, FAffixModifierAggregate>& OutAggregates, bool bIncludeSocketedItems = true);
+
 };
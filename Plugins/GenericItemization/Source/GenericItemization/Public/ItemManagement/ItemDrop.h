@@ -8,6 +8,8 @@
 #include "GenericItemizationInstanceTypes.h"
 #include "ItemDrop.generated.h"
 
+class AItemDropManager;
+
 /**
  * An Actor that is representing an actual FItemInstance that has been dropped and can be claimed by a UItemInventoryComponent.
  */
@@ -20,9 +22,14 @@ public:
 
 	friend class UItemDropperComponent;
 	friend class UItemInventoryComponent;
+	friend class AItemDropManager;
+	friend class UItemDropPoolSubsystem;
 	
 	AItemDrop();
 
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	/* Returns the ItemInstance this ItemDrop is representing. */
 	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Generic Itemization")
 	void GetItemInstance(TInstancedStruct<FItemInstance>& OutItemInstance) const;
@@ -39,14 +46,73 @@ public:
 	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Generic Itemization")
 	bool HasValidItemInstance() const;
 
+	/* Returns the ItemInstance this ItemDrop is representing without copying it, nullptr if there is none. */
+	const FItemInstance* GetItemInstancePtr() const { return ItemInstance.GetPtr(); }
+
 	/* Decides if the passed in Inventory can attempt to take this ItemDrop. */
 	UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = "Generic Itemization")
 	bool CanTakeItem(UItemInventoryComponent* InventoryComponent) const;
 
+	/* Returns the ItemDropManager and the Id of the drop, if this ItemDrop is only the local visual of a drop owned by an ItemDropManager. */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Generic Itemization")
+	AItemDropManager* GetDropManager(FGuid& OutDropId) const;
+
+	/* Returns true if this ItemDrop is dormant within the UItemDropPoolSubsystem, waiting to be reused. */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Generic Itemization")
+	bool IsPooled() const { return bIsPooled; }
+
+	/* Returns this ItemDrop to the UItemDropPoolSubsystem so that it can be reused, or destroys it if it cannot be pooled. */
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "Generic Itemization")
+	void ReleaseToPool();
+
 protected:
 
 	/* The ItemInstance this ItemDrop is representing. */
-	UPROPERTY(Replicated)
+	UPROPERTY(ReplicatedUsing = OnRep_ItemInstance)
 	TInstancedStruct<FItemInstance> ItemInstance;
 
+	/* True while this ItemDrop is dormant within the UItemDropPoolSubsystem. */
+	UPROPERTY(Transient)
+	bool bIsPooled = false;
+
+	/* The ItemDropManager that owns the drop this ItemDrop is visualizing, if any. */
+	UPROPERTY(Transient)
+	TWeakObjectPtr<AItemDropManager> DropManager;
+
+	/* The Id of the drop within the DropManager. */
+	UPROPERTY(Transient)
+	FGuid DropId;
+
+	/* Replaces the ItemInstance this ItemDrop is representing, marking it dirty so that it replicates. */
+	void SetItemInstance(const TInstancedStruct<FItemInstance>& InItemInstance);
+	void SetItemInstance(TInstancedStruct<FItemInstance>&& InItemInstance);
+	void SetItemInstance(const FInstancedStruct& InItemInstance);
+
+	/* Resets the ItemInstance this ItemDrop is representing, marking it dirty so that it replicates. */
+	void ResetItemInstance();
+
+	/* Reactivates this ItemDrop as it is taken out of the pool, making it replicate if it was acquired from the pool of replicated ItemDrops. */
+	void ActivateFromPool(const FTransform& Transform, AActor* NewOwner, bool bReplicated);
+
+	/* Resets and hides this ItemDrop as it is put into the pool, making it dormant if it replicates. */
+	void DeactivateToPool();
+
+	UFUNCTION()
+	void OnRep_ItemInstance();
+
+	/* Keeps the UItemDropSpatialIndexSubsystem up to date as this ItemDrop moves. */
+	void OnRootComponentTransformUpdated(USceneComponent* UpdatedComponent, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport);
+
+	/* Called when the ItemInstance this ItemDrop is representing changed. */
+	UFUNCTION(BlueprintNativeEvent, meta = (DisplayName = "On Item Instance Changed"))
+	void K2_OnItemInstanceChanged();
+
+	/* Called when this ItemDrop is taken out of the pool to represent a new ItemInstance. */
+	UFUNCTION(BlueprintNativeEvent, meta = (DisplayName = "On Acquired From Pool"))
+	void K2_OnAcquiredFromPool();
+
+	/* Called when this ItemDrop is put into the pool, before it is hidden. */
+	UFUNCTION(BlueprintNativeEvent, meta = (DisplayName = "On Released To Pool"))
+	void K2_OnReleasedToPool();
+
 };
@@ -0,0 +1,195 @@
+// Copyright Fissure Entertainment, Pty Ltd. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "InstancedStruct.h"
+#include "Engine/NetSerialization.h"
+#include "Net/Serialization/FastArraySerializer.h"
+#include "GenericItemizationInstanceTypes.h"
+#include "ItemDropManager.generated.h"
+
+class AItemDrop;
+class AItemDropManager;
+class UItemInventoryComponent;
+
+/**
+ * A single ItemInstance that has been dropped into the world and is owned by an AItemDropManager.
+ */
+USTRUCT(BlueprintType)
+struct GENERICITEMIZATION_API FItemDropRecord : public FFastArraySerializerItem
+{
+	GENERATED_BODY()
+
+public:
+
+	/* Unique Id of this drop within its ItemDropManager. */
+	UPROPERTY(BlueprintReadOnly, Category = "Generic Itemization")
+	FGuid DropId;
+
+	/* Where the drop is in the world. */
+	UPROPERTY(BlueprintReadOnly, Category = "Generic Itemization")
+	FVector_NetQuantize Location = FVector::ZeroVector;
+
+	/* The ItemInstance that was dropped. */
+	UPROPERTY(BlueprintReadOnly, Category = "Generic Itemization")
+	TInstancedStruct<FItemInstance> ItemInstance;
+
+};
+
+/**
+ * FastArraySerializer of all of the FItemDropRecords owned by an AItemDropManager.
+ */
+USTRUCT()
+struct GENERICITEMIZATION_API FItemDropRecordsContainer : public FFastArraySerializer
+{
+	GENERATED_BODY()
+
+public:
+
+	friend class AItemDropManager;
+
+	//~ Begin of FFastArraySerializer
+	void PostReplicatedAdd(const TArrayView<int32>& AddedIndices, int32 FinalSize);
+	void PostReplicatedChange(const TArrayView<int32>& ChangedIndices, int32 FinalSize);
+	void PreReplicatedRemove(const TArrayView<int32>& RemovedIndices, int32 FinalSize);
+	//~ End of FFastArraySerializer
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParams)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FItemDropRecord, FItemDropRecordsContainer>(Records, DeltaParams, *this);
+	}
+
+private:
+
+	UPROPERTY()
+	TArray<FItemDropRecord> Records;
+
+	UPROPERTY(NotReplicated, Transient)
+	TObjectPtr<AItemDropManager> Owner;
+
+};
+
+template<>
+struct TStructOpsTypeTraits<FItemDropRecordsContainer> : public TStructOpsTypeTraitsBase2<FItemDropRecordsContainer>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true
+	};
+};
+
+/**
+ * A single replicated Actor that owns every ItemInstance dropped within one cell of the world, replacing an AItemDrop Actor per ItemInstance.
+ *
+ * Each ItemDropManager sits at the center of its cell, so regular distance based relevancy only sends Clients the drops in cells near them.
+ * Clients spawn a local, non-replicated AItemDrop as the visual for each drop that is within VisualDistance of a local player.
+ *
+ * ItemDropManagers are created by the UItemDropManagerSubsystem, see UGenericItemizationSettings to enable them.
+ */
+UCLASS(ClassGroup = "Generic Itemization", Blueprintable, NotPlaceable)
+class GENERICITEMIZATION_API AItemDropManager : public AActor
+{
+	GENERATED_BODY()
+
+public:
+
+	friend struct FItemDropRecordsContainer;
+	friend class UItemDropManagerSubsystem;
+
+	AItemDropManager();
+
+	virtual void PostInitializeComponents() override;
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void Tick(float DeltaSeconds) override;
+
+	/**
+	 * Adds a drop of the ItemInstance at the Location.
+	 *
+	 * @param ItemInstance		The ItemInstance to drop, ownership of it is transferred to this ItemDropManager.
+	 * @param Location			Where the ItemInstance is dropped in the world.
+	 * @return					The Id of the new drop, invalid if the ItemInstance could not be dropped.
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "Generic Itemization")
+	FGuid AddDrop(const FInstancedStruct& ItemInstance, FVector Location);
+
+	/**
+	 * Removes the drop and passes out its ItemInstance, whose lifetime is then no longer managed by this ItemDropManager.
+	 *
+	 * @param DropId			The Id of the drop to remove.
+	 * @param OutItemInstance	The ItemInstance that was dropped.
+	 * @return					True if the drop existed.
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "Generic Itemization")
+	bool RemoveDrop(FGuid DropId, TInstancedStruct<FItemInstance>& OutItemInstance);
+
+	/* Replaces the ItemInstance of the drop, used when only part of a stack was taken from it. */
+	bool SetDropItemInstance(const FGuid& DropId, const TInstancedStruct<FItemInstance>& ItemInstance);
+
+	/* Gets a copy of the drop with the DropId. */
+	UFUNCTION(BlueprintCallable, Category = "Generic Itemization")
+	bool GetDrop(FGuid DropId, FItemDropRecord& OutDrop) const;
+	const FItemDropRecord* FindDrop(const FGuid& DropId) const;
+
+	/* Returns all of the drops owned by this ItemDropManager. */
+	TConstArrayView<FItemDropRecord> GetDrops() const { return Drops.Records; }
+
+	/* Returns the number of drops owned by this ItemDropManager. */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Generic Itemization")
+	int32 GetNumDrops() const { return Drops.Records.Num(); }
+
+	/* Returns the cell of the world this ItemDropManager owns the drops for. */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Generic Itemization")
+	FIntVector GetCell() const { return Cell; }
+
+	/* Decides if the passed in Inventory can attempt to take the drop. By default its Pawn, or the Actor that owns it, must be within TakeDropRange of the drop. */
+	UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = "Generic Itemization")
+	bool CanTakeDrop(FGuid DropId, UItemInventoryComponent* InventoryComponent) const;
+
+protected:
+
+	/* The type of Item Drop Actor that Clients spawn locally to visualize the drops near them. */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Settings")
+	TSubclassOf<AItemDrop> VisualItemDropClass;
+
+	/* Drops further than this from every local player are not visualized. */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Settings")
+	float VisualDistance = 3000.0f;
+
+	/* How often, in seconds, Clients update which drops are visualized. */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Settings")
+	float VisualUpdateInterval = 0.25f;
+
+	/* Inventories further than this from a drop cannot take it, see CanTakeDrop. Zero or less disables the check. */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Settings")
+	float TakeDropRange = 500.0f;
+
+	/* All of the drops owned by this ItemDropManager. */
+	UPROPERTY(Replicated)
+	FItemDropRecordsContainer Drops;
+
+	/* The cell of the world this ItemDropManager owns the drops for. */
+	UPROPERTY(Replicated)
+	FIntVector Cell;
+
+	/* The local AItemDrops that are currently visualizing our drops. */
+	UPROPERTY(Transient)
+	TMap<FGuid, TObjectPtr<AItemDrop>> DropVisuals;
+
+	/* Spawns and destroys DropVisuals so that only the drops near a local player are visualized. */
+	void UpdateDropVisuals();
+
+	/* Spawns the local AItemDrop that visualizes the drop. */
+	AItemDrop* SpawnDropVisual(const FItemDropRecord& Drop);
+
+	/* Destroys the local AItemDrop visualizing the drop, if there is one. */
+	void DestroyDropVisual(const FGuid& DropId);
+
+	/* Called on Clients when a drop has been replicated. */
+	void OnDropAdded(const FItemDropRecord& Drop);
+	void OnDropChanged(const FItemDropRecord& Drop);
+	void OnDropRemoved(const FItemDropRecord& Drop);
+
+};
@@ -0,0 +1,69 @@
+// Copyright Fissure Entertainment, Pty Ltd. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "InstancedStruct.h"
+#include "ItemDropManagerSubsystem.generated.h"
+
+class AItemDropManager;
+
+/**
+ * Owns the AItemDropManagers of a World, one for each cell of a uniform grid that has had anything dropped into it.
+ */
+UCLASS()
+class GENERICITEMIZATION_API UItemDropManagerSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	//~ Begin of UWorldSubsystem
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	//~ End of UWorldSubsystem
+
+	/* Returns true if the project has enabled ItemDropManagers, see UGenericItemizationSettings. */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Generic Itemization")
+	static bool AreItemDropManagersEnabled();
+
+	/* Returns the cell of the grid that contains the Location. */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Generic Itemization")
+	static FIntVector GetCellForLocation(const FVector& Location);
+
+	/* Returns the ItemDropManager for the cell that contains the Location, if there is one. */
+	UFUNCTION(BlueprintCallable, Category = "Generic Itemization")
+	AItemDropManager* FindDropManager(const FVector& Location) const;
+
+	/* Returns the ItemDropManager for the cell that contains the Location, spawning it if it does not exist yet. Server only. */
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "Generic Itemization")
+	AItemDropManager* GetOrCreateDropManager(const FVector& Location);
+
+	/**
+	 * Drops the ItemInstance at the Location into the ItemDropManager for that cell. Server only.
+	 *
+	 * @param ItemInstance		The ItemInstance to drop, ownership of it is transferred to the ItemDropManager.
+	 * @param Location			Where the ItemInstance is dropped in the world.
+	 * @param OutDropManager	The ItemDropManager that now owns the drop.
+	 * @return					The Id of the new drop, invalid if the ItemInstance could not be dropped.
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "Generic Itemization")
+	FGuid DropItem(const FInstancedStruct& ItemInstance, FVector Location, AItemDropManager*& OutDropManager);
+
+	/* Returns every ItemDropManager known in this World. On Clients these are only the relevant ones. */
+	void GetDropManagers(TArray<AItemDropManager*>& OutDropManagers) const;
+
+protected:
+
+	/* Called by ItemDropManagers as they begin and end play, on both the Server and Clients. */
+	void RegisterDropManager(AItemDropManager* DropManager);
+	void UnregisterDropManager(AItemDropManager* DropManager);
+
+	friend class AItemDropManager;
+
+private:
+
+	UPROPERTY(Transient)
+	TMap<FIntVector, TObjectPtr<AItemDropManager>> DropManagers;
+
+};
@@ -0,0 +1,96 @@
+// Copyright Fissure Entertainment, Pty Ltd. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "InstancedStruct.h"
+#include "GenericItemizationInstanceTypes.h"
+#include "ItemDropPoolSubsystem.generated.h"
+
+class AItemDrop;
+
+/**
+ * The dormant ItemDrops of a single class that are waiting to be reused.
+ */
+USTRUCT()
+struct GENERICITEMIZATION_API FItemDropPool
+{
+	GENERATED_BODY()
+
+public:
+
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<AItemDrop>> ItemDrops;
+
+};
+
+/**
+ * Keeps a pool of pre-spawned, dormant AItemDrops for each class of ItemDrop so that dropping and taking Items does not spawn and destroy Actors.
+ *
+ * ItemDrops are reset in place when they are released and reactivated when they are acquired again.
+ * Replicated ItemDrops are only pooled on the Server, local ItemDrops (such as the visuals of an AItemDropManager) are pooled separately.
+ *
+ * See UGenericItemizationSettings to configure the pool.
+ */
+UCLASS()
+class GENERICITEMIZATION_API UItemDropPoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	//~ Begin of UWorldSubsystem
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+	//~ End of UWorldSubsystem
+
+	/* Returns true if the project has enabled pooling of ItemDrops, see UGenericItemizationSettings. */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Generic Itemization")
+	static bool IsItemDropPoolingEnabled();
+
+	/**
+	 * Takes a dormant ItemDrop out of the pool, or spawns a new one if there are none, to represent the ItemInstance.
+	 *
+	 * @param ItemDropClass		The type of ItemDrop to acquire.
+	 * @param Transform			Where the ItemDrop is placed in the world.
+	 * @param Owner				The Actor that owns the ItemDrop.
+	 * @param ItemInstance		The ItemInstance the ItemDrop will represent.
+	 * @param bReplicated		True if the ItemDrop should replicate, false for ItemDrops that only exist locally.
+	 * @return					The ItemDrop, or nullptr if it could not be spawned.
+	 */
+	AItemDrop* AcquireItemDrop(TSubclassOf<AItemDrop> ItemDropClass, const FTransform& Transform, AActor* Owner, const FInstancedStruct& ItemInstance, bool bReplicated = true);
+	AItemDrop* AcquireItemDrop(TSubclassOf<AItemDrop> ItemDropClass, const FTransform& Transform, AActor* Owner, const TInstancedStruct<FItemInstance>& ItemInstance, bool bReplicated = true);
+
+	/* Resets the ItemDrop and puts it into the pool, or destroys it if pooling is disabled or the pool is full. */
+	UFUNCTION(BlueprintCallable, Category = "Generic Itemization")
+	void ReleaseItemDrop(AItemDrop* ItemDrop);
+
+	/* Spawns dormant ItemDrops of the ItemDropClass until its pool holds at least Count of them. They only start replicating once they are acquired. */
+	UFUNCTION(BlueprintCallable, Category = "Generic Itemization")
+	void PrewarmItemDrops(TSubclassOf<AItemDrop> ItemDropClass, int32 Count, bool bReplicated = true);
+
+	/* Returns the number of dormant ItemDrops of the ItemDropClass in the pool. */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Generic Itemization")
+	int32 GetNumPooledItemDrops(TSubclassOf<AItemDrop> ItemDropClass, bool bReplicated = true) const;
+
+private:
+
+	/* Dormant ItemDrops that replicate, only used on the Server. */
+	UPROPERTY(Transient)
+	TMap<TSubclassOf<AItemDrop>, FItemDropPool> ReplicatedPools;
+
+	/* Dormant ItemDrops that only exist locally. */
+	UPROPERTY(Transient)
+	TMap<TSubclassOf<AItemDrop>, FItemDropPool> LocalPools;
+
+	/* Returns true if this World can create or pool ItemDrops that replicate or not. */
+	bool CanPoolItemDrops(bool bReplicated) const;
+
+	/* Shared implementation of AcquireItemDrop. */
+	AItemDrop* AcquireItemDrop(TSubclassOf<AItemDrop> ItemDropClass, const FTransform& Transform, AActor* Owner, const UScriptStruct* ItemInstanceStruct, const uint8* ItemInstanceMemory, bool bReplicated);
+
+	/* Spawns a new ItemDrop that is not pooled. */
+	AItemDrop* SpawnItemDrop(TSubclassOf<AItemDrop> ItemDropClass, const FTransform& Transform, AActor* Owner, const UScriptStruct* ItemInstanceStruct, const uint8* ItemInstanceMemory, bool bReplicated);
+
+};
@@ -0,0 +1,228 @@
+// Copyright Fissure Entertainment, Pty Ltd. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "GameplayTagContainer.h"
+#include "ItemDropSpatialIndexSubsystem.generated.h"
+
+class AItemDrop;
+class AItemDropManager;
+class UItemInventoryComponent;
+struct FItemDropRecord;
+
+/**
+ * Narrows down which ItemDrops are returned by the queries of the UItemDropSpatialIndexSubsystem.
+ */
+USTRUCT(BlueprintType)
+struct GENERICITEMIZATION_API FItemDropQueryFilter
+{
+	GENERATED_BODY()
+
+public:
+
+	/* Only ItemDrops whose ItemDefinition has one of these ItemTypes match. Any ItemType matches if this is empty. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Generic Itemization", meta = (Categories = "Itemization.ItemType"))
+	FGameplayTagContainer ItemTypes;
+
+	/* Only ItemDrops whose ItemInstance has one of these QualityTypes match. Any QualityType matches if this is empty. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Generic Itemization", meta = (Categories = "Itemization.QualityType"))
+	FGameplayTagContainer QualityTypes;
+
+	/* When set, only ItemDrops that this Inventory can attempt to take match. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Generic Itemization")
+	TObjectPtr<UItemInventoryComponent> TakingInventory;
+
+	/* Returns true if the ItemDrop is representing a valid ItemInstance that passes this filter. */
+	bool Matches(const AItemDrop& ItemDrop) const;
+
+	/* Returns true if the drop owned by the DropManager has a valid ItemInstance that passes this filter. */
+	bool Matches(const AItemDropManager& DropManager, const FItemDropRecord& Drop) const;
+
+};
+
+/**
+ * A single radius query for UItemDropSpatialIndexSubsystem::FindItemDropsInRadiusBatch.
+ */
+USTRUCT(BlueprintType)
+struct GENERICITEMIZATION_API FItemDropRadiusQuery
+{
+	GENERATED_BODY()
+
+public:
+
+	/* The center of the query. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Generic Itemization")
+	FVector Origin = FVector::ZeroVector;
+
+	/* ItemDrops further than this from the Origin are not returned. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Generic Itemization")
+	float Radius = 0.0f;
+
+	/* Narrows down which ItemDrops are returned. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Generic Itemization")
+	FItemDropQueryFilter Filter;
+
+};
+
+/**
+ * A drop owned by an AItemDropManager, as found by the queries of the UItemDropSpatialIndexSubsystem.
+ */
+USTRUCT(BlueprintType)
+struct GENERICITEMIZATION_API FItemDropRecordRef
+{
+	GENERATED_BODY()
+
+public:
+
+	/* The ItemDropManager that owns the drop. */
+	UPROPERTY(BlueprintReadOnly, Category = "Generic Itemization")
+	TObjectPtr<AItemDropManager> DropManager;
+
+	/* The Id of the drop within the DropManager. */
+	UPROPERTY(BlueprintReadOnly, Category = "Generic Itemization")
+	FGuid DropId;
+
+};
+
+/**
+ * The ItemDrops found by a single FItemDropRadiusQuery.
+ */
+USTRUCT(BlueprintType)
+struct GENERICITEMIZATION_API FItemDropQueryResult
+{
+	GENERATED_BODY()
+
+public:
+
+	UPROPERTY(BlueprintReadOnly, Category = "Generic Itemization")
+	TArray<TObjectPtr<AItemDrop>> ItemDrops;
+
+};
+
+/**
+ * Indexes every live AItemDrop of a World in a uniform grid, so that finding the ItemDrops near a location does not need overlaps or Actor iteration.
+ *
+ * ItemDrops add themselves as they begin play or leave the UItemDropPoolSubsystem, update themselves as they move and remove themselves
+ * as they end play or are put back into the pool. The grid is kept on the Server and on Clients, each indexing the ItemDrops they know of.
+ *
+ * Drops owned by an AItemDropManager are indexed as records on the Server, which has no ItemDrops for them when it is dedicated, see
+ * FindItemDropRecordsInRadius. Clients index the local ItemDrops that visualize them instead.
+ */
+UCLASS()
+class GENERICITEMIZATION_API UItemDropSpatialIndexSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	//~ Begin of UWorldSubsystem
+	virtual void Deinitialize() override;
+	//~ End of UWorldSubsystem
+
+	/**
+	 * Finds all of the ItemDrops within the Radius of the Origin.
+	 *
+	 * @param Origin			The center of the query.
+	 * @param Radius			ItemDrops further than this from the Origin are not returned.
+	 * @param Filter			Narrows down which ItemDrops are returned.
+	 * @param OutItemDrops		The ItemDrops that were found, in no particular order.
+	 * @return					True if any ItemDrops were found.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Generic Itemization")
+	bool FindItemDropsInRadius(FVector Origin, float Radius, const FItemDropQueryFilter& Filter, TArray<AItemDrop*>& OutItemDrops) const;
+
+	/**
+	 * Runs many radius queries at once, such as one for each player that is auto looting.
+	 *
+	 * @param Queries			The queries to run.
+	 * @param OutResults		The ItemDrops found by each query, in the same order as the Queries.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Generic Itemization")
+	void FindItemDropsInRadiusBatch(const TArray<FItemDropRadiusQuery>& Queries, TArray<FItemDropQueryResult>& OutResults) const;
+
+	/**
+	 * Finds the ItemDrop closest to the Origin.
+	 *
+	 * @param Origin			The center of the query.
+	 * @param MaxRadius			ItemDrops further than this from the Origin are not considered.
+	 * @param Filter			Narrows down which ItemDrops are considered.
+	 * @return					The closest ItemDrop, nullptr if there were none.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Generic Itemization")
+	AItemDrop* FindNearestItemDrop(FVector Origin, float MaxRadius, const FItemDropQueryFilter& Filter) const;
+
+	/**
+	 * Finds all of the drops owned by an AItemDropManager within the Radius of the Origin. Only the Server indexes these.
+	 *
+	 * @param Origin			The center of the query.
+	 * @param Radius			Drops further than this from the Origin are not returned.
+	 * @param Filter			Narrows down which drops are returned.
+	 * @param OutDrops			The drops that were found, in no particular order.
+	 * @return					True if any drops were found.
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "Generic Itemization")
+	bool FindItemDropRecordsInRadius(FVector Origin, float Radius, const FItemDropQueryFilter& Filter, TArray<FItemDropRecordRef>& OutDrops) const;
+
+	/* Returns the number of ItemDrops that are indexed. */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Generic Itemization")
+	int32 GetNumItemDrops() const { return ItemDropCells.Num(); }
+
+protected:
+
+	/* Called by ItemDrops to add, move and remove themselves from the index. */
+	void AddItemDrop(AItemDrop* ItemDrop);
+	void UpdateItemDrop(AItemDrop* ItemDrop);
+	void RemoveItemDrop(AItemDrop* ItemDrop);
+
+	/* Called by ItemDropManagers on the Server to add and remove their drops from the index. */
+	void AddItemDropRecord(AItemDropManager* DropManager, const FItemDropRecord& Drop);
+	void RemoveItemDropRecord(const FGuid& DropId);
+
+	friend class AItemDrop;
+	friend class AItemDropManager;
+
+private:
+
+	struct FIndexedItemDrop
+	{
+		TWeakObjectPtr<AItemDrop> ItemDrop;
+		FVector Location;
+	};
+
+	/* The indexed ItemDrops within each cell of the grid that has any. */
+	TMap<FIntVector, TArray<FIndexedItemDrop>> Cells;
+
+	/* The cell each indexed ItemDrop is within. */
+	TMap<TObjectKey<AItemDrop>, FIntVector> ItemDropCells;
+
+	struct FIndexedItemDropRecord
+	{
+		TWeakObjectPtr<AItemDropManager> DropManager;
+		FGuid DropId;
+		FVector Location;
+	};
+
+	/* The indexed drops of ItemDropManagers within each cell of the grid that has any. */
+	TMap<FIntVector, TArray<FIndexedItemDropRecord>> RecordCells;
+
+	/* The cell each indexed drop of an ItemDropManager is within. */
+	TMap<FGuid, FIntVector> ItemDropRecordCells;
+
+	/* Returns the cell of the grid that contains the Location. */
+	FIntVector GetCellForLocation(const FVector& Location) const;
+
+	/* Returns the size of each cell of the grid. */
+	double GetCellSize() const;
+
+	/* Calls the Visitor for each indexed ItemDrop in the cells overlapping the box around the Origin. */
+	void ForEachItemDropInBox(const FVector& Origin, double Extent, TFunctionRef<void(AItemDrop&, const FVector&)> Visitor) const;
+
+	/* Calls the Visitor for each indexed ItemDrop in the cells that are exactly Ring cells away from the Cell. */
+	void ForEachItemDropInRing(const FIntVector& Cell, int32 Ring, TFunctionRef<void(AItemDrop&, const FVector&)> Visitor) const;
+
+	/* Removes the ItemDrop from the cell it is indexed within. */
+	void RemoveFromCell(const FIntVector& Cell, const AItemDrop* ItemDrop);
+
+};
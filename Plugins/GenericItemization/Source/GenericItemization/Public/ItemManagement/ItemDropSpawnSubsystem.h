@@ -0,0 +1,125 @@
+// Copyright Fissure Entertainment, Pty Ltd. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "InstancedStruct.h"
+#include "ItemDropSpawnSubsystem.generated.h"
+
+class AItemDrop;
+class UItemDropperComponent;
+
+/**
+ * An ItemDrop that is waiting to be spawned by the UItemDropSpawnSubsystem.
+ */
+USTRUCT()
+struct GENERICITEMIZATION_API FItemDropSpawnRequest
+{
+	GENERATED_BODY()
+
+public:
+
+	/* The ItemInstance the ItemDrop will represent. */
+	UPROPERTY()
+	FInstancedStruct ItemInstance;
+
+	/* The type of ItemDrop to spawn. */
+	UPROPERTY()
+	TSubclassOf<AItemDrop> ItemDropClass;
+
+	/* Where the ItemDrop will be spawned, already scattered from where it was dropped. */
+	UPROPERTY()
+	FTransform Transform;
+
+	/* The Actor that will own the ItemDrop. */
+	UPROPERTY()
+	TWeakObjectPtr<AActor> Owner;
+
+	/* The Dropper that is told once the ItemDrop has spawned. */
+	UPROPERTY()
+	TWeakObjectPtr<UItemDropperComponent> Dropper;
+
+	/* The squared distance to the nearest player, lower spawns sooner. */
+	double Priority = 0.0;
+
+};
+
+/**
+ * Queues the ItemDrops produced by UItemDropperComponents and spawns them over multiple frames, within a per frame time budget.
+ * ItemDrops closest to a player are spawned first, and every batch of ItemDrops is scattered around where it was dropped.
+ *
+ * See UGenericItemizationSettings to configure the budget and scattering.
+ */
+UCLASS()
+class GENERICITEMIZATION_API UItemDropSpawnSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	//~ Begin of UTickableWorldSubsystem
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	//~ End of UTickableWorldSubsystem
+
+	/* Returns true if the project has enabled budgeted spawning of ItemDrops, see UGenericItemizationSettings. */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Generic Itemization")
+	static bool IsItemDropSpawnSchedulingEnabled();
+
+	/* Returns true if ItemDrops that are dropped together are scattered around where they were dropped, rather than all being placed there. */
+	static bool ShouldScatterItemDrops();
+
+	/**
+	 * Computes where each of Count ItemDrops dropped at the Origin should be placed, as a spiral around the Origin using the golden angle.
+	 * The first location is the Origin and each following one is further out, so every ItemDrop keeps roughly the same spacing from its neighbours.
+	 *
+	 * @param Origin			Where the ItemDrops were dropped.
+	 * @param Count				The number of ItemDrops.
+	 * @param OutLocations		The location of each ItemDrop.
+	 */
+	static void ComputeScatteredLocations(const FVector& Origin, int32 Count, TArray<FVector>& OutLocations);
+
+	/**
+	 * Queues an ItemDrop to be spawned for each of the ItemInstances, scattered around the Transform. Server only.
+	 *
+	 * @param Dropper			The Dropper that is told as each ItemDrop spawns, may be null.
+	 * @param ItemDropClass		The type of ItemDrop to spawn.
+	 * @param Transform			Where the ItemInstances were dropped.
+	 * @param Owner				The Actor that will own the ItemDrops.
+	 * @param ItemInstances		The ItemInstances to spawn ItemDrops for, ownership of them is transferred to the queue.
+	 */
+	void QueueItemDrops(UItemDropperComponent* Dropper, TSubclassOf<AItemDrop> ItemDropClass, const FTransform& Transform, AActor* Owner, TArray<FInstancedStruct>&& ItemInstances);
+
+	/* Spawns every queued ItemDrop right away, ignoring the budget. */
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "Generic Itemization")
+	void FlushItemDropSpawns();
+
+	/* Returns the number of ItemDrops that are still waiting to be spawned. */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Generic Itemization")
+	int32 GetNumPendingItemDropSpawns() const { return PendingSpawns.Num(); }
+
+private:
+
+	/* ItemDrops waiting to be spawned, kept as a heap on their Priority so that the next one to spawn is first. */
+	UPROPERTY(Transient)
+	TArray<FItemDropSpawnRequest> PendingSpawns;
+
+	/* How often, in seconds, the Priority of every pending spawn is recomputed from the current player locations. */
+	static constexpr double PrioritizeInterval = 0.5;
+
+	/* The World time the pending spawns were last prioritized at. */
+	double LastPrioritizeTime = 0.0;
+
+	/* Gathers the view location of every player, which the Priority of each pending spawn is computed from. */
+	void GetPlayerLocations(TArray<FVector, TInlineAllocator<8>>& OutPlayerLocations) const;
+
+	/* Recomputes the Priority of each pending spawn from the current player locations and rebuilds the heap. */
+	void PrioritizePendingSpawns();
+
+	/* Spawns the pending ItemDrop with the best Priority and removes it from the queue. */
+	void SpawnNextItemDrop();
+
+};
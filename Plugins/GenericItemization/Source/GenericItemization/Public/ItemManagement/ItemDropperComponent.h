@@ -12,6 +12,8 @@ class AItemDrop;
 class UItemInstancer;
 class UItemInstancingContextFunction;
 
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FItemDropperComponentItemDropSpawnedSignature, UItemDropperComponent*, ItemDropperComponent, AItemDrop*, ItemDrop);
+
 /**
  * A Component that sits on an Actor to facilitate the entrypoint to dropping Items for that Actor from a specified DropTable.
  */
@@ -24,11 +26,17 @@ public:
 
 	UItemDropperComponent();
 
+	/* Called when an ItemDrop that was queued by DropItems has been spawned by the UItemDropSpawnSubsystem. */
+	UPROPERTY(BlueprintAssignable, meta = (DisplayName = "On Item Drop Spawned"))
+	FItemDropperComponentItemDropSpawnedSignature OnItemDropSpawnedDelegate;
+
 	/**
 	 * Drops Items from this dropper according to the selected ItemDropTable. 
 	 * 
 	 * @param UserContextData		Arbitrary data that you may want to pack with useful information to pass through during the Item Instancing Process and for access to other external systems.
 	 * @param ItemDrops				All of the ItemDrop Actors that were produced for ItemInstances that were generated from the DropTable.
+	 *								This is always empty when ItemDropManagers are enabled, the ItemInstances are then owned by the ItemDropManager for the Owner's location.
+	 *								This is also empty when ItemDrop spawns are scheduled, the ItemDrops are then passed out through OnItemDropSpawnedDelegate as they spawn.
 	 */
 	UFUNCTION(BlueprintNativeEvent, BlueprintCallable, BlueprintAuthorityOnly, Category = "Generic Itemization")
 	bool DropItems(FInstancedStruct UserContextData, TArray<AItemDrop*>& ItemDrops);
@@ -6,19 +6,109 @@
 #include "Components/ActorComponent.h"
 #include "InstancedStruct.h"
 #include "GenericItemizationInstanceTypes.h"
+#include "ItemManagement/ItemDropSpatialIndexSubsystem.h"
+#include "ItemManagement/ItemInventoryGrid.h"
 #include "ItemInventoryComponent.generated.h"
 
 class UItemInstancer;
+class UItemInventoryTab;
 class AItemDrop;
+class AItemDropManager;
+class UNetConnection;
+class APlayerController;
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FItemInventoryComponentItemTakenSignature, UItemInventoryComponent*, ItemInventoryComponent, const FInstancedStruct&, Item, const FInstancedStruct&, UserContextData);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FItemInventoryComponentItemChangedSignature, UItemInventoryComponent*, ItemInventoryComponent, const FInstancedStruct&, Item, const FInstancedStruct&, UserContextData);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FItemInventoryComponentItemRemovedSignature, UItemInventoryComponent*, ItemInventoryComponent, const FInstancedStruct&, Item, const FInstancedStruct&, UserContextData);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_FiveParams(FItemInventoryComponentItemChangedStackCountSignature, UItemInventoryComponent*, ItemInventoryComponent, const FInstancedStruct&, Item, const FInstancedStruct&, UserContextData, int32, OldStackCount, int32, NewStackCount);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_FourParams(FItemInventoryComponentItemChangedSocketChangeSignature, UItemInventoryComponent*, ItemInventoryComponent, const FInstancedStruct&, Item, const FInstancedStruct&, UserContextData, FGuid, SocketId);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FItemInventoryComponentTabChangedSignature, UItemInventoryComponent*, ItemInventoryComponent, int32, Tab);
+
+/**
+ * The ItemInstances that were added, changed and removed by a single committed Transaction on an ItemInventoryComponent.
+ */
+USTRUCT(BlueprintType)
+struct GENERICITEMIZATION_API FItemInventoryChangeSet
+{
+	GENERATED_BODY()
+
+public:
+
+	/* Ids of the ItemInstances that were added. */
+	UPROPERTY(BlueprintReadOnly, Category = "Generic Itemization")
+	TArray<FGuid> AddedItems;
+
+	/* Ids of the ItemInstances that were changed, not including any that were also added. */
+	UPROPERTY(BlueprintReadOnly, Category = "Generic Itemization")
+	TArray<FGuid> ChangedItems;
+
+	/* Ids of the ItemInstances that were removed. */
+	UPROPERTY(BlueprintReadOnly, Category = "Generic Itemization")
+	TArray<FGuid> RemovedItems;
+
+	bool IsEmpty() const
+	{
+		return AddedItems.IsEmpty() && ChangedItems.IsEmpty() && RemovedItems.IsEmpty();
+	}
+
+};
+
+/**
+ * Narrows down which ItemInstances are returned by queries on an ItemInventoryComponent, such as GetItemsPage.
+ */
+USTRUCT(BlueprintType)
+struct GENERICITEMIZATION_API FItemInstanceQueryFilter
+{
+	GENERATED_BODY()
+
+public:
+
+	/* Only ItemInstances whose ItemDefinition has one of these ItemTypes match. Any ItemType matches if this is empty. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Generic Itemization", meta = (Categories = "Itemization.ItemType"))
+	FGameplayTagContainer ItemTypes;
+
+	/* Only ItemInstances that have one of these QualityTypes match. Any QualityType matches if this is empty. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Generic Itemization", meta = (Categories = "Itemization.QualityType"))
+	FGameplayTagContainer QualityTypes;
+
+	/* Returns true if the ItemInstance passes this filter. */
+	bool Matches(const FItemInstance& ItemInstance) const;
+
+	bool IsEmpty() const
+	{
+		return ItemTypes.IsEmpty() && QualityTypes.IsEmpty();
+	}
+
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FItemInventoryComponentChangeSetSignature, UItemInventoryComponent*, ItemInventoryComponent, const FItemInventoryChangeSet&, ChangeSet);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FItemInventoryComponentPublicSummaryChangedSignature, UItemInventoryComponent*, ItemInventoryComponent);
 
 DECLARE_MULTICAST_DELEGATE_SevenParams(FItemInventoryComponentItemPropertyValueChangedSignature, UItemInventoryComponent* /*ItemInventoryComponent*/, const FFastItemInstance& /*FastItemInstance*/, const FGameplayTag& /*ChangeDescriptor*/, int32 /*ChangeId*/, const FName& /*PropertyName*/, const void* /*OldPropertyValue*/, const void* /*NewPropertyValue*/);
 
+/**
+ * Describes which Connections are sent the contents of an ItemInventoryComponent.
+ */
+UENUM(BlueprintType)
+enum class EItemInventoryReplicationPolicy : uint8
+{
+	/* Every relevant Connection receives all of the ItemInstances. */
+	Public,
+
+	/* Only the Connection that owns the Inventory receives the ItemInstances. */
+	OwnerOnly,
+
+	/**
+	 * The owning Connection and the PlayerControllers in the party net condition group of the Inventory, see AddPartyMember.
+	 * The Inventory Component is replicated with COND_NetGroup, so this is respected with and without Iris. Without a registered
+	 * SubObject list it is decided per Connection by IsPartyMember instead.
+	 */
+	OwnerAndParty,
+
+	/* The owning Connection receives all of the ItemInstances, every other Connection only receives the PublicSummary. */
+	PublicSummaryOnly
+};
+
 /**
  * A Component that sits on an Actor that owns and manages actual instances of Items.
  */
@@ -36,6 +126,8 @@ public:
 	virtual void PreNetReceive() override;
 	virtual void OnRegister() override;
 	virtual void BeginPlay() override;
+	virtual void ReadyForReplication() override;
+	virtual bool ReplicateSubobjects(class UActorChannel* Channel, class FOutBunch* Bunch, FReplicationFlags* RepFlags) override;
 
 	/* Called when the Inventory received a new ItemInstance to manage. */
 	UPROPERTY(BlueprintAssignable, meta = (DisplayName = "On Item Added"))
@@ -61,9 +153,21 @@ public:
 	UPROPERTY(BlueprintAssignable, meta = (DisplayName = "On Item Unsocketed"))
 	FItemInventoryComponentItemChangedSocketChangeSignature OnItemUnsocketedDelegate;
 
-	/* Called when an ItemInstance in the Inventory had a property value changed. */
+	/* Called once for every committed Transaction with all of the ItemInstances it added, changed or removed. */
+	UPROPERTY(BlueprintAssignable, meta = (DisplayName = "On Items Changed"))
+	FItemInventoryComponentChangeSetSignature OnItemsChangedDelegate;
+
+	/* Called when an ItemInstance in the Inventory had a property value changed. This is never deferred by a Transaction, as the values are only valid during the call. */
 	FItemInventoryComponentItemPropertyValueChangedSignature OnItemPropertyValueChangedDelegate;
 
+	/* Called on Clients that only receive the PublicSummary of the Inventory when it changes. */
+	UPROPERTY(BlueprintAssignable, meta = (DisplayName = "On Public Summary Changed"))
+	FItemInventoryComponentPublicSummaryChangedSignature OnPublicSummaryChangedDelegate;
+
+	/* Called when the ItemInstances in a tab changed, on the Server as they are changed and on the owning Client as they are received while subscribed. */
+	UPROPERTY(BlueprintAssignable, meta = (DisplayName = "On Tab Changed"))
+	FItemInventoryComponentTabChangedSignature OnTabChangedDelegate;
+
 	/**
 	 * Checks if the given Item can be taken by the Inventory Component.
 	 * 
@@ -74,8 +178,8 @@ public:
 	bool CanTakeItem(const FInstancedStruct& Item, FInstancedStruct UserContextData);
 
 	/**
-	 * Takes an ItemInstance and thereafter manages it with this Inventory Component.
-	 * This function will call Reset on the Item, it first makes a copy of it to be managed by the
+	 * Takes a copy of an ItemInstance and thereafter manages it with this Inventory Component.
+	 * The caller's Item is left as it was, it is up to the caller to Reset it or otherwise stop using it if ownership is being transferred.
 	 *
 	 * @param Item				The ItemInstance that this Inventory will take.
 	 * @param UserContextData	Additional Data that might provide needed context around the taking of the ItemInstance.
@@ -93,6 +197,40 @@ public:
 	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "Generic Itemization")
 	virtual bool TakeItemDrop(AItemDrop* ItemDrop, FInstancedStruct UserContextData, bool bDestroyItemDrop = true);
 
+	/**
+	 * Takes the ItemInstance of a drop owned by an ItemDropManager and thereafter manages it with this Inventory Component.
+	 *
+	 * @param DropManager		The ItemDropManager that owns the drop.
+	 * @param DropId			The Id of the drop within the DropManager.
+	 * @param UserContextData	Additional Data that might provide needed context around the taking of the ItemInstance.
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "Generic Itemization")
+	virtual bool TakeItemDropRecord(AItemDropManager* DropManager, FGuid DropId, FInstancedStruct UserContextData);
+
+	/**
+	 * Asks the Server to take the ItemInstance of a drop owned by an ItemDropManager, see TakeItemDropRecord.
+	 * The ItemDrops that visualize these drops only exist locally and can't be referenced by the Server, so the owning Client uses this instead.
+	 * Whether the drop can actually be taken is decided by the Server, see AItemDropManager::CanTakeDrop.
+	 *
+	 * @param DropManager		The ItemDropManager that owns the drop.
+	 * @param DropId			The Id of the drop within the DropManager.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Generic Itemization")
+	void RequestTakeItemDropRecord(AItemDropManager* DropManager, FGuid DropId);
+
+	/**
+	 * Takes every ItemDrop within the Radius of the Origin that passes the Filter, as a single Transaction. Intended for auto looting.
+	 * The Filter is always narrowed to ItemDrops this Inventory can attempt to take.
+	 *
+	 * @param Origin			The center of the query, usually the location of the Actor that is looting.
+	 * @param Radius			ItemDrops further than this from the Origin are not taken.
+	 * @param Filter			Narrows down which ItemDrops are taken.
+	 * @param UserContextData	Additional Data that might provide needed context around the taking of the ItemInstances.
+	 * @return					The number of ItemDrops that were taken.
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "Generic Itemization")
+	virtual int32 TakeItemDropsInRadius(FVector Origin, float Radius, FItemDropQueryFilter Filter, FInstancedStruct UserContextData);
+
 	/**
 	 * Drops the ItemInstance with the ItemToDrop Id and passes out the ItemDrop that was created to represent it in the world.
 	 *
@@ -136,8 +274,7 @@ public:
 	bool SplitItemStack(FGuid ItemToSplit, int32 SplitCount, FInstancedStruct& OutSplitItemInstance);
 
 	/**
-	 * Takes an ItemInstance and thereafter manages it with this Inventory Component.
-	 * This function will call Reset on the Item, it first makes a copy of it to be managed by the
+	 * Checks if the ItemToStackFrom can be stacked onto the ItemToStackWith.
 	 *
 	 * @param ItemToStackFromInventory			The Inventory Component that manages the ItemToStackFrom.
 	 * @param ItemToStackFrom					The Id of the Item that will be stacked onto the ItemToStackWith.
@@ -172,6 +309,28 @@ public:
 	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "Generic Itemization")
 	virtual bool StackItemFromItemDrop(AItemDrop* ItemToStackFromItemDrop, FGuid ItemToStackWith, bool& bOutItemToStackFromWasExpunged, bool bDestroyItemDrop = true);
 
+	/**
+	 * Attempts to Stack an Item onto another where the Item comes from a drop owned by an ItemDropManager.
+	 *
+	 * @param DropManager						The ItemDropManager that owns the drop.
+	 * @param DropId							The Id of the drop within the DropManager.
+	 * @param ItemToStackWith					The Id of the Item that we want to add to its stack.
+	 * @param bOutItemToStackFromWasExpunged	Was the drop completely expunged because of the stacking operation.
+	 * @return									True if the stacking was successful.
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "Generic Itemization")
+	virtual bool StackItemFromItemDropRecord(AItemDropManager* DropManager, FGuid DropId, FGuid ItemToStackWith, bool& bOutItemToStackFromWasExpunged);
+
+	/**
+	 * Finds an Item in this Inventory that the Item can be stacked onto, looked up by its stack key rather than checking against every Item.
+	 *
+	 * @param Item								The ItemInstance that we want to stack onto an Item in this Inventory.
+	 * @param OutItemToStackWith				The Id of the Item that the Item can be stacked onto.
+	 * @return									True if an Item with room left in its stack was found.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Generic Itemization")
+	bool FindItemToStackWith(const FInstancedStruct& Item, FGuid& OutItemToStackWith) const;
+
 	/**
 	 * Checks if ItemToSocket can be socketed into any Sockets on ItemToSocketInto. Returns the first Socket that will accept ItemToSocket. 
 	 * 
@@ -185,6 +344,7 @@ public:
 
 	/**
 	 * Checks if the SocketId on the ItemToSocketInto will accept the ItemToSocket.
+	 * CanSocketItem only asks this about each Socket when it is implemented in Blueprint, native overrides should also override CanSocketItem.
 	 *
 	 * @param ItemToSocket			The ItemInstance that we are trying to socket into ItemToSocketInto.
 	 * @param ItemToSocketInto		The ItemInstance that we are trying to socket ItemToSocket into.
@@ -231,6 +391,29 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Generic Itemization")
 	bool GetItemAffixes(const FGuid& Item, TArray<TInstancedStruct<FAffixInstance>>& OutAffixes, bool bIncludeSocketedItems = true);
 
+	/**
+	 * Returns the sum of the Modifiers of the ModType across the Affixes of the Item, including those of any Items socketed into it.
+	 * This is a lookup when bCacheModifierAggregates is set, otherwise it is summed on demand.
+	 *
+	 * @param Item						The Id of the ItemInstance to get the Modifiers of.
+	 * @param ModType					The type of Modifier to sum.
+	 * @param OutAggregate				The summed Modifiers.
+	 * @return							True if the Item has any Modifiers of the ModType.
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Generic Itemization")
+	bool GetItemModifierAggregate(FGuid Item, UPARAM(meta = (Categories = "Itemization.AffixModifier")) FGameplayTag ModType, FAffixModifierAggregate& OutAggregate) const;
+
+	/**
+	 * Returns the sum of the Modifiers of the ModType across every Item in this Inventory, including those of any Items socketed into them.
+	 * This is a lookup when bCacheModifierAggregates is set, otherwise it is summed on demand.
+	 *
+	 * @param ModType					The type of Modifier to sum.
+	 * @param OutAggregate				The summed Modifiers.
+	 * @return							True if any Item has Modifiers of the ModType.
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Generic Itemization")
+	bool GetInventoryModifierAggregate(UPARAM(meta = (Categories = "Itemization.AffixModifier")) FGameplayTag ModType, FAffixModifierAggregate& OutAggregate) const;
+
 	/* Returns a copy of all of the Items this Inventory currently contains. */
 	UFUNCTION(BlueprintCallable, Category = "Generic Itemization")
 	TArray<FInstancedStruct> GetItems();
@@ -239,6 +422,30 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Generic Itemization")
 	TArray<FFastItemInstance> GetItemsWithContext();
 
+	/* Returns a view of all of the Items this Inventory currently contains including their contexts, without copying them. Any change to the Inventory invalidates the view. */
+	TConstArrayView<FFastItemInstance> GetItemsView() const;
+
+	/**
+	 * Calls the Visitor for each Item this Inventory currently contains, without copying them.
+	 * The Inventory must not be changed from within the Visitor.
+	 *
+	 * @param Visitor			Receives a view of each ItemInstance and its UserContextData. Return false to stop visiting.
+	 */
+	void ForEachItem(TFunctionRef<bool(FConstStructView ItemInstance, FConstStructView UserContextData)> Visitor) const;
+
+	/**
+	 * Gets a copy of a single page of the Items this Inventory currently contains that pass the Filter, so that only what is shown has to be copied.
+	 * Pages follow the order Items are stored in, which changes as Items are removed.
+	 *
+	 * @param Offset			The number of matching Items to skip.
+	 * @param Count				The most Items to return.
+	 * @param Filter			Narrows down which Items are returned.
+	 * @param OutItems			Copies of the Items on the page.
+	 * @return					The total number of Items that pass the Filter, to work out the number of pages.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Generic Itemization")
+	int32 GetItemsPage(int32 Offset, int32 Count, const FItemInstanceQueryFilter& Filter, TArray<FInstancedStruct>& OutItems) const;
+
 	/* Gets a copy of the ItemInstance with the given ItemId. */
 	UFUNCTION(BlueprintCallable, Category = "Generic Itemization")
 	FInstancedStruct GetItem(FGuid ItemId, bool& bSuccessful);
@@ -252,6 +459,197 @@ public:
 	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Generic Itemization")
 	int32 GetNumItems() const;
 
+	/* Returns the number of Items with the ItemDefinition. If bCountStacks is set, every stack of each Item is counted instead. */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Generic Itemization")
+	int32 GetNumItemsWithDefinition(FDataTableRowHandle ItemDefinition, bool bCountStacks = false) const;
+
+	/* Returns the number of Items of the ItemType, or any ItemType beneath it. If bCountStacks is set, every stack of each Item is counted instead. */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Generic Itemization")
+	int32 GetNumItemsOfType(UPARAM(meta = (Categories = "Itemization.ItemType")) FGameplayTag ItemType, bool bCountStacks = false) const;
+
+	/* Returns the number of Items of the QualityType, or any QualityType beneath it. If bCountStacks is set, every stack of each Item is counted instead. */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Generic Itemization")
+	int32 GetNumItemsOfQuality(UPARAM(meta = (Categories = "Itemization.QualityType")) FGameplayTag QualityType, bool bCountStacks = false) const;
+
+	/* Finds the Ids of all of the Items with the ItemDefinition. */
+	UFUNCTION(BlueprintCallable, Category = "Generic Itemization")
+	bool FindItemsWithDefinition(FDataTableRowHandle ItemDefinition, TArray<FGuid>& OutItemIds) const;
+
+	/* Finds the Ids of all of the Items of the ItemType, or any ItemType beneath it. */
+	UFUNCTION(BlueprintCallable, Category = "Generic Itemization")
+	bool FindItemsOfType(UPARAM(meta = (Categories = "Itemization.ItemType")) FGameplayTag ItemType, TArray<FGuid>& OutItemIds) const;
+
+	/* Finds the Ids of all of the Items of the QualityType, or any QualityType beneath it. */
+	UFUNCTION(BlueprintCallable, Category = "Generic Itemization")
+	bool FindItemsOfQuality(UPARAM(meta = (Categories = "Itemization.QualityType")) FGameplayTag QualityType, TArray<FGuid>& OutItemIds) const;
+
+	/* Returns true if the Items of this Inventory are laid out in a grid. */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Generic Itemization")
+	bool UsesGridLayout() const { return bUseGridLayout; }
+
+	/**
+	 * Returns where the Item is placed within the grid and how many cells it occupies.
+	 *
+	 * @param Item				The Id of the ItemInstance.
+	 * @param OutLocation		The column and row of the top left cell the Item occupies.
+	 * @param OutSize			The number of columns and rows the Item occupies.
+	 * @return					True if the Item is placed within the grid.
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Generic Itemization")
+	bool GetItemGridPlacement(FGuid Item, FIntPoint& OutLocation, FIntPoint& OutSize) const;
+
+	/* Returns true if the Item could be moved so that its top left cell is at the Location, the cells it already occupies count as free. */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Generic Itemization")
+	bool CanPlaceItemInGridAt(FGuid Item, FIntPoint Location) const;
+
+	/* Finds the first Location within the grid where the Item would fit. */
+	UFUNCTION(BlueprintCallable, Category = "Generic Itemization")
+	bool FindGridLocationForItem(const FInstancedStruct& Item, FIntPoint& OutLocation) const;
+
+	/* Moves the Item so that its top left cell is at the Location, if the cells are free. */
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "Generic Itemization")
+	bool MoveItemInGrid(FGuid Item, FIntPoint Location);
+
+	/* Re-places every Item within the grid, largest first, gathering the free cells together. Also places any Items that were added without room for them. */
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "Generic Itemization")
+	bool AutoArrangeGrid();
+
+	/* Returns the layout of the Items within the grid. */
+	const FItemInventoryGrid& GetGrid() const { return Grid; }
+
+	/**
+	 * Saves every Item in this Inventory, see FItemInventoryArchive for the format. The UserContextData of the Items is not saved.
+	 * Items in tabs are saved alongside the others but which tab they are in is not, LoadItems loads them into this Inventory.
+	 * To keep tabs apart, persist each of them with UItemStashStorage::WriteTab instead.
+	 *
+	 * @param OutData			The saved Items.
+	 * @return					The number of Items that were saved, or -1 if they could not be written.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Generic Itemization")
+	int32 SaveItems(TArray<uint8>& OutData) const;
+
+	/**
+	 * Loads Items that were saved with SaveItems into this Inventory, alongside any Items it already has.
+	 * The Inventory is sized for all of them up front and they are added within a single Transaction. Items with an ItemId this Inventory or one of its tabs already has are skipped.
+	 *
+	 * @param Data				The saved Items.
+	 * @return					The number of Items that were loaded, or -1 if the Data could not be read.
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "Generic Itemization")
+	int32 LoadItems(const TArray<uint8>& Data);
+
+	/**
+	 * Moves already decoded ItemInstances into this Inventory, alongside any Items it already has. See LoadItems.
+	 *
+	 * @param ItemInstancesToLoad	The ItemInstances to add, those that are added are moved from.
+	 * @return						The number of Items that were loaded.
+	 */
+	int32 LoadItemInstances(TArray<FInstancedStruct>&& ItemInstancesToLoad);
+
+	/**
+	 * Saves only the Items that were added, changed or removed since the last call, so that the cost of an autosave follows how many Items changed rather than how many there are.
+	 * The first call, the first call after every SnapshotSaveInterval deltas, and any call with bFullSnapshot set save every Item as a snapshot instead.
+	 * Each delta applies on top of the snapshot and deltas saved before it, use FItemInventoryArchive::Compact to merge them into a snapshot that LoadItems can load.
+	 * The changes are considered saved as soon as this returns, so if OutData then fails to be persisted the next call must set bFullSnapshot,
+	 * otherwise the changes it held are lost from the chain of deltas.
+	 *
+	 * @param OutData			The saved snapshot or delta.
+	 * @param bOutIsSnapshot	True if every Item was saved, any earlier snapshot and deltas are then no longer needed.
+	 * @param bFullSnapshot		True to save every Item regardless of SnapshotSaveInterval.
+	 * @return					The number of Items that were saved or recorded as removed, or -1 without authority or if they could not be written. The changes are then kept for the next call.
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "Generic Itemization")
+	int32 SaveItemChanges(TArray<uint8>& OutData, bool& bOutIsSnapshot, bool bFullSnapshot = false);
+
+	/* Returns the number of Items that were added, changed or removed since the last SaveItemChanges. */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Generic Itemization")
+	int32 GetNumUnsavedItems() const { return UnsavedItemIds.Num() + UnsavedRemovedItemIds.Num(); }
+
+	/* Returns the number of tabs this Inventory has. */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Generic Itemization")
+	int32 GetNumTabs() const { return Tabs.Num(); }
+
+	/* Returns the tab, nullptr if it doesn't exist. */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Generic Itemization")
+	UItemInventoryTab* GetTab(int32 Tab) const;
+
+	/* Adds a new empty tab to this Inventory and returns its index, INDEX_NONE without authority. */
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "Generic Itemization")
+	int32 AddTab();
+
+	/* Returns a copy of the ItemInstances in the tab. On the owning Client these are only the ones received while subscribed to the tab. */
+	UFUNCTION(BlueprintCallable, Category = "Generic Itemization")
+	TArray<FInstancedStruct> GetTabItems(int32 Tab) const;
+
+	/* Moves an Item out of this Inventory and into the tab, along with its UserContextData. The Item is still held by this Inventory as far as SaveItemChanges is concerned. */
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "Generic Itemization")
+	bool MoveItemToTab(const FGuid& ItemId, int32 Tab);
+
+	/* Moves an Item out of the tab and into this Inventory, if this Inventory can take it. */
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "Generic Itemization")
+	bool MoveItemFromTab(int32 Tab, const FGuid& ItemId);
+
+	/**
+	 * Subscribes the owning Client to a tab, or unsubscribes it. Tabs are only replicated to the owning Client while it is subscribed to them, so that
+	 * the bandwidth and memory a large stash costs follows the tabs that are actually viewed. Unsubscribing stops replicating the tab, so the owning Client
+	 * should not rely on keeping what it received.
+	 * Can be called from the Server or the owning Client, the owning Client asks the Server with an RPC.
+	 *
+	 * @param Tab				The tab to subscribe to.
+	 * @param bSubscribed		True to subscribe, false to unsubscribe.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Generic Itemization")
+	void SetTabSubscribed(int32 Tab, bool bSubscribed);
+
+	/* Returns true if the owning Client is subscribed to the tab. On the owning Client this is true as soon as it asks to subscribe. */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Generic Itemization")
+	bool IsSubscribedToTab(int32 Tab) const;
+
+	/* Returns true if the Connection should be sent the ItemInstances in the tab. */
+	bool ShouldReplicateTabTo(int32 Tab, const UNetConnection* Connection) const;
+
+	/* Returns the summary of the Items in this Inventory, only maintained when using the PublicSummaryOnly ReplicationPolicy. */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Generic Itemization")
+	TArray<FItemInventorySummaryEntry> GetPublicSummary() const { return PublicSummary; }
+
+	/* Returns the policy that decides which Connections are sent the ItemInstances in this Inventory. */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Generic Itemization")
+	EItemInventoryReplicationPolicy GetReplicationPolicy() const { return ReplicationPolicy; }
+
+	/**
+	 * Adds the PlayerController to the party net condition group of this Inventory, so that it is sent the ItemInstances when using the OwnerAndParty ReplicationPolicy.
+	 * The owning PlayerController is added when the Inventory becomes ready for replication, a PlayerController that takes ownership later has to be added with this.
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "Generic Itemization")
+	void AddPartyMember(APlayerController* PlayerController);
+
+	/* Removes the PlayerController from the party net condition group of this Inventory, see AddPartyMember. */
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "Generic Itemization")
+	void RemovePartyMember(APlayerController* PlayerController);
+
+	/* Returns the net condition group the party of this Inventory is in, PartyNetConditionGroup if it is set or one unique to this Inventory otherwise. */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Generic Itemization")
+	FName GetPartyNetConditionGroup() const;
+
+	/**
+	 * Opens a Transaction on the Inventory. Until it is committed, dirtying the ItemInstances for replication, ForceNetUpdate and the
+	 * Added, Changed, Removed, StackCount and Socket events are deferred. They are then flushed once, with the events for each ItemInstance coalesced.
+	 * Transactions can be nested, only committing the outermost Transaction flushes. Prefer FItemInventoryTransaction in native code.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Generic Itemization")
+	void BeginTransaction();
+
+	/* Commits a Transaction opened with BeginTransaction. */
+	UFUNCTION(BlueprintCallable, Category = "Generic Itemization")
+	void CommitTransaction();
+
+	/* Returns true if a Transaction is open on this Inventory. */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Generic Itemization")
+	bool IsInTransaction() const { return TransactionDepth > 0; }
+
+	/* Returns true if the Connection is allowed to receive the ItemInstances in this Inventory. */
+	bool ShouldReplicateItemInstancesTo(const UNetConnection* Connection) const;
+
 	/* Returns true if this Component's Owner Actor has authority. */
 	bool HasAuthority() const;
 
@@ -265,10 +663,57 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Instanced, Category = "Settings")
 	UItemInstancer* ItemInstancer;
 
+	/* True if the summed Affix Modifiers of each Item, and of the whole Inventory, are cached and kept up to date as Items are added, changed, socketed and removed. */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Settings")
+	bool bCacheModifierAggregates = false;
+
+	/* True if taking an Item first stacks it onto the Items it can stack with, only adding what remains as a new Item. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Settings")
+	bool bAutoStackOnTake = false;
+
+	/* True if the Items of this Inventory are laid out in a grid, each occupying the cells of the FItemGridFootprint of its ItemDefinition. Items that do not fit cannot be taken. */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Grid")
+	bool bUseGridLayout = false;
+
+	/* The number of columns and rows of the grid. There can be at most 64 columns. */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Grid", meta = (EditCondition = "bUseGridLayout"))
+	FIntPoint GridSize = FIntPoint(10, 4);
+
+	/* How many deltas SaveItemChanges saves before it saves a full snapshot again. 0 only ever saves the first snapshot. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Saving", meta = (UIMin = "0", ClampMin = "0"))
+	int32 SnapshotSaveInterval = 32;
+
+	/* How many tabs this Inventory starts with. More can be added with AddTab. */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Tabs", meta = (UIMin = "0", ClampMin = "0"))
+	int32 InitialNumTabs = 0;
+
+	/* Decides which Connections are sent the ItemInstances in this Inventory. Connections that are not allowed never receive any ItemInstances. */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Replication")
+	EItemInventoryReplicationPolicy ReplicationPolicy = EItemInventoryReplicationPolicy::Public;
+
+	/* The net condition group of the party, when using the OwnerAndParty ReplicationPolicy. Inventories of the same party can share one, if None each Inventory has its own. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Replication", meta = (EditCondition = "ReplicationPolicy == EItemInventoryReplicationPolicy::OwnerAndParty"))
+	FName PartyNetConditionGroup;
+
 	/* Container for all of the ItemInstances that this Inventory is managing. */
 	UPROPERTY(Replicated)
 	FFastItemInstancesContainer ItemInstances;
 
+	/* Where each ItemInstance is placed within the grid, only used if bUseGridLayout is set. */
+	UPROPERTY(Replicated)
+	FItemInventoryGrid Grid;
+
+	/* A lightweight description of each ItemInstance, sent to everyone but the owner when using the PublicSummaryOnly ReplicationPolicy. */
+	UPROPERTY(ReplicatedUsing = OnRep_PublicSummary)
+	TArray<FItemInventorySummaryEntry> PublicSummary;
+
+	/* The tabs of this Inventory, each replicated as a subobject to the owning Client only. */
+	UPROPERTY(ReplicatedUsing = OnRep_Tabs)
+	TArray<TObjectPtr<UItemInventoryTab>> Tabs;
+
+	/* The tabs the owning Client is subscribed to. The owning Client adds a tab as soon as it asks to subscribe, as it may not have received the tab yet. */
+	TSet<int32> SubscribedTabs;
+
 	/* Cached value of whether our owner is a simulated Actor. */
 	UPROPERTY()
 	bool bCachedIsNetSimulated;
@@ -276,6 +721,22 @@ protected:
 	/* Caches the flags that indicate whether this component has network authority. */
 	void CacheIsNetSimulated();
 
+	/* Sets the replication condition of the ItemInstances and Grid from this instance's ReplicationPolicy. */
+	void UpdateItemInstancesCondition();
+
+	/* Returns true if the Connection owns the Actor this Inventory belongs to. */
+	bool IsOwningConnection(const UNetConnection* Connection) const;
+
+	/* Returns true if the PlayerController should be treated as a party member of the owner, when using the OwnerAndParty ReplicationPolicy. Default implementation checks the party net condition group. */
+	UFUNCTION(BlueprintNativeEvent, Category = "Generic Itemization")
+	bool IsPartyMember(const APlayerController* PlayerController) const;
+
+	UFUNCTION()
+	void OnRep_PublicSummary();
+
+	UFUNCTION()
+	void OnRep_Tabs();
+
 	/* Called when the Inventory received a new ItemInstance to manage. */
 	UFUNCTION(BlueprintNativeEvent, meta = (DisplayName = "On Added Item"))
 	void K2_OnAddedItem(const FInstancedStruct& Item, const FInstancedStruct& UserContextData);
@@ -302,6 +763,90 @@ protected:
 
 private:
 
+	/* Everything that happened to a single ItemInstance during the current Transaction. */
+	struct FPendingItemChange
+	{
+		FGuid ItemId;
+		bool bAdded = false;
+		bool bChanged = false;
+		bool bRemoved = false;
+
+		/* A copy of the ItemInstance as it was removed, as it will no longer be in the Inventory when the Transaction is committed. */
+		FFastItemInstance RemovedItemInstance;
+
+		bool bStackCountChanged = false;
+		int32 OldStackCount = 0;
+		int32 NewStackCount = 0;
+
+		/* Each SocketId that had an ItemInstance socketed into it (true) or unsocketed from it (false), in order. */
+		TArray<TPair<FGuid, bool>> SocketChanges;
+	};
+
+	/* How many Transactions are currently open. */
+	int32 TransactionDepth = 0;
+
+	/* The ItemInstances that were affected by the current Transaction, in the order they were first affected. */
+	TArray<FPendingItemChange> PendingItemChanges;
+	TMap<FGuid, int32> PendingItemChangeIndices;
+
+	/* Returns the pending change for the ItemInstance, or nullptr if it isn't a valid ItemInstance. */
+	FPendingItemChange* FindOrAddPendingItemChange(const FFastItemInstance& FastItemInstance);
+
+	/* Emits all of the events that were deferred by the Transaction that was just committed. */
+	void FlushPendingItemChanges();
+
+	/* The summed Affix Modifiers of each Item by their ModType, only maintained if bCacheModifierAggregates is set. */
+	TMap<FGuid, TMap<FGameplayTag, FAffixModifierAggregate>> ItemModifierAggregates;
+
+	/* The summed Affix Modifiers of every Item by their ModType, only maintained if bCacheModifierAggregates is set. */
+	TMap<FGameplayTag, FAffixModifierAggregate> InventoryModifierAggregates;
+
+	/* Asks the Server to subscribe the owning Client to a tab, or unsubscribe it. See SetTabSubscribed. */
+	UFUNCTION(Server, Reliable)
+	void ServerSetTabSubscribed(int32 Tab, bool bSubscribed);
+
+	/* Asks the Server to take a drop owned by an ItemDropManager. See RequestTakeItemDropRecord. */
+	UFUNCTION(Server, Reliable)
+	void ServerTakeItemDropRecord(AItemDropManager* DropManager, FGuid DropId);
+
+	/* Called by the FFastItemInstancesContainer of a tab once it has received its replicated ItemInstances. */
+	void OnTabItemInstancesReceived(int32 Tab);
+
+	/* The Items that were added or changed, and the Items that were removed, since the last SaveItemChanges. Only tracked with authority. */
+	TSet<FGuid> UnsavedItemIds;
+	TSet<FGuid> UnsavedRemovedItemIds;
+
+	/* How many deltas SaveItemChanges has saved since its last snapshot, INDEX_NONE if it hasn't saved one yet. */
+	int32 NumDeltasSinceSnapshot = INDEX_NONE;
+
+	/* Records that the ItemInstance needs to be saved by the next SaveItemChanges, or that it was removed if bRemoved is true. */
+	void MarkItemUnsaved(const FFastItemInstance& FastItemInstance, bool bRemoved);
+
+	/* Returns the ItemInstance from whichever tab holds it, nullptr if none do. */
+	const FFastItemInstance* FindTabItemInstance(const FGuid& ItemId) const;
+
+	/* Places the ItemInstance within the grid, or removes it from the grid if bRemoved is true. */
+	void UpdateGridPlacement(const FFastItemInstance& FastItemInstance, bool bRemoved);
+
+	/* Replaces what the ItemInstance contributes to the cached Modifier aggregates. */
+	void UpdateModifierAggregates(const FFastItemInstance& FastItemInstance, bool bRemoved);
+
+	/* Counts the Items, or every stack of them if bCountStacks is set. */
+	int32 CountItems(const TSet<FGuid>* ItemIds, bool bCountStacks) const;
+
+	/* Adds the ItemInstance to the container, first stacking it onto the Items it can stack with if bAutoStackOnTake is set. */
+	void AddOrStackItemInstance(FInstancedStruct&& ItemInstance, FInstancedStruct&& UserContextData);
+	void AddOrStackItemInstance(TInstancedStruct<FItemInstance>&& ItemInstance, FInstancedStruct&& UserContextData);
+
+	/* Stacks as much of the ItemInstance as possible onto the Items it can stack with. Returns true if all of its stacks were taken. */
+	bool StackItemInstanceOntoOpenStacks(FInstancedStruct& ItemInstance);
+
+	/* Stacks ItemToStackFromInstance onto ItemToStackWith. On success it is left with the remainder of its stack, or Reset if it was expunged. */
+	bool StackItemInstanceOnto(TInstancedStruct<FItemInstance>& ItemToStackFromInstance, const FGuid& ItemToStackWith, bool& bOutItemToStackFromWasExpunged);
+
+	/* The default checks of CanSocketItemIntoSocket, against the ItemToSocketInto and its SocketInstance once they have been found. */
+	bool CanSocketItemIntoResolvedSocket(const FInstancedStruct& ItemToSocket, const FInstancedStruct& ItemToSocketInto, const FItemSocketInstance& SocketInstance) const;
+
 	/**
 	 * Called when an individual property on an Item has been changed.
 	 *
@@ -323,6 +868,9 @@ private:
 	/* Called natively by the FFastItemInstancesContainer to notify the Inventory of an Item being Removed. */
 	void OnRemovedItemInstance(const FFastItemInstance& FastItemInstance);
 
+	/* Updates the PublicSummary entry for the ItemInstance, removing it if bRemoved is true. */
+	void UpdatePublicSummary(const FFastItemInstance& FastItemInstance, bool bRemoved);
+
 	/**
 	 * Called natively by the FFastItemInstancesContainer to notify the Inventory of an individual property on an Item being changed. 
 	 * 
@@ -336,3 +884,24 @@ private:
 	void OnItemInstancePropertyValueChanged_Internal(const FFastItemInstance& FastItemInstance, const FGameplayTag& ChangeDescriptor, int32 ChangeId, const FName& PropertyName, const void* OldPropertyValue, const void* NewPropertyValue);
 
 };
+
+/**
+ * Opens a Transaction on an ItemInventoryComponent for the lifetime of this object, see UItemInventoryComponent::BeginTransaction.
+ * 
+ * {
+ *     FItemInventoryTransaction Transaction(Inventory);
+ *     ... many changes ...
+ * } // Replication dirtying and events are flushed here.
+ */
+struct GENERICITEMIZATION_API FItemInventoryTransaction
+{
+	explicit FItemInventoryTransaction(UItemInventoryComponent* InInventory);
+	~FItemInventoryTransaction();
+
+	UE_NONCOPYABLE(FItemInventoryTransaction);
+
+private:
+
+	TWeakObjectPtr<UItemInventoryComponent> Inventory;
+
+};
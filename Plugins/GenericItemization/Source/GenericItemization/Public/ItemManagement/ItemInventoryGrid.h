@@ -0,0 +1,166 @@
+// Copyright Fissure Entertainment, Pty Ltd. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Net/Serialization/FastArraySerializer.h"
+#include "ItemInventoryGrid.generated.h"
+
+class UItemInventoryComponent;
+struct FItemInstance;
+
+/**
+ * The number of cells an Item occupies within a grid Inventory.
+ * Add this as the UserData of one of the CustomUserData entries on an ItemDefinition, Items without one occupy a single cell.
+ */
+USTRUCT(BlueprintType)
+struct GENERICITEMIZATION_API FItemGridFootprint
+{
+	GENERATED_BODY()
+
+public:
+
+	/* How many columns the Item occupies. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, meta = (UIMin = "1", ClampMin = "1", UIMax = "64", ClampMax = "64"))
+	int32 Width = 1;
+
+	/* How many rows the Item occupies. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, meta = (UIMin = "1", ClampMin = "1", UIMax = "255", ClampMax = "255"))
+	int32 Height = 1;
+
+};
+
+/**
+ * Where an Item is placed within a grid Inventory and how many cells it occupies, from the top left cell.
+ */
+USTRUCT(BlueprintType)
+struct GENERICITEMIZATION_API FItemGridPlacement : public FFastArraySerializerItem
+{
+	GENERATED_BODY()
+
+public:
+
+	/* The Id of the ItemInstance that is placed. */
+	UPROPERTY(BlueprintReadOnly)
+	FGuid ItemId;
+
+	/* The column of the top left cell. */
+	UPROPERTY(BlueprintReadOnly)
+	uint8 X = 0;
+
+	/* The row of the top left cell. */
+	UPROPERTY(BlueprintReadOnly)
+	uint8 Y = 0;
+
+	/* How many columns are occupied. */
+	UPROPERTY(BlueprintReadOnly)
+	uint8 Width = 1;
+
+	/* How many rows are occupied. */
+	UPROPERTY(BlueprintReadOnly)
+	uint8 Height = 1;
+
+	FIntPoint GetLocation() const { return FIntPoint(X, Y); }
+	FIntPoint GetSize() const { return FIntPoint(Width, Height); }
+
+};
+
+/**
+ * The layout of a grid Inventory. Each row of the grid is a bitboard of up to 64 cells, so that checking and searching for space
+ * is done a whole row at a time rather than a cell at a time.
+ *
+ * Only the Placements are replicated, Clients rebuild the bitboards from them.
+ */
+USTRUCT()
+struct GENERICITEMIZATION_API FItemInventoryGrid : public FFastArraySerializer
+{
+	GENERATED_BODY()
+
+public:
+
+	friend class UItemInventoryComponent;
+
+	/* The maximum number of columns, one for each bit of a row. */
+	static constexpr int32 MaxWidth = 64;
+
+	/* The maximum number of rows. */
+	static constexpr int32 MaxHeight = 255;
+
+	//~ Begin of FFastArraySerializer
+	void PostReplicatedReceive(const FFastArraySerializer::FPostReplicatedReceiveParameters& Parameters);
+	//~ End of FFastArraySerializer
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParams);
+
+	/* Sets the Owner and the number of columns and rows of the grid. */
+	void Register(UItemInventoryComponent* InOwner, const FIntPoint& InSize);
+
+	/* Returns the number of columns and rows. */
+	FIntPoint GetSize() const { return FIntPoint(Width, Height); }
+
+	/* Returns the Placement of the Item, nullptr if it isn't placed. */
+	const FItemGridPlacement* FindPlacement(const FGuid& ItemId) const;
+
+	/* Returns all of the Placements. */
+	const TArray<FItemGridPlacement>& GetPlacements() const { return Placements; }
+
+	/* Returns true if the cells covered by the Location and Size are all within the grid and free, the cells of IgnoredItem count as free. */
+	bool CanPlace(const FIntPoint& Location, const FIntPoint& Size, const FGuid& IgnoredItem = FGuid()) const;
+
+	/* Finds the first Location, by row and then by column, where the Size fits. */
+	bool FindFirstFit(const FIntPoint& Size, FIntPoint& OutLocation) const;
+
+	/* Places the Item at the Location, if it isn't already placed and the cells are free. */
+	bool PlaceItem(const FGuid& ItemId, const FIntPoint& Location, const FIntPoint& Size);
+
+	/* Moves an already placed Item to the Location, if the cells are free. */
+	bool MoveItem(const FGuid& ItemId, const FIntPoint& Location);
+
+	/* Removes the Placement of the Item. */
+	bool RemoveItem(const FGuid& ItemId);
+
+	/* Re-places every Item, largest first, so that the free cells are gathered together. Nothing is moved if any Item would no longer fit. */
+	bool AutoArrange();
+
+	/* Returns the number of cells the ItemInstance occupies, from the FItemGridFootprint in its ItemDefinition's CustomUserData. */
+	static FIntPoint GetItemFootprint(const FItemInstance& ItemInstance);
+
+private:
+
+	UPROPERTY()
+	TArray<FItemGridPlacement> Placements;
+
+	UPROPERTY(NotReplicated, Transient)
+	TObjectPtr<UItemInventoryComponent> Owner;
+
+	int32 Width = 0;
+	int32 Height = 0;
+
+	/* The occupied cells of each row, bit X is set if column X is occupied. */
+	TArray<uint64> Rows;
+
+	/* The index within Placements of each placed Item. */
+	TMap<FGuid, int32> ItemIdToIndex;
+
+	/* Returns the bits of a row covered by Count columns starting from column X. */
+	static uint64 GetColumnMask(int32 X, int32 Count);
+
+	/* Returns the bits of a row that are within the grid. */
+	uint64 GetRowMask() const { return GetColumnMask(0, Width); }
+
+	/* Sets or clears the cells covered by the Placement. */
+	void SetCells(const FItemGridPlacement& Placement, bool bOccupied);
+
+	/* Rebuilds Rows and ItemIdToIndex from Placements. */
+	void Rebuild();
+
+};
+
+template<>
+struct TStructOpsTypeTraits<FItemInventoryGrid> : public TStructOpsTypeTraitsBase2<FItemInventoryGrid>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true
+	};
+};
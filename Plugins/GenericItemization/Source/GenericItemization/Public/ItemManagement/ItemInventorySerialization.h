@@ -0,0 +1,101 @@
+// Copyright Fissure Entertainment, Pty Ltd. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "InstancedStruct.h"
+#include "StructView.h"
+
+/**
+ * The versions of the FItemInventoryArchive format. Archives written by an older version can always be read, archives written by a newer one cannot.
+ */
+enum class EItemInventoryArchiveVersion : uint32
+{
+	Initial = 1,
+	/* Adds the flags of the archive and the ItemIds that were removed, for delta archives. */
+	Deltas,
+	/* Adds the struct type of derived Affix and Socket instances to their records. */
+	ElementStructTypes,
+
+	// -----<new versions can be added above this line>-----
+	VersionPlusOne,
+	LatestVersion = VersionPlusOne - 1
+};
+
+/**
+ * A compact binary format for persisting the ItemInstances of an Inventory, such as a large stash, without going through generic struct serialization.
+ *
+ * The archive is laid out as:
+ *		Header				Magic, Version and the number of entries in each of the following sections.
+ *		String table		Every unique DataTable row, ItemInstance struct and QualityType that is referenced, each written once.
+ *		Item records		One fixed width record per ItemInstance, referring to the string table by index. The Items that were saved are first,
+ *							followed by every ItemInstance that is socketed into them.
+ *		Affix records		The Affixes of each Item record in turn, each Item record says how many belong to it.
+ *		Socket records		The Sockets of each Item record in turn, referring to the Item record of anything socketed into them.
+ *		Removed Items		The ItemIds that were removed, only written by delta archives.
+ *
+ * An archive is either a snapshot, holding every ItemInstance, or a delta holding only those that were added, changed or removed since the
+ * archive before it. Deltas are keyed by ItemId and apply in order on top of the snapshot they follow, see Compact.
+ *
+ * When reading, each unique DataTable row is resolved once no matter how many ItemInstances refer to it.
+ * Derived ItemInstance, AffixInstance and SocketInstance types are read back as the same type, but only the members of their base types are saved,
+ * members added by a derived type keep their defaults when read.
+ * The InstancingContext is not saved either, it only describes how the ItemInstance was generated and refers to DropTables that are not persistent.
+ * Strings in the string table are limited to 1024 bytes, an archive that would need a longer one is not written.
+ */
+struct GENERICITEMIZATION_API FItemInventoryArchive
+{
+	/* Identifies the data as an FItemInventoryArchive. */
+	static constexpr uint32 Magic = 0x41494947;
+
+	/**
+	 * Writes the ItemInstances to an archive.
+	 *
+	 * @param ItemInstances		The ItemInstances to write, any that are not an FItemInstance are skipped.
+	 * @param OutData			The archive, any previous contents are replaced.
+	 * @return					False if a string is too long to be written, in which case OutData is empty.
+	 */
+	static bool Write(TConstArrayView<FConstStructView> ItemInstances, TArray<uint8>& OutData);
+
+	/**
+	 * Reads the ItemInstances that were written to an archive.
+	 *
+	 * @param Data				The archive.
+	 * @param OutItemInstances	The ItemInstances that were read, in the order they were written.
+	 * @return					False if the archive is malformed or was written by a newer version, in which case nothing is read.
+	 */
+	static bool Read(TConstArrayView<uint8> Data, TArray<FInstancedStruct>& OutItemInstances);
+
+	/**
+	 * Writes a delta archive, recording the ItemInstances that were added or changed and the ItemIds that were removed since the archive before it.
+	 *
+	 * @param ChangedItemInstances	The ItemInstances that were added or changed, any that are not an FItemInstance are skipped.
+	 * @param RemovedItemIds		The ItemIds that were removed.
+	 * @param OutData				The archive, any previous contents are replaced.
+	 * @return						False if a string is too long to be written, in which case OutData is empty.
+	 */
+	static bool WriteDelta(TConstArrayView<FConstStructView> ChangedItemInstances, TConstArrayView<FGuid> RemovedItemIds, TArray<uint8>& OutData);
+
+	/**
+	 * Reads a snapshot or delta archive.
+	 *
+	 * @param Data					The archive.
+	 * @param OutItemInstances		The ItemInstances that were read, in the order they were written.
+	 * @param OutRemovedItemIds		The ItemIds that were removed, always empty for a snapshot.
+	 * @param bOutIsDelta			True if the archive is a delta.
+	 * @return						False if the archive is malformed or was written by a newer version, in which case nothing is read.
+	 */
+	static bool Read(TConstArrayView<uint8> Data, TArray<FInstancedStruct>& OutItemInstances, TArray<FGuid>& OutRemovedItemIds, bool& bOutIsDelta);
+
+	/**
+	 * Merges a snapshot and the archives that were written after it into a single snapshot. Each delta replaces the ItemInstances with the same ItemId,
+	 * adds those that are new and removes those it recorded as removed, a snapshot amongst the Deltas replaces everything before it.
+	 *
+	 * @param Snapshot				The snapshot the Deltas apply to.
+	 * @param Deltas				The archives written after the Snapshot, in the order they were written.
+	 * @param OutSnapshot			The merged snapshot, any previous contents are replaced.
+	 * @return						False if any of the archives could not be read or the merged snapshot could not be written, or the Snapshot is a delta.
+	 */
+	static bool Compact(TConstArrayView<uint8> Snapshot, TConstArrayView<TConstArrayView<uint8>> Deltas, TArray<uint8>& OutSnapshot);
+
+};
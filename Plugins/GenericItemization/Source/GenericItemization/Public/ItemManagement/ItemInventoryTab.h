@@ -0,0 +1,44 @@
+// Copyright Fissure Entertainment, Pty Ltd. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+#include "GenericItemizationInstanceTypes.h"
+#include "ItemInventoryTab.generated.h"
+
+class UItemInventoryComponent;
+
+/**
+ * A tab of an ItemInventoryComponent, such as one page of a stash. Each tab holds its own container of ItemInstances and is replicated as a
+ * subobject of its Inventory, only to the owning Client and only while it is subscribed to the tab. See UItemInventoryComponent::SetTabSubscribed.
+ *
+ * The ItemInstances of a tab are only stored, they are not part of the Inventory until moved into it with UItemInventoryComponent::MoveItemFromTab.
+ */
+UCLASS(BlueprintType)
+class GENERICITEMIZATION_API UItemInventoryTab : public UObject
+{
+	GENERATED_BODY()
+
+public:
+
+	friend class UItemInventoryComponent;
+
+	//~ Begin of UObject
+	virtual bool IsSupportedForNetworking() const override { return true; }
+	//~ End of UObject
+
+	/* Returns the Inventory this tab belongs to. */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Generic Itemization")
+	UItemInventoryComponent* GetInventory() const;
+
+	/* Returns the ItemInstances in this tab. On Clients these are only the ones received while subscribed to the tab. */
+	const FFastItemInstancesContainer& GetItemInstances() const { return ItemInstances; }
+
+protected:
+
+	/* Container for all of the ItemInstances in this tab. */
+	UPROPERTY(Replicated)
+	FFastItemInstancesContainer ItemInstances;
+
+};
@@ -48,6 +48,7 @@ public:
 
 	friend class UItemInstancingFunction;
 	friend struct FSetSocketInstanceSocketDefinition;
+	friend class UGenericItemizationDefinitionRegistry;
 
 	UItemSocketSettings();
 
@@ -8,6 +8,8 @@
 #include "GameplayTagContainer.h"
 #include "ItemStackSettings.generated.h"
 
+struct FItemInstance;
+
 /**
  * Describes the requirements that Items must meet in order to successfully stack.
  */
@@ -74,6 +76,24 @@ public:
 	UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = "Item Stack Settings")
 	bool CanStackWith(const FInstancedStruct& ItemToStackFrom, const FInstancedStruct& ItemToStackWith, int32& OutRemainder) const;
 
+	/**
+	 * Computes a key that is the same for every ItemInstance that this ItemInstance could stack with, honoring the StackingRequirements.
+	 * ItemInstances with different keys can never stack together, ItemInstances with the same key still need to pass CanStackWith.
+	 * Override this alongside CanStackWith if the requirements are loosened, otherwise Items that could stack will not be found as candidates.
+	 * Not used if CanStackWith is implemented in Blueprint, as the key cannot follow it, see SupportsStackKeys.
+	 *
+	 * @param ItemInstance			The ItemInstance to compute the key for.
+	 * @param OutStackKey			The key of the ItemInstance.
+	 * @return						False if the ItemInstance cannot stack with anything, in which case it has no key.
+	 */
+	virtual bool ComputeStackKey(const FItemInstance& ItemInstance, uint32& OutStackKey) const;
+
+	/* True if ComputeStackKey can be used to find the Items this Item could stack with. False if CanStackWith is implemented in Blueprint, every Item is then a candidate. */
+	bool SupportsStackKeys() const;
+
+	/* Computes the stack key of the ItemInstance using the StackSettings of its ItemDefinition. */
+	static bool GetStackKeyForItemInstance(const FItemInstance& ItemInstance, uint32& OutStackKey);
+
 protected:
 
 	/* Can this Item stack at all. */
@@ -0,0 +1,186 @@
+// Copyright Fissure Entertainment, Pty Ltd. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+#include "InstancedStruct.h"
+#include "StructView.h"
+#include "Async/MappedFileHandle.h"
+#include "ItemStashStorage.generated.h"
+
+class IFileHandle;
+class UItemInventoryComponent;
+
+/**
+ * A page of ItemInstances within a tab of a UItemStashStorage, and where it lives in the file.
+ */
+struct FItemStashPage
+{
+	/* The first page of the file this page is written to. */
+	uint32 FirstFilePage = 0;
+
+	/* The number of consecutive pages of the file this page occupies. */
+	uint32 NumFilePages = 0;
+
+	/* The size of the FItemInventoryArchive this page holds. */
+	uint32 DataSize = 0;
+
+	/* The number of ItemInstances this page holds. */
+	uint32 NumItems = 0;
+
+	/* The FItemInventoryArchive of a page that has been written but not yet flushed to the file. */
+	TArray<uint8> PendingData;
+
+	bool IsPending() const { return !PendingData.IsEmpty(); }
+};
+
+/**
+ * Offline storage for a large stash of ItemInstances, such as a player's shared stash, that only decodes the ItemInstances that are actually used.
+ *
+ * The stash is divided into tabs, each tab is divided into pages of at most ItemStashItemsPerPage ItemInstances in the FItemInventoryArchive format.
+ * The file is memory mapped and only its page table is read when it is opened, the pages of a tab are decoded when the tab is loaded.
+ *
+ * The file is copy-on-write. Writing a tab only replaces the pages whose contents changed, and Flush appends those pages to the file followed by
+ * a new page table and a commit record. Opening the file reads the last valid commit record, so a Flush that fails part way through leaves the
+ * previous contents in place. Pages that are no longer used are reclaimed by Compact, which Flush calls once they take up half of the file.
+ *
+ * See UGenericItemizationSettings to configure the page size of new files.
+ */
+UCLASS(BlueprintType)
+class GENERICITEMIZATION_API UItemStashStorage : public UObject
+{
+	GENERATED_BODY()
+
+public:
+
+	//~ Begin of UObject
+	virtual void BeginDestroy() override;
+	//~ End of UObject
+
+	/**
+	 * Opens the stash stored in the file, reading only its page table. If the file does not exist the stash starts empty and is created on the first Flush.
+	 * Any stash that was already open is closed first, discarding anything that was not flushed. A Compact that was interrupted is recovered from first.
+	 *
+	 * @param InFilename		The file the stash is stored in.
+	 * @return					False if the file exists but does not hold a valid stash.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Generic Itemization")
+	bool Open(const FString& InFilename);
+
+	/* Closes the stash, discarding anything that was not flushed. */
+	UFUNCTION(BlueprintCallable, Category = "Generic Itemization")
+	void Close();
+
+	/* Returns true if a stash is open. */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Generic Itemization")
+	bool IsOpen() const { return !Filename.IsEmpty(); }
+
+	/* Returns true if any tab was written since the last Flush. */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Generic Itemization")
+	bool HasPendingChanges() const { return bHasPendingChanges; }
+
+	/* Returns the number of tabs in the stash. */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Generic Itemization")
+	int32 GetNumTabs() const { return Tabs.Num(); }
+
+	/* Returns the number of ItemInstances in the tab, without decoding them. */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Generic Itemization")
+	int32 GetNumItemsInTab(int32 Tab) const;
+
+	/**
+	 * Decodes the ItemInstances of the tab.
+	 *
+	 * @param Tab				The tab to decode.
+	 * @param OutItems			The ItemInstances of the tab, appended in the order they were written. Left as it was if the tab could not be decoded.
+	 * @return					False if the tab does not exist or any of its pages could not be decoded.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Generic Itemization")
+	bool LoadTab(int32 Tab, TArray<FInstancedStruct>& OutItems) const;
+
+	/**
+	 * Decodes the ItemInstances of the tab straight into an Inventory, see UItemInventoryComponent::LoadItemInstances.
+	 *
+	 * @return					The number of ItemInstances loaded into the Inventory, or -1 if the tab could not be decoded.
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "Generic Itemization")
+	int32 LoadTabIntoInventory(int32 Tab, UItemInventoryComponent* Inventory) const;
+
+	/**
+	 * Replaces the ItemInstances of the tab, adding tabs up to it if it does not exist yet. Nothing is written to the file until Flush is called.
+	 * Pages whose contents are unchanged keep their place in the file.
+	 *
+	 * @param Tab				The tab to write.
+	 * @param Items				The ItemInstances the tab will hold.
+	 * @return					False if no stash is open, the Tab is out of range or a page could not be written, the tab is then left as it was.
+	 */
+	bool WriteTab(int32 Tab, TConstArrayView<FConstStructView> Items);
+
+	/* Replaces the ItemInstances of the tab with every Item in the Inventory. See WriteTab. */
+	UFUNCTION(BlueprintCallable, Category = "Generic Itemization")
+	bool WriteTabFromInventory(int32 Tab, const UItemInventoryComponent* Inventory);
+
+	/* Appends every pending page to the file and commits the new page table. Returns false if the file could not be written, the pending pages are then kept. */
+	UFUNCTION(BlueprintCallable, Category = "Generic Itemization")
+	bool Flush();
+
+	/* Rewrites the file with only the pages that are in use, including any pending ones. The previous file is kept alongside it until it has been replaced. */
+	UFUNCTION(BlueprintCallable, Category = "Generic Itemization")
+	bool Compact();
+
+	/* The most tabs a stash can have. */
+	static constexpr int32 MaxTabs = 1024;
+
+private:
+
+	/* The file the stash is stored in, empty if no stash is open. */
+	FString Filename;
+
+	/* The size of each page of the file. */
+	uint32 FilePageSize = 0;
+
+	/* The number of pages of the file, up to and including the last commit record. */
+	uint32 NumFilePages = 0;
+
+	/* The pages of each tab, in order. */
+	TArray<TArray<FItemStashPage>> Tabs;
+
+	/* True if the file has anything after its last valid commit record, it must then be compacted rather than appended to. */
+	bool bNeedsCompaction = false;
+
+	bool bHasPendingChanges = false;
+
+	TUniquePtr<IMappedFileHandle> MappedFile;
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+
+	/* Maps the file for reading. */
+	bool MapFile();
+
+	/* Reads the page table of the mapped file from its last valid commit record. */
+	bool ReadPageTable();
+
+	/* Releases the mapping of the file. */
+	void UnmapFile();
+
+	/* Returns the FItemInventoryArchive of the page, either pending or from the mapped file. Empty if the page lies outside of the file. */
+	TConstArrayView<uint8> GetPageData(const FItemStashPage& Page) const;
+
+	/* Returns the number of pages of the file that the current pages, page table and commit record would occupy if it were compacted. */
+	uint32 GetNumLiveFilePages() const;
+
+	/**
+	 * Writes pages, then the page table and a commit record, to the File which must end at FirstFilePage.
+	 *
+	 * @param File					The file to write to.
+	 * @param FirstFilePage			The page of the file that writing begins at.
+	 * @param bWriteAllPages		True to write every page, otherwise only the pending ones are.
+	 * @param OutPageLocations		The first page of the file each page of each tab was written to, in order. Pages that weren't written keep their location.
+	 * @param OutNumFilePages		The number of pages of the file once written.
+	 * @return						False if the File could not be written.
+	 */
+	bool WriteCommit(IFileHandle& File, uint32 FirstFilePage, bool bWriteAllPages, TArray<uint32>& OutPageLocations, uint32& OutNumFilePages) const;
+
+	/* Moves the pages that were written by WriteCommit to their new locations, they are no longer pending. */
+	void ApplyCommit(const TArray<uint32>& PageLocations, uint32 InNumFilePages);
+
+};